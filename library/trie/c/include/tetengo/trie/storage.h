@@ -82,7 +82,7 @@ tetengo_trie_storage_t* tetengo_trie_storage_createSharedStorage(const path_char
 
     \return A pointer to an mmap storage.
             Or NULL when content cannot be loaded from the path, content_offset is greater than the file size, or the
-            value size is not fixed.
+            values are neither fixed size nor indexed.
 */
 tetengo_trie_storage_t* tetengo_trie_storage_createMmapStorage(const path_character_type* path, size_t content_offset);
 
@@ -43,6 +43,18 @@ typedef struct tetengo_trie_trieElement_tag
     const void* p_value;
 } tetengo_trie_trieElement_t;
 
+/*!
+    \brief A prefix match type.
+*/
+typedef struct tetengo_trie_trie_prefixMatch_tag
+{
+    /*! The prefix length. */
+    size_t length;
+
+    /*! The pointer to the value. */
+    const void* p_value;
+} tetengo_trie_trie_prefixMatch_t;
+
 /*!
     \brief An observer type called when a key is adding.
 
@@ -158,6 +170,60 @@ bool tetengo_trie_trie_contains(const tetengo_trie_trie_t* p_trie, const char* k
 */
 const void* tetengo_trie_trie_find(const tetengo_trie_trie_t* p_trie, const char* key);
 
+/*!
+    \brief Finds the serialized value object corresponding the given key.
+
+    The value object is neither deserialized nor copied. It is available only when the storage exposes the serialized
+    value objects, as an mmap storage does.
+
+    \param p_trie A pointer to a trie.
+    \param key    A key.
+    \param p_size The storage for the size of the serialized value object. Can be NULL.
+
+    \return A pointer to the serialized value object. Or NULL on error, when the trie does not have the given key, or
+            when the storage does not expose it.
+*/
+const char* tetengo_trie_trie_findSerialized(const tetengo_trie_trie_t* p_trie, const char* key, size_t* p_size);
+
+/*!
+    \brief Finds the value objects corresponding to the given keys.
+
+    The lookups of the keys are interleaved to hide the memory latency.
+
+    \param p_trie    A pointer to a trie.
+    \param p_keys    A pointer to the first key.
+    \param key_count A key count.
+    \param p_values  The storage for output pointers to the value objects. Its size must be key_count.
+                     NULL is stored for a key which the trie does not have.
+
+    \retval true  On no error.
+    \retval false Otherwise.
+*/
+bool tetengo_trie_trie_findBatch(
+    const tetengo_trie_trie_t* p_trie,
+    const char* const*         p_keys,
+    size_t                     key_count,
+    const void**               p_values);
+
+/*!
+    \brief Finds the value objects corresponding to the prefixes of the given key.
+
+    The matches are stored in ascending order of the prefix length.
+
+    \param p_trie         A pointer to a trie.
+    \param key            A key.
+    \param p_matches      The storage for output matches. Can be NULL.
+    \param match_capacity The match capacity.
+
+    \return The match count. Or (size_t)-1 on error.
+             At most match_capacity matches are stored in p_matches even when the match count is greater than it.
+*/
+size_t tetengo_trie_trie_commonPrefixSearch(
+    const tetengo_trie_trie_t*       p_trie,
+    const char*                      key,
+    tetengo_trie_trie_prefixMatch_t* p_matches,
+    size_t                           match_capacity);
+
 /*!
     \brief Creates an iterator.
 
@@ -51,6 +51,18 @@ void tetengo_trie_trieIterator_destroy(const tetengo_trie_trieIterator_t* p_iter
 */
 const void* tetengo_trie_trieIterator_get(const tetengo_trie_trieIterator_t* p_iterator);
 
+/*!
+    \brief Returns the key of the element pointed by the iterator.
+
+    The key is obtained with the value in the same traversal. It is valid until the iterator is incremented or
+    destroyed.
+
+    \param p_iterator A pointer to an iterator.
+
+    \return The key. Or NULL on error.
+*/
+const char* tetengo_trie_trieIterator_key(const tetengo_trie_trieIterator_t* p_iterator);
+
 /*!
     \brief Returns true when the iterator will return more elements.
 
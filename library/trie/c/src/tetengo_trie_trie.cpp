@@ -8,6 +8,8 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -216,6 +218,110 @@ const void* tetengo_trie_trie_find(const tetengo_trie_trie_t* const p_trie, cons
     }
 }
 
+const char* tetengo_trie_trie_findSerialized(
+    const tetengo_trie_trie_t* const p_trie,
+    const char* const                key,
+    size_t* const                    p_size)
+{
+    try
+    {
+        if (!p_trie)
+        {
+            throw std::invalid_argument{ "p_trie is NULL." };
+        }
+        if (!key)
+        {
+            throw std::invalid_argument{ "key is NULL." };
+        }
+
+        const auto o_found = p_trie->p_cpp_trie->find_serialized(key);
+        if (!o_found)
+        {
+            return nullptr;
+        }
+        if (p_size)
+        {
+            *p_size = std::size(*o_found);
+        }
+        return std::data(*o_found);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+bool tetengo_trie_trie_findBatch(
+    const tetengo_trie_trie_t* const p_trie,
+    const char* const* const         p_keys,
+    const size_t                     key_count,
+    const void** const               p_values)
+{
+    try
+    {
+        if (!p_trie)
+        {
+            throw std::invalid_argument{ "p_trie is NULL." };
+        }
+        if (!p_keys && key_count > 0)
+        {
+            throw std::invalid_argument{ "p_keys is NULL." };
+        }
+        if (!p_values && key_count > 0)
+        {
+            throw std::invalid_argument{ "p_values is NULL." };
+        }
+        if (std::any_of(p_keys, p_keys + key_count, [](const auto* const key) { return !key; }))
+        {
+            throw std::invalid_argument{ "A key is NULL." };
+        }
+
+        const auto found = p_trie->p_cpp_trie->find_batch(std::vector<std::string_view>{ p_keys, p_keys + key_count });
+        std::transform(std::begin(found), std::end(found), p_values, [](const auto* const p_found) -> const void* {
+            return p_found ? std::data(*p_found) : nullptr;
+        });
+        return true;
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+size_t tetengo_trie_trie_commonPrefixSearch(
+    const tetengo_trie_trie_t* const       p_trie,
+    const char* const                      key,
+    tetengo_trie_trie_prefixMatch_t* const p_matches,
+    const size_t                           match_capacity)
+{
+    try
+    {
+        if (!p_trie)
+        {
+            throw std::invalid_argument{ "p_trie is NULL." };
+        }
+        if (!key)
+        {
+            throw std::invalid_argument{ "key is NULL." };
+        }
+
+        const auto found = p_trie->p_cpp_trie->common_prefix_search(key);
+        if (p_matches)
+        {
+            const auto match_count = std::min(std::size(found), match_capacity);
+            std::transform(
+                std::begin(found), std::next(std::begin(found), match_count), p_matches, [](const auto& e) {
+                    return tetengo_trie_trie_prefixMatch_t{ e.first, e.second ? std::data(*e.second) : nullptr };
+                });
+        }
+        return std::size(found);
+    }
+    catch (...)
+    {
+        return static_cast<size_t>(-1);
+    }
+}
+
 tetengo_trie_trieIterator_t* tetengo_trie_trie_createIterator(const tetengo_trie_trie_t* p_trie)
 {
     try
@@ -78,6 +78,23 @@ const void* tetengo_trie_trieIterator_get(const tetengo_trie_trieIterator_t* p_i
     }
 }
 
+const char* tetengo_trie_trieIterator_key(const tetengo_trie_trieIterator_t* p_iterator)
+{
+    try
+    {
+        if (!p_iterator)
+        {
+            throw std::invalid_argument{ "p_iterator is NULL." };
+        }
+
+        return std::data(p_iterator->p_cpp_iterator_pair->first.key());
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
 bool tetengo_trie_trieIterator_hasNext(const tetengo_trie_trieIterator_t* p_iterator)
 {
     try
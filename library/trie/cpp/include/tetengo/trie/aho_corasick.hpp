@@ -0,0 +1,140 @@
+/*! \file
+    \brief An Aho-Corasick automaton.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(TETENGO_TRIE_AHOCORASICK_HPP)
+#define TETENGO_TRIE_AHOCORASICK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+#include <boost/core/noncopyable.hpp>
+
+
+namespace tetengo::trie
+{
+    class double_array;
+
+
+    /*!
+        \brief An Aho-Corasick automaton.
+
+        It augments a double array with the failure links and the output links, which are held in arrays parallel to
+        the base-check array. The transitions are the ones of the double array itself. So a text is scanned for all
+        the keys in one pass, and each byte of the text costs an amortized constant number of transitions.
+
+        The links are serialized separately from the storage of the double array, and are read back with the same
+        double array. The serialized links have the base-check size, the root base-check index and a checksum of the
+        base-check array of the double array, so that the links for another double array are rejected.
+
+        To persist the links together with the storage, append them to the serialized storage in the same file. The
+        storage is read by memory_storage and the links by this class from the same stream in turn. Or the storage is
+        read by mmap_storage with the range of the serialized storage, and the links from the offset where it ends.
+
+        The double array must outlive the automaton, and must not be updated after the automaton is created. A
+        double array whose elements are shared among nodes, as the one over the storage of a minimized trie_set, is
+        not supported since the shared nodes have different prefixes. Nor is a minimized double array, whose values are
+        counted along the paths from the root. The empty key never matches.
+    */
+    class aho_corasick : private boost::noncopyable
+    {
+    public:
+        // types
+
+        /*!
+            \brief The match callback type.
+
+            Parameters
+            - position: The offset of the head of the matched key in the text.
+            - length:   The length of the matched key.
+            - value:    The value of the matched key.
+        */
+        using match_callback_type =
+            std::function<void(std::size_t position, std::size_t length, std::int32_t value)>;
+
+
+        // constructors and destructor
+
+        /*!
+            \brief Creates an Aho-Corasick automaton.
+
+            The double array is traversed in breadth-first order to make the links.
+
+            \param double_array_ A double array.
+
+            \throw std::invalid_argument When the elements of the double array are shared among nodes or its values are
+                                         counted.
+        */
+        explicit aho_corasick(const double_array& double_array_);
+
+        /*!
+            \brief Creates an Aho-Corasick automaton.
+
+            \param double_array_ A double array.
+            \param input_stream  An input stream of the links serialized for the double array.
+
+            \throw std::ios_base::failure When the input stream is broken or the links are not for the double array.
+        */
+        aho_corasick(const double_array& double_array_, std::istream& input_stream);
+
+        /*!
+            \brief Destroys the Aho-Corasick automaton.
+        */
+        ~aho_corasick();
+
+
+        // functions
+
+        /*!
+            \brief Scans a text.
+
+            The callback is called for each occurrence of the keys in the text, in ascending order of the tail of the
+            occurrence, and then in descending order of the length.
+
+            \param text     A text.
+            \param callback A callback.
+        */
+        void scan(const std::string_view& text, const match_callback_type& callback) const;
+
+        /*!
+            \brief Scans a text read from an input stream.
+
+            The text is read in blocks until the end of the stream. The positions are the offsets from where the
+            scanning starts.
+
+            \param input_stream An input stream.
+            \param callback     A callback.
+        */
+        void scan(std::istream& input_stream, const match_callback_type& callback) const;
+
+        /*!
+            \brief Serializes the links.
+
+            \param output_stream An output stream.
+        */
+        void serialize(std::ostream& output_stream) const;
+
+
+    private:
+        // types
+
+        class impl;
+
+
+        // variables
+
+        const std::unique_ptr<impl> m_p_impl;
+    };
+
+
+}
+
+
+#endif
@@ -28,6 +28,17 @@ namespace tetengo::trie
 
     /*!
         \brief A double array.
+
+        A double array built minimized shares the base-check elements among the equivalent suffix subtrees, which have
+        the same labels in the same structure. Its values are not held at the key terminators but counted: the value of
+        a key is its index in ascending order of the distinct keys, which is the sum of the preceding key counts of the
+        storage on its path. So it is a minimal acyclic automaton of the keys, and the values given with the elements
+        are not used. A minimized double array is always built by a single thread though the elements are sorted by
+        build_thread_count threads. Its storage is serialized only in the format version 2.
+
+        The elements of a storage may also be shared among the nodes without the counting, as in the storage of a
+        minimized trie_set, whose keys all have the same value. Either storage is read in the same way as the others,
+        but can't be modified.
     */
     class double_array : private boost::noncopyable
     {
@@ -51,6 +62,19 @@ namespace tetengo::trie
             std::function<void()> done;
         };
 
+        //! The fuzzy search element type.
+        struct fuzzy_search_element_type
+        {
+            //! The key.
+            std::string key;
+
+            //! The edit distance from the searched key.
+            std::size_t distance;
+
+            //! The value.
+            std::int32_t value;
+        };
+
 
         // static functions
 
@@ -68,6 +92,17 @@ namespace tetengo::trie
         */
         [[nodiscard]] static std::size_t default_density_factor();
 
+        /*!
+            \brief Returns the default build thread count.
+
+            When the build thread count is greater than 1, the sorting of the elements and the building of the subtrees
+            are done in parallel. The layout of the double array then differs from the one built by a single thread,
+            while its serialized format is the same.
+
+            \return The default build thread count.
+        */
+        [[nodiscard]] static std::size_t default_build_thread_count();
+
         /*!
             \brief Returns the key terminator.
 
@@ -96,13 +131,17 @@ namespace tetengo::trie
             \param elements              Initial elements.
             \param building_observer_set A building observer set.
             \param density_factor        A density factor. Must be greater than 0.
+            \param build_thread_count    A build thread count. Must be greater than 0.
+            \param minimized             True to build a minimized double array, whose values are counted.
 
-            \throw std::invalid_argument When density_factor is 0.
+            \throw std::invalid_argument When density_factor or build_thread_count is 0.
         */
         explicit double_array(
             const std::vector<std::pair<std::string_view, std::int32_t>>& elements,
             const building_observer_set_type& building_observer_set = null_building_observer_set(),
-            std::size_t                       density_factor = default_density_factor());
+            std::size_t                       density_factor = default_density_factor(),
+            std::size_t                       build_thread_count = default_build_thread_count(),
+            bool                              minimized = false);
 
         /*!
             \brief Creates a double array.
@@ -110,13 +149,17 @@ namespace tetengo::trie
             \param elements              Initial elements.
             \param building_observer_set A building observer set.
             \param density_factor        A density factor. Must be greater than 0.
+            \param build_thread_count    A build thread count. Must be greater than 0.
+            \param minimized             True to build a minimized double array, whose values are counted.
 
-            \throw std::invalid_argument When density_factor is 0.
+            \throw std::invalid_argument When density_factor or build_thread_count is 0.
         */
         explicit double_array(
             const std::vector<std::pair<std::string, std::int32_t>>& elements,
             const building_observer_set_type& building_observer_set = null_building_observer_set(),
-            std::size_t                       density_factor = default_density_factor());
+            std::size_t                       density_factor = default_density_factor(),
+            std::size_t                       build_thread_count = default_build_thread_count(),
+            bool                              minimized = false);
 
         /*!
             \brief Creates a double array.
@@ -127,18 +170,24 @@ namespace tetengo::trie
             \param last                  An iterator to the last element.
             \param building_observer_set A building observer set.
             \param density_factor        A density factor. Must be greater than 0.
+            \param build_thread_count    A build thread count. Must be greater than 0.
+            \param minimized             True to build a minimized double array, whose values are counted.
 
-            \throw std::invalid_argument When density_factor is 0.
+            \throw std::invalid_argument When density_factor or build_thread_count is 0.
         */
         template <typename InputIterator>
         double_array(
             InputIterator                     first,
             InputIterator                     last,
             const building_observer_set_type& building_observer_set = null_building_observer_set(),
-            std::size_t                       density_factor = default_density_factor()) :
+            std::size_t                       density_factor = default_density_factor(),
+            std::size_t                       build_thread_count = default_build_thread_count(),
+            bool                              minimized = false) :
         double_array{ std::vector<typename InputIterator::value_type>{ first, last },
                       building_observer_set,
-                      density_factor }
+                      density_factor,
+                      build_thread_count,
+                      minimized }
         {}
 
         /*!
@@ -166,6 +215,47 @@ namespace tetengo::trie
         */
         [[nodiscard]] std::optional<std::int32_t> find(const std::string_view& key) const;
 
+        /*!
+            \brief Finds the values corresponding to the given keys.
+
+            The traversals for the keys are interleaved, and the next base-check element of each traversal is
+            prefetched while the others proceed. It hides the memory latency on a double array larger than the cache.
+
+            \param keys Keys.
+
+            \return The values in the order of the keys. An element is std::nullopt when the double array does not have
+                    the corresponding key.
+        */
+        [[nodiscard]] std::vector<std::optional<std::int32_t>>
+        find_batch(const std::vector<std::string_view>& keys) const;
+
+        /*!
+            \brief Finds the values corresponding to the prefixes of the given key.
+
+            The double array is traversed only once from the root.
+
+            \param key A key.
+
+            \return The pairs of a prefix length and a value, in ascending order of the prefix length.
+        */
+        [[nodiscard]] std::vector<std::pair<std::size_t, std::int32_t>>
+        common_prefix_search(const std::string_view& key) const;
+
+        /*!
+            \brief Finds the values corresponding to the keys within the given edit distance of the given key.
+
+            The edit distance is the Levenshtein distance counted in bytes. The double array is traversed from the root
+            with a row of the edit distance table for each node, and a subtree is skipped as soon as all the distances
+            in the row exceed max_distance. So only the nodes near the given key are visited.
+
+            \param key          A key.
+            \param max_distance A maximum edit distance.
+
+            \return The found elements in ascending order of the key.
+        */
+        [[nodiscard]] std::vector<fuzzy_search_element_type>
+        fuzzy_search(const std::string_view& key, std::size_t max_distance) const;
+
         /*!
             \brief Returns a first iterator.
 
@@ -183,6 +273,13 @@ namespace tetengo::trie
         /*!
             \brief Returns a subtrie.
 
+            The subtrie shares the storage with this double array. No storage is copied, and the storage lives while
+            either of them is alive. A modification through the storage of either of them affects the other.
+
+            The subtrie follows its key prefix when an insertion or an erasure through any double array sharing the
+            storage moves the elements. While the key prefix is erased, the functions of the subtrie but get_storage()
+            throw std::logic_error.
+
             \param key_prefix A key prefix.
 
             \return A unique pointer to a double array of the subtrie.
@@ -190,6 +287,66 @@ namespace tetengo::trie
         */
         [[nodiscard]] std::unique_ptr<double_array> subtrie(const std::string_view& key_prefix) const;
 
+        /*!
+            \brief Returns a storage in which the elements are relocated for the cache locality.
+
+            The elements of the top levels, which all the lookups pass through, are placed breadth-first at the head
+            of the base-check array. The other elements are placed depth-first, so that the elements on a lookup path
+            are close to each other. Among siblings, the ones passed through more frequently by the sample keys are
+            placed first. The elements shared among nodes stay shared. The value objects are copied.
+
+            \param sample_keys Sample keys, such as the ones in a query log. May be empty.
+
+            \return A unique pointer to a storage whose root base-check index is 0.
+        */
+        [[nodiscard]] std::unique_ptr<storage>
+        relocated_storage(const std::vector<std::string_view>& sample_keys = std::vector<std::string_view>{}) const;
+
+        /*!
+            \brief Inserts an element.
+
+            Only the elements on the path of the key are modified. When a new child conflicts with another element, the
+            children of the node are moved to another base. The first insertion or erasure scans the whole base-check
+            array once.
+
+            The storage must be writable, such as memory_storage, must not have the preceding key counts, and its
+            elements must not be shared among nodes as in the storage of a minimized trie_set. The double arrays
+            sharing the storage, such as the subtries, can be modified in turn, but the storage must not be modified
+            directly after a modification.
+
+            \param key   A key.
+            \param value A value.
+
+            \retval true  When the element is inserted.
+            \retval false When the double array already has the key. The value is not modified.
+
+            \throw std::logic_error When the storage is not writable, has the preceding key counts or its elements are
+                                    shared among nodes.
+        */
+        bool insert(const std::string_view& key, std::int32_t value);
+
+        /*!
+            \brief Erases an element.
+
+            The nodes left without any child are also vacated. See insert() for the requirements.
+
+            \param key A key.
+
+            \retval true  When the element is erased.
+            \retval false When the double array does not have the key.
+
+            \throw std::logic_error When the storage is not writable, has the preceding key counts or its elements are
+                                    shared among nodes.
+        */
+        bool erase(const std::string_view& key);
+
+        /*!
+            \brief Returns the root base-check index.
+
+            \return The root base-check index.
+        */
+        [[nodiscard]] std::size_t root_base_check_index() const;
+
         /*!
             \brief Returns the storage.
 
@@ -214,6 +371,11 @@ namespace tetengo::trie
         // variables
 
         const std::unique_ptr<impl> m_p_impl;
+
+
+        // constructors
+
+        explicit double_array(std::unique_ptr<impl>&& p_impl);
     };
 
 
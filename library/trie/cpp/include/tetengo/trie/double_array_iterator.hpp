@@ -11,21 +11,26 @@
 #include <cstdint>
 #include <iterator>
 #include <optional>
-#include <stack>
 #include <string>
-#include <utility>
+#include <string_view>
 #include <vector>
 
 #include <boost/stl_interfaces/iterator_interface.hpp>
 
+#include <tetengo/trie/storage.hpp>
+
 
 namespace tetengo::trie
 {
-    class storage;
-
-
     /*!
         \brief A double array iterator.
+
+        It traverses the double array in depth-first order, keeping only the path from the root in a reused stack and
+        the key to the current element in a reused buffer. So it allocates no memory per element once the stack and the
+        buffer have grown to the depth of the double array.
+
+        The children of each element are enumerated by reading the check values of its child range directly from the
+        base-check array when the storage exposes it, without any virtual function call per element.
     */
     class double_array_iterator :
     public boost::stl_interfaces::iterator_interface<double_array_iterator, std ::forward_iterator_tag, std::int32_t>
@@ -43,10 +48,17 @@ namespace tetengo::trie
         /*!
             \brief Creates an iterator.
 
+            The values are offset by root_value_offset when the storage has the preceding key counts.
+
             \param storage_              A storage.
             \param root_base_check_index A root base-check index.
+            \param root_value_offset     A root value offset, which is the sum of the preceding key counts on the path
+                                         to the root.
         */
-        double_array_iterator(const storage& storage_, std::size_t root_base_check_index);
+        double_array_iterator(
+            const storage& storage_,
+            std::size_t    root_base_check_index,
+            std::int32_t   root_value_offset = 0);
 
 
         // functions
@@ -79,6 +91,18 @@ namespace tetengo::trie
         */
         [[nodiscard]] std::int32_t* operator->();
 
+        /*!
+            \brief Returns the key.
+
+            The key is the serialized one relative to the root of the iteration, and is followed by a null character.
+            It is valid until the iterator is incremented or destroyed.
+
+            \return The key.
+
+            \throw std::logic_error When the iterator is not dereferenceable.
+        */
+        [[nodiscard]] std::string_view key() const;
+
         /*!
             \brief Returns true when one iterator is equal to another.
 
@@ -106,12 +130,27 @@ namespace tetengo::trie
 
 
     private:
+        // types
+
+        struct frame_type
+        {
+            std::size_t base_check_index;
+
+            std::int32_t base;
+
+            std::int32_t next_char_code;
+
+            std::int32_t value_offset;
+        };
+
+
         // variables
 
         const storage* m_p_storage;
 
-        std::stack<std::pair<std::size_t, std::string>, std::vector<std::pair<std::size_t, std::string>>>
-            m_base_check_index_key_stack;
+        std::vector<frame_type> m_frames;
+
+        std::string m_key;
 
         std::optional<std::int32_t> m_current;
 
@@ -119,6 +158,9 @@ namespace tetengo::trie
         // functions
 
         std::optional<std::int32_t> next();
+
+        template <typename Accessor>
+        std::optional<std::int32_t> next_with(const Accessor& accessor);
     };
 
 
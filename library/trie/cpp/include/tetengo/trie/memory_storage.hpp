@@ -10,8 +10,12 @@
 #include <any> // IWYU pragma: keep
 #include <cstddef> // IWYU pragma: keep
 #include <cstdint>
+#include <functional>
 #include <istream>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <vector>
 
 #include <tetengo/trie/storage.hpp>
 
@@ -24,6 +28,12 @@ namespace tetengo::trie
 
     /*!
         \brief A memory storage.
+
+        A base-check element is packed into a 32-bit word while all the bases fit in 24 bits. Once a base which does not
+        fit is set, the storage switches to the wide layout with 64-bit words, and is serialized in that layout.
+
+        Both of the content serialized by serialize() and the one by serialize_v2() can be read. The preceding key
+        counts are held only after one is set, and are serialized only by serialize_v2().
     */
     class memory_storage : public storage
     {
@@ -49,6 +59,67 @@ namespace tetengo::trie
         virtual ~memory_storage();
 
 
+    protected:
+        // static functions
+
+        /*!
+            \brief Serializes a value array.
+
+            \param output_stream       An output stream.
+            \param value_serializer_   A serializer for value objects.
+            \param value_count         A value count.
+            \param serialized_value_at A function which returns the serialized value at an index. Or std::nullopt when
+                                       no value is at the index.
+
+            \throw std::length_error When the values serialized with an offset index exceed 4 GiB.
+        */
+        static void serialize_value_array(
+            std::ostream&                                                       output_stream,
+            const value_serializer&                                             value_serializer_,
+            std::size_t                                                         value_count,
+            const std::function<std::optional<std::vector<char>>(std::size_t)>& serialized_value_at);
+
+
+        // constructors
+
+        /*!
+            \brief Creates a memory storage.
+
+            Only the base-check array is read from the input stream. The value array following it is left for the
+            derived class.
+
+            \param input_stream An input stream.
+        */
+        explicit memory_storage(std::istream& input_stream);
+
+
+        // functions
+
+        /*!
+            \brief Serializes the base-check array of this storage.
+
+            \param output_stream An output stream.
+        */
+        void serialize_base_check_array(std::ostream& output_stream) const;
+
+        /*!
+            \brief Deserializes a value array.
+
+            The value array is read in the format of the base-check array read by the constructor.
+
+            \param input_stream         An input stream.
+            \param reserve              A function called with the value count before the values.
+            \param add_serialized_value A function called with each serialized value in order. Or with nullptr when no
+                                        value is there.
+
+            \throw std::ios_base::failure When the input stream is broken.
+        */
+        void deserialize_value_array(
+            std::istream&                                         input_stream,
+            const std::function<void(std::size_t)>&               reserve,
+            const std::function<void(const std::vector<char>*)>& add_serialized_value) const;
+
+
     private:
         // types
 
@@ -72,12 +143,29 @@ namespace tetengo::trie
 
         virtual void set_check_at_impl(std::size_t base_check_index, std::uint8_t check) override;
 
+        virtual void prefetch_base_check_at_impl(std::size_t base_check_index) const override;
+
+        virtual std::optional<base_check_array_view_type> base_check_array_view_impl() const override;
+
+        virtual bool has_preceding_key_counts_impl() const override;
+
+        virtual std::uint32_t preceding_key_count_at_impl(std::size_t base_check_index) const override;
+
+        virtual void
+        set_preceding_key_count_at_impl(std::size_t base_check_index, std::uint32_t preceding_key_count) override;
+
         virtual std::size_t value_count_impl() const override;
 
         virtual const std::any* value_at_impl(std::size_t value_index) const override;
 
         virtual void add_value_at_impl(std::size_t value_index, std::any value) override;
 
+        virtual void erase_value_at_impl(std::size_t value_index) override;
+
+        virtual std::size_t vacant_value_count_impl() const override;
+
+        virtual std::optional<std::size_t> vacant_value_index_impl() const override;
+
         virtual double filling_rate_impl() const override;
 
         virtual void
@@ -12,6 +12,8 @@
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <optional>
+#include <span>
 
 #include <boost/interprocess/file_mapping.hpp> // IWYU pragma: keep
 
@@ -23,6 +25,24 @@ namespace tetengo::trie
 {
     /*!
         \brief An mmap storage.
+
+        The content range of the file is mapped into the memory once on construction.
+        The base-check array and the values are read directly through the mapping.
+        Both of the narrow and wide base-check layouts serialized by memory_storage can be read.
+        The content serialized by serialize_v2() can also be read. Its header is validated on construction, and its
+        base-check array is exposed as it is by base_check_array_view() on a little-endian machine.
+        The values must be serialized in a fixed size, or with an offset index by an indexed value_serializer, unless
+        there is no value as in the storage of a trie_set.
+        serialized_value_at() returns the value bytes in the mapping as they are, without the deserialization nor the
+        value cache.
+
+        By default, the value cache is not synchronized and the storage must not be read by multiple threads at the
+        same time, even through its clones. When a positive value cache shard count is specified, the value cache is
+        divided into the shards each of which is guarded by its own lock, and the storage and its clones can be read
+        by multiple threads concurrently. Each shard evicts its values in the CLOCK manner, so that the shards hold the
+        values up to the value cache capacity in total. Since another thread may evict a value at any time, value_at()
+        throws std::logic_error in this mode, and the values must be read with shared_value_at(), which keeps the value
+        while its pointer is held. The iterators of a trie read the values in the same way.
     */
     class mmap_storage : public storage
     {
@@ -42,20 +62,24 @@ namespace tetengo::trie
         /*!
             \brief Creates an mmap storage.
 
-            \param file_mapping_        A file mapping.
-            \param content_offset       A content offset in the file.
-            \param file_size            The file size.
-            \param value_deserializer_  A deserializer for value objects.
-            \param value_cache_capacity A value cache capacity.
+            \param file_mapping_           A file mapping.
+            \param content_offset          A content offset in the file.
+            \param file_size               The file size.
+            \param value_deserializer_     A deserializer for value objects.
+            \param value_cache_capacity    A value cache capacity.
+            \param value_cache_shard_count A value cache shard count. 0 makes the value cache for a single thread.
 
-            \throw std::invalid_argument When content_offset is greater than file_size, or the value size is not fixed.
+            \throw std::invalid_argument  When content_offset is greater than file_size, or the values are neither
+                                          fixed size nor indexed.
+            \throw std::ios_base::failure When the header of the format version 2 is broken or unsupported.
         */
         mmap_storage(
             const boost::interprocess::file_mapping& file_mapping_,
             std::size_t                              content_offset,
             std::size_t                              file_size,
             value_deserializer                       value_deserializer_,
-            std::size_t                              value_cache_capacity = default_value_cache_capacity());
+            std::size_t                              value_cache_capacity = default_value_cache_capacity(),
+            std::size_t                              value_cache_shard_count = 0);
 
         /*!
             \brief Destroys the mmap storage.
@@ -91,12 +115,26 @@ namespace tetengo::trie
 
         virtual void set_check_at_impl(std::size_t base_check_index, std::uint8_t check) override;
 
+        virtual void prefetch_base_check_at_impl(std::size_t base_check_index) const override;
+
+        virtual std::optional<base_check_array_view_type> base_check_array_view_impl() const override;
+
+        virtual bool has_preceding_key_counts_impl() const override;
+
+        virtual std::uint32_t preceding_key_count_at_impl(std::size_t base_check_index) const override;
+
         virtual std::size_t value_count_impl() const override;
 
         virtual const std::any* value_at_impl(std::size_t value_index) const override;
 
+        virtual std::shared_ptr<const std::any> shared_value_at_impl(std::size_t value_index) const override;
+
+        virtual std::optional<std::span<const char>> serialized_value_at_impl(std::size_t value_index) const override;
+
         virtual void add_value_at_impl(std::size_t value_index, std::any value) override;
 
+        virtual std::size_t vacant_value_count_impl() const override;
+
         virtual double filling_rate_impl() const override;
 
         virtual void
@@ -0,0 +1,653 @@
+/*! \file
+    \brief An overlay trie.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(TETENGO_TRIE_OVERLAYTRIE_HPP)
+#define TETENGO_TRIE_OVERLAYTRIE_HPP
+
+#include <any>
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+#include <boost/stl_interfaces/iterator_interface.hpp>
+
+#include <tetengo/trie/default_serializer.hpp> // IWYU pragma: keep
+#include <tetengo/trie/stream_builder.hpp>
+#include <tetengo/trie/trie.hpp>
+#include <tetengo/trie/trie_iterator.hpp>
+
+
+namespace tetengo::trie
+{
+    class value_serializer;
+
+
+    /*!
+        \brief An overlay trie iterator.
+
+        It yields the values of the base trie and the delta trie in ascending order of the serialized keys. The erased
+        elements are skipped.
+
+        \tparam Value A value type.
+    */
+    template <typename Value>
+    class overlay_trie_iterator :
+    public boost::stl_interfaces::
+        iterator_interface<overlay_trie_iterator<Value>, std::forward_iterator_tag, Value, const Value&>
+    {
+    public:
+        // types
+
+        //! The value type.
+        using value_type = Value;
+
+
+        // constructors and destructor
+
+        /*!
+            \brief Creates an iterator.
+
+            \param base_first  An iterator to the first element of the base trie.
+            \param base_last   An iterator to the last element of the base trie.
+            \param delta_first An iterator to the first element of the delta trie.
+            \param delta_last  An iterator to the last element of the delta trie.
+        */
+        overlay_trie_iterator(
+            trie_iterator<value_type> base_first,
+            trie_iterator<value_type> base_last,
+            trie_iterator<value_type> delta_first,
+            trie_iterator<value_type> delta_last) :
+        m_base{ std::move(base_first) },
+        m_base_last{ std::move(base_last) },
+        m_delta{ std::move(delta_first) },
+        m_delta_last{ std::move(delta_last) },
+        m_in_delta{ false }
+        {
+            skip_erased();
+        }
+
+
+        // functions
+
+        /*!
+            \brief Dereferences the iterator.
+
+            \return The dereferenced value.
+        */
+        [[nodiscard]] const value_type& operator*() const
+        {
+            return m_in_delta ? *m_delta : *m_base;
+        }
+
+        /*!
+            \brief Returns the key.
+
+            The key is the serialized one relative to the root of the overlay trie. It is valid until the iterator is
+            incremented or destroyed.
+
+            \return The serialized key.
+
+            \throw std::logic_error When the iterator is not dereferenceable.
+        */
+        [[nodiscard]] std::string_view key() const
+        {
+            return m_in_delta ? m_delta.key() : m_base.key();
+        }
+
+        /*!
+            \brief Returns true when one iterator is equal to another.
+
+            \param one   One iterator.
+            \param another Another iterator.
+
+            \retval true  When one is equal to another.
+            \retval false Otherwise.
+        */
+        friend bool operator==(const overlay_trie_iterator& one, const overlay_trie_iterator& another)
+        {
+            return one.m_base == another.m_base && one.m_delta == another.m_delta;
+        }
+
+        /*!
+            \brief Increments the iterator.
+
+            \return This iterator.
+        */
+        overlay_trie_iterator& operator++()
+        {
+            if (m_in_delta)
+            {
+                ++m_delta;
+            }
+            else
+            {
+                ++m_base;
+            }
+            skip_erased();
+            return *this;
+        }
+
+        /*!
+            \brief Postincrements the iterator.
+
+            \return The iterator before the incrementation.
+        */
+        overlay_trie_iterator operator++(int)
+        {
+            overlay_trie_iterator original{ *this };
+            ++(*this);
+            return original;
+        }
+
+
+    private:
+        // variables
+
+        trie_iterator<value_type> m_base;
+
+        trie_iterator<value_type> m_base_last;
+
+        trie_iterator<value_type> m_delta;
+
+        trie_iterator<value_type> m_delta_last;
+
+        bool m_in_delta;
+
+
+        // functions
+
+        void skip_erased()
+        {
+            // A tombstone in the delta trie is an element whose value object is empty.
+            while (m_delta != m_delta_last)
+            {
+                const auto tombstone = !m_delta.operator->();
+                if (m_base == m_base_last)
+                {
+                    if (!tombstone)
+                    {
+                        m_in_delta = true;
+                        return;
+                    }
+                    ++m_delta;
+                    continue;
+                }
+
+                const auto comparison = m_delta.key().compare(m_base.key());
+                if (comparison > 0)
+                {
+                    break;
+                }
+                if (comparison == 0)
+                {
+                    ++m_base;
+                }
+                if (!tombstone)
+                {
+                    m_in_delta = true;
+                    return;
+                }
+                ++m_delta;
+            }
+            m_in_delta = false;
+        }
+    };
+
+
+    /*!
+        \brief An overlay trie.
+
+        It lays a small mutable delta trie over a read-only base trie, such as one with mmap_storage. The inserted
+        elements go into the delta trie, and the erased elements of the base trie are shadowed by the tombstones in
+        the delta trie. So the base trie is neither rebuilt nor modified.
+
+        A lookup searches the delta trie and then the base trie only when the delta trie does not have the key. The
+        delta trie is searched only when it is not empty, so a lookup takes little more time than one of the base
+        trie while the delta trie is small. The delta trie grows with the updates, and compact() merges it into a new
+        trie file.
+
+        The base trie must be created with the same key serializer as the overlay trie.
+
+        \tparam Key           A key type.
+        \tparam Value         A value type.
+        \tparam KeySerializer A key serializer type.
+    */
+    template <typename Key, typename Value, typename KeySerializer = default_serializer<Key, void>>
+    class overlay_trie : private boost::noncopyable
+    {
+    public:
+        // types
+
+        //! The key type.
+        using key_type = Key;
+
+        //! The value type.
+        using value_type = Value;
+
+        //! The key serializer_type.
+        using key_serializer_type = KeySerializer;
+
+        //! The trie type.
+        using trie_type = trie<key_type, value_type, key_serializer_type>;
+
+        //! The iterator type.
+        using iterator = overlay_trie_iterator<value_type>;
+
+
+        // constructors and destructor
+
+        /*!
+            \brief Creates an overlay trie.
+
+            \param p_base         A unique pointer to a base trie.
+            \param key_serializer A key serializer.
+
+            \throw std::invalid_argument When p_base is nullptr.
+        */
+        explicit overlay_trie(
+            std::unique_ptr<trie_type>&& p_base,
+            const key_serializer_type&   key_serializer = default_serializer<key_type, void>{ true }) :
+        m_p_base{ std::move(p_base) },
+        m_delta{},
+        m_size{ 0 },
+        m_key_serializer{ key_serializer }
+        {
+            if (!m_p_base)
+            {
+                throw std::invalid_argument{ "p_base is nullptr." };
+            }
+            m_size = std::size(*m_p_base);
+        }
+
+
+        // functions
+
+        /*!
+            \brief Returns true when the overlay trie is empty.
+
+            \retval true  When the overlay trie is empty.
+            \retval false Otherwise.
+        */
+        [[nodiscard]] bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        /*!
+            \brief Returns the size of the overlay trie.
+
+            \return The size.
+        */
+        [[nodiscard]] std::size_t size() const
+        {
+            return m_size;
+        }
+
+        /*!
+            \brief Returns the size of the delta trie.
+
+            It is the count of the inserted elements and the tombstones of the erased ones. It is a hint of when to
+            compact the overlay trie.
+
+            \return The size of the delta trie.
+        */
+        [[nodiscard]] std::size_t delta_size() const
+        {
+            return std::size(m_delta);
+        }
+
+        /*!
+            \brief Returns true when the overlay trie contains the given key.
+
+            \param key A key.
+
+            \retval true  When the overlay trie contains the given key.
+            \retval false Otherwise.
+        */
+        [[nodiscard]] bool contains(const key_type& key) const
+        {
+            if (!std::empty(m_delta))
+            {
+                const auto& serialized_key = m_key_serializer(key);
+                if (const auto* const p_found = m_delta.find(to_string_view(serialized_key)); p_found)
+                {
+                    return p_found->has_value();
+                }
+            }
+            return m_p_base->contains(key);
+        }
+
+        /*!
+            \brief Finds the value object correspoinding the given key.
+
+            \param key A key.
+
+            \return A pointer to the value object. Or nullptr when the overlay trie does not have the given key.
+        */
+        [[nodiscard]] const value_type* find(const key_type& key) const
+        {
+            if (!std::empty(m_delta))
+            {
+                const auto& serialized_key = m_key_serializer(key);
+                if (const auto* const p_found = m_delta.find(to_string_view(serialized_key)); p_found)
+                {
+                    return std::any_cast<value_type>(p_found);
+                }
+            }
+            return m_p_base->find(key);
+        }
+
+        /*!
+            \brief Finds the value object correspoinding the given key, shared with the caller.
+
+            See trie::find_shared() for details.
+
+            \param key A key.
+
+            \return A shared pointer to the value object. Or nullptr when the overlay trie does not have the given key.
+        */
+        [[nodiscard]] std::shared_ptr<const value_type> find_shared(const key_type& key) const
+        {
+            if (!std::empty(m_delta))
+            {
+                const auto& serialized_key = m_key_serializer(key);
+                if (const auto* const p_found = m_delta.find(to_string_view(serialized_key)); p_found)
+                {
+                    const auto* const p_value = std::any_cast<value_type>(p_found);
+                    return p_value ?
+                               std::shared_ptr<const value_type>{ std::shared_ptr<const value_type>{}, p_value } :
+                               nullptr;
+                }
+            }
+            return m_p_base->find_shared(key);
+        }
+
+        /*!
+            \brief Finds the value objects corresponding to the prefixes of the given key.
+
+            The prefix lengths are counted in the serialized key.
+
+            \param key A key.
+
+            \return The pairs of a prefix length and a pointer to the value object, in ascending order of the prefix
+                    length.
+        */
+        [[nodiscard]] std::vector<std::pair<std::size_t, const value_type*>>
+        common_prefix_search(const key_type& key) const
+        {
+            auto base_found = m_p_base->common_prefix_search(key);
+            if (std::empty(m_delta))
+            {
+                return base_found;
+            }
+            const auto& serialized_key = m_key_serializer(key);
+            const auto  delta_found = m_delta.common_prefix_search(to_string_view(serialized_key));
+            if (std::empty(delta_found))
+            {
+                return base_found;
+            }
+
+            std::vector<std::pair<std::size_t, const value_type*>> merged{};
+            merged.reserve(std::size(base_found) + std::size(delta_found));
+            auto base_position = std::begin(base_found);
+            for (const auto& delta_element: delta_found)
+            {
+                while (base_position != std::end(base_found) && base_position->first < delta_element.first)
+                {
+                    merged.push_back(*base_position);
+                    ++base_position;
+                }
+                if (base_position != std::end(base_found) && base_position->first == delta_element.first)
+                {
+                    ++base_position;
+                }
+                if (delta_element.second->has_value())
+                {
+                    merged.emplace_back(delta_element.first, std::any_cast<value_type>(delta_element.second));
+                }
+            }
+            merged.insert(std::end(merged), base_position, std::end(base_found));
+            return merged;
+        }
+
+        /*!
+            \brief Returns the first iterator.
+
+            \return The first iterator.
+        */
+        [[nodiscard]] iterator begin() const
+        {
+            return iterator{ std::begin(*m_p_base),
+                             std::end(*m_p_base),
+                             trie_iterator<value_type>{ std::begin(m_delta) },
+                             trie_iterator<value_type>{ std::end(m_delta) } };
+        }
+
+        /*!
+            \brief Returns the last iterator.
+
+            \return The last iterator.
+        */
+        [[nodiscard]] iterator end() const
+        {
+            return iterator{ std::end(*m_p_base),
+                             std::end(*m_p_base),
+                             trie_iterator<value_type>{ std::end(m_delta) },
+                             trie_iterator<value_type>{ std::end(m_delta) } };
+        }
+
+        /*!
+            \brief Returns a subtrie.
+
+            The subtrie shares the base trie storage, and has a copy of the part of the delta trie under the key
+            prefix. So the updates of the subtrie and the ones of this overlay trie do not affect each other.
+
+            \param key_prefix A key prefix.
+
+            \return A unique pointer to a subtrie.
+                    Or nullptr when the overlay trie does not have the given key prefix.
+        */
+        [[nodiscard]] std::unique_ptr<overlay_trie> subtrie(const key_type& key_prefix) const
+        {
+            auto p_base_subtrie = m_p_base->subtrie(key_prefix);
+
+            const auto& serialized_key_prefix = m_key_serializer(key_prefix);
+            const auto  p_delta_subtrie =
+                std::empty(m_delta) ? nullptr : m_delta.subtrie(to_string_view(serialized_key_prefix));
+            if (!p_base_subtrie && !p_delta_subtrie)
+            {
+                return nullptr;
+            }
+            if (!p_base_subtrie)
+            {
+                p_base_subtrie = std::make_unique<trie_type>(m_key_serializer);
+            }
+
+            auto p_subtrie = std::make_unique<overlay_trie>(std::move(p_base_subtrie), m_key_serializer);
+            if (p_delta_subtrie)
+            {
+                for (auto i = std::begin(*p_delta_subtrie); i != std::end(*p_delta_subtrie); ++i)
+                {
+                    p_subtrie->m_delta.insert(i.key(), *i);
+                    if ((*i).has_value())
+                    {
+                        ++p_subtrie->m_size;
+                    }
+                    else
+                    {
+                        --p_subtrie->m_size;
+                    }
+                }
+            }
+            return p_subtrie;
+        }
+
+        /*!
+            \brief Inserts an element.
+
+            The element is inserted into the delta trie.
+
+            \param key   A key.
+            \param value A value.
+
+            \retval true  When the element is inserted.
+            \retval false When the overlay trie already has the key. The value is not modified.
+        */
+        bool insert(const key_type& key, value_type value)
+        {
+            const auto& serialized_key = m_key_serializer(key);
+            const auto  serialized_key_view = to_string_view(serialized_key);
+            if (const auto* const p_found = m_delta.find(serialized_key_view); p_found)
+            {
+                if (p_found->has_value())
+                {
+                    return false;
+                }
+                m_delta.erase(serialized_key_view);
+            }
+            else if (m_p_base->contains(key))
+            {
+                return false;
+            }
+
+            m_delta.insert(serialized_key_view, std::any{ std::move(value) });
+            ++m_size;
+            return true;
+        }
+
+        /*!
+            \brief Erases an element.
+
+            An element in the delta trie is erased from it. An element in the base trie is shadowed by a tombstone
+            inserted into the delta trie.
+
+            \param key A key.
+
+            \retval true  When the element is erased.
+            \retval false When the overlay trie does not have the key.
+        */
+        bool erase(const key_type& key)
+        {
+            const auto& serialized_key = m_key_serializer(key);
+            const auto  serialized_key_view = to_string_view(serialized_key);
+            const auto  in_base = m_p_base->contains(key);
+            if (const auto* const p_found = m_delta.find(serialized_key_view); p_found)
+            {
+                if (!p_found->has_value())
+                {
+                    return false;
+                }
+                m_delta.erase(serialized_key_view);
+            }
+            else if (!in_base)
+            {
+                return false;
+            }
+
+            if (in_base)
+            {
+                m_delta.insert(serialized_key_view, std::any{});
+            }
+            --m_size;
+            return true;
+        }
+
+        /*!
+            \brief Compacts the overlay trie.
+
+            A trie of the merged elements is written into the output stream in the background, in the format which
+            memory_storage and mmap_storage read. The delta trie is copied on the call, so this overlay trie can be
+            updated during the compaction. The updates after the call are not written.
+
+            The base trie is read both by the compaction and by this overlay trie. So its storage must allow
+            concurrent reads, such as mmap_storage with a concurrent value cache or memory_storage.
+
+            The overlay trie, the output stream and the value serializer must outlive the compaction.
+
+            \param output_stream     An output stream. It must be seekable.
+            \param value_serializer_ A serializer for value objects.
+            \param window_size       A window size of the stream builder.
+            \param wide              True to write the base-check array in the wide layout.
+
+            \return A future of the compaction. It rethrows the exception thrown in the compaction.
+        */
+        [[nodiscard]] std::future<void> compact(
+            std::ostream&           output_stream,
+            const value_serializer& value_serializer_,
+            const std::size_t       window_size = stream_builder::default_window_size(),
+            const bool              wide = false) const
+        {
+            auto p_delta_snapshot = std::make_unique<trie_impl>(m_delta.get_storage().clone());
+            return std::async(
+                std::launch::async,
+                [this,
+                 p_delta_snapshot = std::move(p_delta_snapshot),
+                 &output_stream,
+                 &value_serializer_,
+                 window_size,
+                 wide]() {
+                    stream_builder builder{ output_stream, value_serializer_, window_size, wide };
+                    const iterator last{ std::end(*m_p_base),
+                                         std::end(*m_p_base),
+                                         trie_iterator<value_type>{ std::end(*p_delta_snapshot) },
+                                         trie_iterator<value_type>{ std::end(*p_delta_snapshot) } };
+                    for (iterator i{ std::begin(*m_p_base),
+                                     std::end(*m_p_base),
+                                     trie_iterator<value_type>{ std::begin(*p_delta_snapshot) },
+                                     trie_iterator<value_type>{ std::end(*p_delta_snapshot) } };
+                         i != last;
+                         ++i)
+                    {
+                        builder.add(i.key(), std::any{ *i });
+                    }
+                    builder.finish();
+                });
+        }
+
+        /*!
+            \brief Returns the base trie.
+
+            \return The base trie.
+        */
+        [[nodiscard]] const trie_type& get_base() const
+        {
+            return *m_p_base;
+        }
+
+
+    private:
+        // static functions
+
+        template <typename SerializedKey>
+        static std::string_view to_string_view(const SerializedKey& serialized_key)
+        {
+            return std::string_view{ std::data(serialized_key), std::size(serialized_key) };
+        }
+
+
+        // variables
+
+        const std::unique_ptr<trie_type> m_p_base;
+
+        trie_impl m_delta;
+
+        std::size_t m_size;
+
+        const key_serializer_type m_key_serializer;
+    };
+
+
+}
+
+
+#endif
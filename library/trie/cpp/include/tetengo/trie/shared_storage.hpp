@@ -12,6 +12,9 @@
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 #include <tetengo/trie/storage.hpp>
 
@@ -72,12 +75,38 @@ namespace tetengo::trie
 
         virtual void set_check_at_impl(std::size_t base_check_index, std::uint8_t check) override;
 
+        virtual void prefetch_base_check_at_impl(std::size_t base_check_index) const override;
+
+        virtual std::optional<base_check_array_view_type> base_check_array_view_impl() const override;
+
+        virtual bool has_preceding_key_counts_impl() const override;
+
+        virtual std::uint32_t preceding_key_count_at_impl(std::size_t base_check_index) const override;
+
+        virtual void
+        set_preceding_key_count_at_impl(std::size_t base_check_index, std::uint32_t preceding_key_count) override;
+
         virtual std::size_t value_count_impl() const override;
 
         virtual const std::any* value_at_impl(std::size_t value_index) const override;
 
+        virtual std::shared_ptr<const std::any> shared_value_at_impl(std::size_t value_index) const override;
+
+        virtual std::optional<value_array_view_type> value_array_view_impl() const override;
+
+        virtual std::optional<std::span<const char>> serialized_value_at_impl(std::size_t value_index) const override;
+
+        virtual std::optional<std::vector<char>>
+        serialize_value_at_impl(std::size_t value_index, const value_serializer& value_serializer_) const override;
+
         virtual void add_value_at_impl(std::size_t value_index, std::any value) override;
 
+        virtual void erase_value_at_impl(std::size_t value_index) override;
+
+        virtual std::size_t vacant_value_count_impl() const override;
+
+        virtual std::optional<std::size_t> vacant_value_index_impl() const override;
+
         virtual double filling_rate_impl() const override;
 
         virtual void
@@ -12,6 +12,10 @@
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <optional>
+#include <span>
+#include <typeinfo>
+#include <vector>
 
 #include <boost/core/noncopyable.hpp>
 
@@ -27,6 +31,51 @@ namespace tetengo::trie
     class storage : private boost::noncopyable
     {
     public:
+        // types
+
+        //! The base-check array view type.
+        struct base_check_array_view_type
+        {
+            //! The layout type.
+            enum class layout_type
+            {
+                narrow, //!< 32-bit words in the native byte order.
+                wide, //!< 64-bit words in the native byte order.
+                narrow_big_endian, //!< 32-bit words in the big endian.
+                wide_big_endian, //!< 64-bit words in the big endian.
+            };
+
+            //! The layout.
+            layout_type layout;
+
+            //! A pointer to the first element.
+            const void* p_head;
+
+            //! The element count.
+            std::size_t size;
+        };
+
+        //! The value array view type.
+        struct value_array_view_type
+        {
+            //! A pointer to the type of the value objects.
+            const std::type_info* p_value_type;
+
+            //! A pointer to the first value object.
+            const void* p_head;
+
+            //! The value object count.
+            std::size_t size;
+
+            /*!
+                \brief A pointer to the first presence flag.
+
+                The value object is absent when its presence flag is 0. nullptr when all the value objects are present.
+            */
+            const std::uint8_t* p_presences;
+        };
+
+
         // constructors and destructor
 
         /*!
@@ -83,6 +132,60 @@ namespace tetengo::trie
         */
         void set_check_at(std::size_t base_check_index, std::uint8_t check);
 
+        /*!
+            \brief Prefetches the base-check element.
+
+            It is just a hint. A storage which cannot prefetch ignores it.
+
+            \param base_check_index A base-check index.
+        */
+        void prefetch_base_check_at(std::size_t base_check_index) const;
+
+        /*!
+            \brief Returns the view of the base-check array.
+
+            A storage which has its base-check array in a contiguous memory region can expose it, so that the traversal
+            reads it directly without any virtual function call.
+            The view is valid until this storage is modified.
+
+            \return The view of the base-check array. Or std::nullopt when the storage does not expose it.
+        */
+        [[nodiscard]] std::optional<base_check_array_view_type> base_check_array_view() const;
+
+        /*!
+            \brief Returns true when this storage has the preceding key counts.
+
+            The preceding key count of a base-check element is the number of the keys under its siblings with smaller
+            labels. A double array built minimized numbers the keys by summing the preceding key counts on their paths,
+            instead of holding the values at the key terminators, so that the equivalent suffix subtrees are shared
+            even when their keys have distinct values.
+
+            \retval true  When this storage has the preceding key counts.
+            \retval false Otherwise.
+        */
+        [[nodiscard]] bool has_preceding_key_counts() const;
+
+        /*!
+            \brief Returns the preceding key count.
+
+            \param base_check_index A base-check index.
+
+            \return The preceding key count. Or 0 when this storage does not have the preceding key counts.
+        */
+        [[nodiscard]] std::uint32_t preceding_key_count_at(std::size_t base_check_index) const;
+
+        /*!
+            \brief Sets a preceding key count.
+
+            Once a preceding key count is set, this storage has the preceding key counts.
+
+            \param base_check_index    A base-check index.
+            \param preceding_key_count A preceding key count.
+
+            \throw std::logic_error When the storage cannot hold the preceding key counts.
+        */
+        void set_preceding_key_count_at(std::size_t base_check_index, std::uint32_t preceding_key_count);
+
         /*!
             \brief Returns the value count.
 
@@ -99,6 +202,57 @@ namespace tetengo::trie
         */
         [[nodiscard]] const std::any* value_at(std::size_t value_index) const;
 
+        /*!
+            \brief Returns the value object shared with the caller.
+
+            The value object is kept while the returned pointer is held, even when the storage evicts it from its value
+            cache. So it can be used while other threads read the storage.
+
+            \param value_index A value index.
+
+            \return A shared pointer to the value object. Or nullptr when there is no corresponding value object.
+        */
+        [[nodiscard]] std::shared_ptr<const std::any> shared_value_at(std::size_t value_index) const;
+
+        /*!
+            \brief Returns the view of the value array.
+
+            A storage which has its value objects in a contiguous array of a concrete type, not wrapped in std::any, can
+            expose it, so that the value objects are read without any type erasure.
+            The view is valid until this storage is modified.
+
+            \return The view of the value array. Or std::nullopt when the storage does not expose it.
+        */
+        [[nodiscard]] std::optional<value_array_view_type> value_array_view() const;
+
+        /*!
+            \brief Returns the serialized value object.
+
+            A storage which holds the serialized value objects in memory can expose them, so that a reader working on
+            raw bytes skips the deserialization and the copy.
+            The span is valid until this storage is modified or destroyed.
+
+            \param value_index A value index.
+
+            \return The serialized value object. Or std::nullopt when there is no corresponding value object or when the
+                    storage does not expose it.
+        */
+        [[nodiscard]] std::optional<std::span<const char>> serialized_value_at(std::size_t value_index) const;
+
+        /*!
+            \brief Serializes the value object.
+
+            A storage which has its value objects not wrapped in std::any serializes them without making the std::any
+            objects which value_at() keeps.
+
+            \param value_index       A value index.
+            \param value_serializer_ A serializer for value objects.
+
+            \return The serialized value object. Or std::nullopt when there is no corresponding value object.
+        */
+        [[nodiscard]] std::optional<std::vector<char>>
+        serialize_value_at(std::size_t value_index, const value_serializer& value_serializer_) const;
+
         /*!
             \brief Adds a value object.
 
@@ -107,6 +261,36 @@ namespace tetengo::trie
         */
         void add_value_at(std::size_t value_index, std::any value);
 
+        /*!
+            \brief Erases a value object.
+
+            The value count is not changed. The value index becomes vacant, and value_at() returns nullptr for it
+            until a value object is added at it again.
+
+            \param value_index A value index.
+
+            \throw std::logic_error When the storage cannot erase value objects.
+        */
+        void erase_value_at(std::size_t value_index);
+
+        /*!
+            \brief Returns the vacant value count.
+
+            A value index less than the value count is vacant when there is no value object at it. The vacant value
+            indices are serialized, so the count is the same in a storage deserialized from this storage.
+
+            \return The vacant value count.
+        */
+        [[nodiscard]] std::size_t vacant_value_count() const;
+
+        /*!
+            \brief Returns a vacant value index.
+
+            \return A vacant value index. Or std::nullopt when there is no vacant value index or when the storage does
+                    not reuse them.
+        */
+        [[nodiscard]] std::optional<std::size_t> vacant_value_index() const;
+
         /*!
             \brief Returns the filling rate.
 
@@ -119,9 +303,32 @@ namespace tetengo::trie
 
             \param output_stream     An output stream.
             \param value_serializer_ A serializer for value objects.
+
+            \throw std::length_error When the values serialized with an offset index exceed 4 GiB.
+            \throw std::logic_error  When this storage has the preceding key counts, which only the format version 2
+                                     can hold.
         */
         void serialize(std::ostream& output_stream, const value_serializer& value_serializer_) const;
 
+        /*!
+            \brief Serializes this storage in the format version 2.
+
+            The format version 2 starts with a header which has a magic number, the version and the offsets of the
+            sections, so that a reader validates it in O(1). The sections are aligned to 4096 bytes and consist of
+            little-endian words, so that mmap_storage on a little-endian machine reads the base-check array directly.
+            The values are serialized in a fixed size when value_serializer_ has a fixed value size, or with an offset
+            index otherwise. The values with an offset index are spooled in a temporary file, since the offset index
+            precedes them. The preceding key counts, if any, are serialized in a section after the base-check array.
+
+            memory_storage and mmap_storage can read both of the format versions.
+
+            \param output_stream     An output stream.
+            \param value_serializer_ A serializer for value objects.
+
+            \throw std::ios_base::failure When output_stream is bad or when the temporary file is not available.
+        */
+        void serialize_v2(std::ostream& output_stream, const value_serializer& value_serializer_) const;
+
         /*!
             \brief Clones this storage.
 
@@ -143,12 +350,37 @@ namespace tetengo::trie
 
         virtual void set_check_at_impl(std::size_t base_check_index, std::uint8_t check) = 0;
 
+        virtual void prefetch_base_check_at_impl(std::size_t base_check_index) const;
+
+        virtual std::optional<base_check_array_view_type> base_check_array_view_impl() const;
+
+        virtual bool has_preceding_key_counts_impl() const;
+
+        virtual std::uint32_t preceding_key_count_at_impl(std::size_t base_check_index) const;
+
+        virtual void set_preceding_key_count_at_impl(std::size_t base_check_index, std::uint32_t preceding_key_count);
+
         virtual std::size_t value_count_impl() const = 0;
 
         virtual const std::any* value_at_impl(std::size_t value_index) const = 0;
 
+        virtual std::shared_ptr<const std::any> shared_value_at_impl(std::size_t value_index) const;
+
+        virtual std::optional<value_array_view_type> value_array_view_impl() const;
+
+        virtual std::optional<std::span<const char>> serialized_value_at_impl(std::size_t value_index) const;
+
+        virtual std::optional<std::vector<char>>
+        serialize_value_at_impl(std::size_t value_index, const value_serializer& value_serializer_) const;
+
         virtual void add_value_at_impl(std::size_t value_index, std::any value) = 0;
 
+        virtual void erase_value_at_impl(std::size_t value_index);
+
+        virtual std::size_t vacant_value_count_impl() const;
+
+        virtual std::optional<std::size_t> vacant_value_index_impl() const;
+
         virtual double filling_rate_impl() const = 0;
 
         virtual void serialize_impl(std::ostream& output_stream, const value_serializer& value_serializer_) const = 0;
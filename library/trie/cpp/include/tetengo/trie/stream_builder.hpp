@@ -0,0 +1,145 @@
+/*! \file
+    \brief A stream builder.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(TETENGO_TRIE_STREAMBUILDER_HPP)
+#define TETENGO_TRIE_STREAMBUILDER_HPP
+
+#include <any>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+#include <boost/core/noncopyable.hpp>
+
+
+namespace tetengo::trie
+{
+    class value_serializer;
+
+
+    /*!
+        \brief A stream builder.
+
+        It builds a trie from the elements whose keys are added in ascending order, and writes it into an output stream
+        in the format which memory_storage and mmap_storage read.
+
+        Only the path to the last key and a window of the base-check array are kept in memory. The elements of the
+        base-check array before the window are written into the output stream, and the serialized values are buffered
+        in a temporary file until the base-check array is completed. So it can build a trie larger than the memory.
+        Only the offsets of the values are kept in memory when the value serializer is indexed.
+
+        The output stream must be seekable since the size of the base-check array is written at last.
+
+        Since the layout of the base-check array must be decided before it is written, a trie whose bases exceed 24
+        bits needs the wide layout to be specified on construction.
+    */
+    class stream_builder : private boost::noncopyable
+    {
+    public:
+        // static functions
+
+        /*!
+            \brief Returns the default window size.
+
+            \return The default window size.
+        */
+        [[nodiscard]] static std::size_t default_window_size();
+
+
+        // constructors and destructor
+
+        /*!
+            \brief Creates a stream builder.
+
+            \param output_stream     An output stream.
+            \param value_serializer_ A serializer for value objects.
+            \param window_size       A window size. It is the element count of the base-check array kept in memory.
+                                     Must be greater than 0.
+            \param wide              True to write the base-check array in the wide layout.
+
+            \throw std::invalid_argument When window_size is 0.
+            \throw std::ios_base::failure When output_stream is bad or the temporary file cannot be created.
+        */
+        stream_builder(
+            std::ostream&           output_stream,
+            const value_serializer& value_serializer_,
+            std::size_t             window_size = default_window_size(),
+            bool                    wide = false);
+
+        /*!
+            \brief Destroys the stream builder.
+
+            The trie written into the output stream is incomplete unless finish() has been called.
+        */
+        ~stream_builder();
+
+
+        // functions
+
+        /*!
+            \brief Adds an element.
+
+            \param key   A key. Must be greater than the keys already added.
+            \param value A value.
+
+            \throw std::invalid_argument When key is not greater than the last key.
+            \throw std::logic_error      When the building is already finished.
+            \throw std::length_error     When a base does not fit in the narrow layout, or the indexed values exceed
+                                         4 GiB.
+        */
+        void add(const std::string_view& key, const std::any& value);
+
+        /*!
+            \brief Adds elements.
+
+            \tparam InputIterator An input iterator type.
+
+            \param first An iterator to the first element.
+            \param last  An iterator to the last element.
+
+            \throw std::invalid_argument When a key is not greater than the previous one.
+            \throw std::logic_error      When the building is already finished.
+            \throw std::length_error     When a base does not fit in the narrow layout, or the indexed values exceed
+                                         4 GiB.
+        */
+        template <typename InputIterator>
+        void add(InputIterator first, InputIterator last)
+        {
+            for (; first != last; ++first)
+            {
+                add(first->first, std::any{ first->second });
+            }
+        }
+
+        /*!
+            \brief Finishes the building.
+
+            The rest of the base-check array and the values are written into the output stream.
+
+            \throw std::logic_error       When the building is already finished.
+            \throw std::length_error      When a base does not fit in the narrow layout.
+            \throw std::ios_base::failure When the output stream cannot be written.
+        */
+        void finish();
+
+
+    private:
+        // types
+
+        class impl;
+
+
+        // variables
+
+        const std::unique_ptr<impl> m_p_impl;
+    };
+
+
+}
+
+
+#endif
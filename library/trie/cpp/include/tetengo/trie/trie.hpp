@@ -14,15 +14,19 @@
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
 #include <boost/core/noncopyable.hpp>
 
 #include <tetengo/trie/default_serializer.hpp> // IWYU pragma: keep
+#include <tetengo/trie/storage.hpp>
 #include <tetengo/trie/trie_iterator.hpp>
 
 
@@ -32,7 +36,6 @@ namespace tetengo::trie
     class default_serializer; // IWYU pragma: keep
 
     class double_array;
-    class storage;
 
 
     /*!
@@ -60,6 +63,19 @@ namespace tetengo::trie
             std::function<void()> done;
         };
 
+        //! The fuzzy search element type.
+        struct fuzzy_search_element_type
+        {
+            //! The serialized key.
+            std::string key;
+
+            //! The edit distance from the searched key.
+            std::size_t distance;
+
+            //! The value index.
+            std::size_t value_index;
+        };
+
 
         // static functions
 
@@ -77,6 +93,13 @@ namespace tetengo::trie
         */
         [[nodiscard]] static std::size_t default_double_array_density_factor();
 
+        /*!
+            \brief Returns the default double array build thread count.
+
+            \return The default double array build thread count.
+        */
+        [[nodiscard]] static std::size_t default_double_array_build_thread_count();
+
 
         // constructors and destructor
 
@@ -88,26 +111,53 @@ namespace tetengo::trie
         /*!
             \brief Creates a trie.
 
-            \param elements                    Initial elements.
-            \param building_observer_set       A building observer set.
-            \param double_array_density_factor A double array density factor.
+            \param elements                        Initial elements.
+            \param building_observer_set           A building observer set.
+            \param double_array_density_factor     A double array density factor.
+            \param double_array_build_thread_count A double array build thread count.
+            \param double_array_minimized          True to build a minimized double array.
          */
         trie_impl(
             std::vector<std::pair<std::string_view, std::any>> elements,
             const building_observer_set_type&                  building_observer_set,
-            std::size_t                                        double_array_density_factor);
+            std::size_t                                        double_array_density_factor,
+            std::size_t                                        double_array_build_thread_count,
+            bool                                               double_array_minimized);
 
         /*!
             \brief Creates a trie.
 
-            \param elements                    Initial elements.
-            \param building_observer_set       A building observer set.
-            \param double_array_density_factor A double array density factor.
+            \param elements                        Initial elements.
+            \param building_observer_set           A building observer set.
+            \param double_array_density_factor     A double array density factor.
+            \param double_array_build_thread_count A double array build thread count.
+            \param double_array_minimized          True to build a minimized double array.
          */
         trie_impl(
             std::vector<std::pair<std::string, std::any>> elements,
             const building_observer_set_type&             building_observer_set,
-            std::size_t                                   double_array_density_factor);
+            std::size_t                                   double_array_density_factor,
+            std::size_t                                   double_array_build_thread_count,
+            bool                                          double_array_minimized);
+
+        /*!
+            \brief Creates a trie without any value object.
+
+            Only the base-check array is built, and no value object is added to the storage. All the keys have the
+            value index 0.
+
+            \param keys                            Initial keys.
+            \param building_observer_set           A building observer set.
+            \param double_array_density_factor     A double array density factor.
+            \param double_array_build_thread_count A double array build thread count.
+            \param double_array_minimized          True to build a minimized double array.
+         */
+        trie_impl(
+            std::vector<std::string_view>     keys,
+            const building_observer_set_type& building_observer_set,
+            std::size_t                       double_array_density_factor,
+            std::size_t                       double_array_build_thread_count,
+            bool                              double_array_minimized);
 
         /*!
             \brief Creates a trie.
@@ -172,6 +222,73 @@ namespace tetengo::trie
         */
         [[nodiscard]] const std::any* find(const std::string_view& key) const;
 
+        /*!
+            \brief Finds the value objects corresponding to the given keys.
+
+            The lookups of the keys are interleaved to hide the memory latency.
+
+            \param keys Keys.
+
+            \return The pointers to the value objects in the order of the keys. An element is nullptr when the trie
+                    does not have the corresponding key.
+        */
+        [[nodiscard]] std::vector<const std::any*> find_batch(const std::vector<std::string_view>& keys) const;
+
+        /*!
+            \brief Finds the index of the value object correspoinding the given key.
+
+            \param key A key.
+
+            \return The value index. Or std::nullopt when the trie does not have the given key.
+        */
+        [[nodiscard]] std::optional<std::size_t> find_value_index(const std::string_view& key) const;
+
+        /*!
+            \brief Finds the indices of the value objects corresponding to the given keys.
+
+            The lookups of the keys are interleaved to hide the memory latency.
+
+            \param keys Keys.
+
+            \return The value indices in the order of the keys. An element is std::nullopt when the trie does not have
+                    the corresponding key.
+        */
+        [[nodiscard]] std::vector<std::optional<std::size_t>>
+        find_batch_value_indices(const std::vector<std::string_view>& keys) const;
+
+        /*!
+            \brief Finds the value objects corresponding to the prefixes of the given key.
+
+            \param key A key.
+
+            \return The pairs of a prefix length and a pointer to the value object, in ascending order of the prefix
+                    length.
+        */
+        [[nodiscard]] std::vector<std::pair<std::size_t, const std::any*>>
+        common_prefix_search(const std::string_view& key) const;
+
+        /*!
+            \brief Finds the indices of the value objects corresponding to the prefixes of the given key.
+
+            \param key A key.
+
+            \return The pairs of a prefix length and a value index, in ascending order of the prefix length.
+        */
+        [[nodiscard]] std::vector<std::pair<std::size_t, std::size_t>>
+        common_prefix_search_value_indices(const std::string_view& key) const;
+
+        /*!
+            \brief Finds the indices of the value objects corresponding to the keys within the given edit distance of
+                   the given key.
+
+            \param key          A key.
+            \param max_distance A maximum edit distance.
+
+            \return The found elements in ascending order of the key. See double_array::fuzzy_search() for details.
+        */
+        [[nodiscard]] std::vector<fuzzy_search_element_type>
+        fuzzy_search_value_indices(const std::string_view& key, std::size_t max_distance) const;
+
         /*!
             \brief Returns the first iterator.
 
@@ -196,6 +313,41 @@ namespace tetengo::trie
         */
         [[nodiscard]] std::unique_ptr<trie_impl> subtrie(const std::string_view& key_prefix) const;
 
+        /*!
+            \brief Returns a storage in which the elements are relocated for the cache locality.
+
+            \param sample_keys Serialized sample keys, such as the ones in a query log. May be empty.
+
+            \return A unique pointer to a storage.
+        */
+        [[nodiscard]] std::unique_ptr<storage>
+        relocated_storage(const std::vector<std::string_view>& sample_keys) const;
+
+        /*!
+            \brief Inserts an element.
+
+            \param key   A key.
+            \param value A value object.
+
+            \retval true  When the element is inserted.
+            \retval false When the trie already has the key.
+
+            \throw std::logic_error When the storage cannot be updated.
+        */
+        bool insert(const std::string_view& key, std::any value);
+
+        /*!
+            \brief Erases an element.
+
+            \param key A key.
+
+            \retval true  When the element is erased.
+            \retval false When the trie does not have the key.
+
+            \throw std::logic_error When the storage cannot be updated.
+        */
+        bool erase(const std::string_view& key);
+
         /*!
             \brief Returns the storage.
 
@@ -219,6 +371,11 @@ namespace tetengo::trie
     /*!
         \brief A trie.
 
+        A trie built minimized shares the base-check elements among the equivalent suffix subtrees even though its keys
+        have distinct values, since the value indices are counted in ascending order of the keys instead of being held
+        at the key terminators. See double_array for details. Its storage can't be modified, and is serialized only in
+        the format version 2.
+
         \tparam Key           A key type.
         \tparam Value         A value type.
         \tparam KeySerializer A key serializer type.
@@ -244,6 +401,19 @@ namespace tetengo::trie
         //! The building observer set type.
         using building_observer_set_type = trie_impl::building_observer_set_type;
 
+        //! The fuzzy search element type.
+        struct fuzzy_search_element_type
+        {
+            //! The serialized key.
+            std::string key;
+
+            //! The edit distance from the searched key.
+            std::size_t distance;
+
+            //! A pointer to the value object.
+            const value_type* p_value;
+        };
+
 
         // static functions
 
@@ -267,6 +437,16 @@ namespace tetengo::trie
             return trie_impl::default_double_array_density_factor();
         }
 
+        /*!
+            \brief Returns the default double array build thread count.
+
+            \return The default double array build thread count.
+        */
+        [[nodiscard]] static std::size_t default_double_array_build_thread_count()
+        {
+            return trie_impl::default_double_array_build_thread_count();
+        }
+
 
         // constructors and destructor
 
@@ -283,19 +463,25 @@ namespace tetengo::trie
         /*!
             \brief Creates a trie.
 
-            \param elements                    Initial elements.
-            \param key_serializer              A key serializer.
-            \param building_observer_set       A building observer set.
-            \param double_array_density_factor A double array density factor.
+            \param elements                        Initial elements.
+            \param key_serializer                  A key serializer.
+            \param building_observer_set           A building observer set.
+            \param double_array_density_factor     A double array density factor.
+            \param double_array_build_thread_count A double array build thread count.
+            \param double_array_minimized          True to build a minimized double array.
         */
         explicit trie(
             std::initializer_list<std::pair<key_type, value_type>> elements,
             const key_serializer_type&        key_serializer = default_serializer<key_type, void>{ true },
             const building_observer_set_type& building_observer_set = null_building_observer_set(),
-            std::size_t                       double_array_density_factor = default_double_array_density_factor()) :
+            std::size_t                       double_array_density_factor = default_double_array_density_factor(),
+            std::size_t double_array_build_thread_count = default_double_array_build_thread_count(),
+            bool        double_array_minimized = false) :
         m_impl{ serialize_key<true>(std::begin(elements), std::end(elements), key_serializer),
                 building_observer_set,
-                double_array_density_factor },
+                double_array_density_factor,
+                double_array_build_thread_count,
+                double_array_minimized },
         m_key_serializer{ key_serializer }
         {}
 
@@ -304,11 +490,13 @@ namespace tetengo::trie
 
             \tparam InputIterator An input iterator type.
 
-            \param first                       An iterator to the first element.
-            \param last                        An iterator to the last element.
-            \param key_serializer              A key serializer.
-            \param building_observer_set       A building observer set.
-            \param double_array_density_factor A double array density factor.
+            \param first                           An iterator to the first element.
+            \param last                            An iterator to the last element.
+            \param key_serializer                  A key serializer.
+            \param building_observer_set           A building observer set.
+            \param double_array_density_factor     A double array density factor.
+            \param double_array_build_thread_count A double array build thread count.
+            \param double_array_minimized          True to build a minimized double array.
         */
         template <typename InputIterator>
         trie(
@@ -316,8 +504,14 @@ namespace tetengo::trie
             InputIterator                     last,
             const key_serializer_type&        key_serializer = default_serializer<key_type, void>{ true },
             const building_observer_set_type& building_observer_set = null_building_observer_set(),
-            std::size_t                       double_array_density_factor = default_double_array_density_factor()) :
-        m_impl{ serialize_key<false>(first, last, key_serializer), building_observer_set, double_array_density_factor },
+            std::size_t                       double_array_density_factor = default_double_array_density_factor(),
+            std::size_t double_array_build_thread_count = default_double_array_build_thread_count(),
+            bool        double_array_minimized = false) :
+        m_impl{ serialize_key<false>(first, last, key_serializer),
+                building_observer_set,
+                double_array_density_factor,
+                double_array_build_thread_count,
+                double_array_minimized },
         m_key_serializer{ key_serializer }
         {}
 
@@ -326,11 +520,13 @@ namespace tetengo::trie
 
             \tparam InputIterator An input iterator type.
 
-            \param first                       An iterator to the first element.
-            \param last                        An iterator to the last element.
-            \param key_serializer              A key serializer.
-            \param building_observer_set       A building observer set.
-            \param double_array_density_factor A double array density factor.
+            \param first                           An iterator to the first element.
+            \param last                            An iterator to the last element.
+            \param key_serializer                  A key serializer.
+            \param building_observer_set           A building observer set.
+            \param double_array_density_factor     A double array density factor.
+            \param double_array_build_thread_count A double array build thread count.
+            \param double_array_minimized          True to build a minimized double array.
         */
         template <typename InputIterator>
         trie(
@@ -338,8 +534,14 @@ namespace tetengo::trie
             std::move_iterator<InputIterator> last,
             const key_serializer_type&        key_serializer = default_serializer<key_type, void>{ true },
             const building_observer_set_type& building_observer_set = null_building_observer_set(),
-            std::size_t                       double_array_density_factor = default_double_array_density_factor()) :
-        m_impl{ serialize_key<true>(first, last, key_serializer), building_observer_set, double_array_density_factor },
+            std::size_t                       double_array_density_factor = default_double_array_density_factor(),
+            std::size_t double_array_build_thread_count = default_double_array_build_thread_count(),
+            bool        double_array_minimized = false) :
+        m_impl{ serialize_key<true>(first, last, key_serializer),
+                building_observer_set,
+                double_array_density_factor,
+                double_array_build_thread_count,
+                double_array_minimized },
         m_key_serializer{ key_serializer }
         {}
 
@@ -407,25 +609,213 @@ namespace tetengo::trie
             \param key A key.
 
             \return A pointer to the value object. Or nullptr when the trie does not have the given key.
+
+            \throw std::logic_error When the storage only lends the value objects by shared_value_at(), as mmap_storage
+                                    with a concurrent value cache. Use find_shared() then.
         */
         [[nodiscard]] const value_type* find(const key_type& key) const
         {
-            const auto* const p_found = [this, &key]() {
-                if constexpr (std::is_same_v<key_type, std::string_view> || std::is_same_v<key_type, std::string>)
+            const auto& serialized_key = m_key_serializer(key);
+            if (const auto o_view = typed_value_array_view(); o_view)
+            {
+                return typed_value_at(*o_view, m_impl.find_value_index(to_string_view(serialized_key)));
+            }
+
+            const auto* const p_found = m_impl.find(to_string_view(serialized_key));
+            if (!p_found)
+            {
+                return nullptr;
+            }
+            return std::any_cast<value_type>(p_found);
+        }
+
+        /*!
+            \brief Finds the value object correspoinding the given key, shared with the caller.
+
+            The value object is kept while the returned pointer is held, even when the storage evicts it under
+            concurrent reads.
+
+            \param key A key.
+
+            \return A shared pointer to the value object. Or nullptr when the trie does not have the given key.
+        */
+        [[nodiscard]] std::shared_ptr<const value_type> find_shared(const key_type& key) const
+        {
+            const auto& serialized_key = m_key_serializer(key);
+            const auto  o_value_index = m_impl.find_value_index(to_string_view(serialized_key));
+            if (!o_value_index)
+            {
+                return nullptr;
+            }
+            if (const auto o_view = typed_value_array_view(); o_view)
+            {
+                const auto* const p_value = typed_value_at(*o_view, o_value_index);
+                return p_value ? std::shared_ptr<const value_type>{ std::shared_ptr<const value_type>{}, p_value } :
+                                 nullptr;
+            }
+
+            auto p_found = m_impl.get_storage().shared_value_at(*o_value_index);
+            if (!p_found)
+            {
+                return nullptr;
+            }
+            const auto* const p_value = std::any_cast<value_type>(p_found.get());
+            return std::shared_ptr<const value_type>{ std::move(p_found), p_value };
+        }
+
+        /*!
+            \brief Finds the serialized value object correspoinding the given key.
+
+            The value object is neither deserialized nor copied. It is available only when the storage exposes the
+            serialized value objects, as mmap_storage does.
+
+            \param key A key.
+
+            \return The serialized value object in the storage. Or std::nullopt when the trie does not have the given
+                    key, or when the storage does not expose it.
+        */
+        [[nodiscard]] std::optional<std::span<const char>> find_serialized(const key_type& key) const
+        {
+            const auto& serialized_key = m_key_serializer(key);
+            const auto  o_value_index = m_impl.find_value_index(to_string_view(serialized_key));
+            if (!o_value_index)
+            {
+                return std::nullopt;
+            }
+            return m_impl.get_storage().serialized_value_at(*o_value_index);
+        }
+
+        /*!
+            \brief Finds the value objects corresponding to the given keys.
+
+            The lookups of the keys are interleaved to hide the memory latency.
+
+            \param keys Keys.
+
+            \return The pointers to the value objects in the order of the keys. An element is nullptr when the trie
+                    does not have the corresponding key.
+        */
+        [[nodiscard]] std::vector<const value_type*> find_batch(const std::vector<key_type>& keys) const
+        {
+            const auto o_view = typed_value_array_view();
+            const auto find_batch_ = [this, &o_view](const std::vector<std::string_view>& serialized_keys) {
+                std::vector<const value_type*> casted{};
+                casted.reserve(std::size(serialized_keys));
+                if (o_view)
                 {
-                    return m_impl.find(m_key_serializer(key));
+                    const auto found = m_impl.find_batch_value_indices(serialized_keys);
+                    std::transform(
+                        std::begin(found),
+                        std::end(found),
+                        std::back_inserter(casted),
+                        [&o_view](const auto& o_index) { return typed_value_at(*o_view, o_index); });
                 }
                 else
                 {
-                    const auto serialized_key = m_key_serializer(key);
-                    return m_impl.find(std::string_view{ std::data(serialized_key), std::size(serialized_key) });
+                    const auto found = m_impl.find_batch(serialized_keys);
+                    std::transform(
+                        std::begin(found), std::end(found), std::back_inserter(casted), [](const auto* p_found) {
+                            return p_found ? std::any_cast<value_type>(p_found) : nullptr;
+                        });
                 }
-            }();
-            if (!p_found)
+                return casted;
+            };
+
+            using serialized_key_type = std::invoke_result_t<const key_serializer_type&, const key_type&>;
+            if constexpr (std::is_reference_v<serialized_key_type>)
             {
-                return nullptr;
+                std::vector<std::string_view> serialized_keys{};
+                serialized_keys.reserve(std::size(keys));
+                std::transform(
+                    std::begin(keys),
+                    std::end(keys),
+                    std::back_inserter(serialized_keys),
+                    [this](const auto& key) { return to_string_view(m_key_serializer(key)); });
+                return find_batch_(serialized_keys);
             }
-            return std::any_cast<value_type>(p_found);
+            else
+            {
+                std::vector<serialized_key_type> serialized_keys{};
+                serialized_keys.reserve(std::size(keys));
+                std::transform(
+                    std::begin(keys),
+                    std::end(keys),
+                    std::back_inserter(serialized_keys),
+                    [this](const auto& key) { return m_key_serializer(key); });
+                std::vector<std::string_view> serialized_key_views{};
+                serialized_key_views.reserve(std::size(serialized_keys));
+                std::transform(
+                    std::begin(serialized_keys),
+                    std::end(serialized_keys),
+                    std::back_inserter(serialized_key_views),
+                    [](const auto& serialized_key) { return to_string_view(serialized_key); });
+                return find_batch_(serialized_key_views);
+            }
+        }
+
+        /*!
+            \brief Finds the value objects corresponding to the prefixes of the given key.
+
+            The prefix lengths are counted in the serialized key.
+
+            \param key A key.
+
+            \return The pairs of a prefix length and a pointer to the value object, in ascending order of the prefix
+                    length.
+        */
+        [[nodiscard]] std::vector<std::pair<std::size_t, const value_type*>>
+        common_prefix_search(const key_type& key) const
+        {
+            const auto& serialized_key = m_key_serializer(key);
+            std::vector<std::pair<std::size_t, const value_type*>> casted{};
+            if (const auto o_view = typed_value_array_view(); o_view)
+            {
+                const auto found = m_impl.common_prefix_search_value_indices(to_string_view(serialized_key));
+                casted.reserve(std::size(found));
+                std::transform(
+                    std::begin(found), std::end(found), std::back_inserter(casted), [&o_view](const auto& e) {
+                        return std::make_pair(e.first, typed_value_at(*o_view, std::make_optional(e.second)));
+                    });
+            }
+            else
+            {
+                const auto found = m_impl.common_prefix_search(to_string_view(serialized_key));
+                casted.reserve(std::size(found));
+                std::transform(std::begin(found), std::end(found), std::back_inserter(casted), [](const auto& e) {
+                    return std::make_pair(e.first, std::any_cast<value_type>(e.second));
+                });
+            }
+            return casted;
+        }
+
+        /*!
+            \brief Finds the value objects corresponding to the keys within the given edit distance of the given key.
+
+            The edit distance is the Levenshtein distance counted in the bytes of the serialized keys. Only the nodes
+            near the given key are visited. See double_array::fuzzy_search() for details.
+
+            \param key          A key.
+            \param max_distance A maximum edit distance.
+
+            \return The found elements in ascending order of the serialized key.
+        */
+        [[nodiscard]] std::vector<fuzzy_search_element_type>
+        fuzzy_search(const key_type& key, const std::size_t max_distance) const
+        {
+            const auto& serialized_key = m_key_serializer(key);
+            auto        found = m_impl.fuzzy_search_value_indices(to_string_view(serialized_key), max_distance);
+
+            const auto                             o_view = typed_value_array_view();
+            std::vector<fuzzy_search_element_type> casted{};
+            casted.reserve(std::size(found));
+            for (auto& e: found)
+            {
+                const auto* const p_value =
+                    o_view ? typed_value_at(*o_view, std::make_optional(e.value_index)) :
+                             std::any_cast<value_type>(m_impl.get_storage().value_at(e.value_index));
+                casted.push_back({ std::move(e.key), e.distance, p_value });
+            }
+            return casted;
         }
 
         /*!
@@ -478,6 +868,85 @@ namespace tetengo::trie
             return p_trie;
         }
 
+        /*!
+            \brief Returns a storage in which the elements are relocated for the cache locality.
+
+            A trie created with the storage finds the same value objects with fewer cache misses. See
+            double_array::relocated_storage() for details.
+
+            \param sample_keys Sample keys, such as the ones in a query log. May be empty.
+
+            \return A unique pointer to a storage.
+        */
+        [[nodiscard]] std::unique_ptr<storage>
+        relocated_storage(const std::vector<key_type>& sample_keys = std::vector<key_type>{}) const
+        {
+            std::vector<std::string> serialized_sample_keys{};
+            serialized_sample_keys.reserve(std::size(sample_keys));
+            for (const auto& sample_key: sample_keys)
+            {
+                const auto& serialized_sample_key = m_key_serializer(sample_key);
+                serialized_sample_keys.emplace_back(std::data(serialized_sample_key), std::size(serialized_sample_key));
+            }
+            return m_impl.relocated_storage(
+                std::vector<std::string_view>{ std::begin(serialized_sample_keys), std::end(serialized_sample_keys) });
+        }
+
+        /*!
+            \brief Inserts an element.
+
+            Only the elements on the path of the key are modified, and the trie is not rebuilt. The storage must be
+            writable, such as memory_storage.
+
+            \param key   A key.
+            \param value A value.
+
+            \retval true  When the element is inserted.
+            \retval false When the trie already has the key. The value is not modified.
+
+            \throw std::logic_error When the storage cannot be updated.
+        */
+        bool insert(const key_type& key, value_type value)
+        {
+            if constexpr (std::is_same_v<key_type, std::string_view> || std::is_same_v<key_type, std::string>)
+            {
+                return m_impl.insert(m_key_serializer(key), std::any{ std::move(value) });
+            }
+            else
+            {
+                const auto serialized_key = m_key_serializer(key);
+                return m_impl.insert(
+                    std::string_view{ std::data(serialized_key), std::size(serialized_key) },
+                    std::any{ std::move(value) });
+            }
+        }
+
+        /*!
+            \brief Erases an element.
+
+            The value object of the erased element is erased from the storage, and its value index is reused by a later
+            insertion. The storage must be writable, such as memory_storage.
+
+            \param key A key.
+
+            \retval true  When the element is erased.
+            \retval false When the trie does not have the key.
+
+            \throw std::logic_error When the storage cannot be updated.
+        */
+        bool erase(const key_type& key)
+        {
+            if constexpr (std::is_same_v<key_type, std::string_view> || std::is_same_v<key_type, std::string>)
+            {
+                return m_impl.erase(m_key_serializer(key));
+            }
+            else
+            {
+                const auto serialized_key = m_key_serializer(key);
+                return m_impl.erase(std::string_view{ std::data(serialized_key), std::size(serialized_key) });
+            }
+        }
+
         /*!
             \brief Returns the storage.
 
@@ -499,6 +968,23 @@ namespace tetengo::trie
 
         // static functions
 
+        template <typename SerializedKey>
+        static std::string_view to_string_view(const SerializedKey& serialized_key)
+        {
+            return std::string_view{ std::data(serialized_key), std::size(serialized_key) };
+        }
+
+        static const value_type*
+        typed_value_at(const storage::value_array_view_type& view, const std::optional<std::size_t>& o_value_index)
+        {
+            if (!o_value_index || *o_value_index >= view.size ||
+                (view.p_presences && !view.p_presences[*o_value_index]))
+            {
+                return nullptr;
+            }
+            return static_cast<const value_type*>(view.p_head) + *o_value_index;
+        }
+
         template <bool MoveValue, typename InputIterator>
         static std::vector<serialized_element_type>
         serialize_key(InputIterator first, InputIterator last, const key_serializer_type& key_serializer)
@@ -542,7 +1028,7 @@ namespace tetengo::trie
 
         // variables
 
-        const trie_impl m_impl;
+        trie_impl m_impl;
 
         const key_serializer_type m_key_serializer;
 
@@ -553,6 +1039,19 @@ namespace tetengo::trie
         m_impl{ std::move(*p_impl) },
         m_key_serializer{ ker_serializer }
         {}
+
+
+        // functions
+
+        std::optional<storage::value_array_view_type> typed_value_array_view() const
+        {
+            auto o_view = m_impl.get_storage().value_array_view();
+            if (!o_view || *o_view->p_value_type != typeid(value_type))
+            {
+                return std::nullopt;
+            }
+            return o_view;
+        }
     };
 
 
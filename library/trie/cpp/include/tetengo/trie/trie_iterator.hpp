@@ -8,18 +8,22 @@
 #define TETENGO_TRIE_TRIEITERATOR_HPP
 
 #include <any>
+#include <cstddef>
 #include <iterator>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <typeinfo>
 #include <utility>
 
 #include <boost/stl_interfaces/iterator_interface.hpp>
 
 #include <tetengo/trie/double_array_iterator.hpp>
+#include <tetengo/trie/storage.hpp>
 
 
 namespace tetengo::trie
 {
-    class storage;
-
 
     /*!
         \brief An implementation of trie iterator.
@@ -63,6 +67,31 @@ namespace tetengo::trie
         */
         [[nodiscard]] std::any& operator*();
 
+        /*!
+            \brief Returns the key.
+
+            \return The serialized key.
+        */
+        [[nodiscard]] std::string_view key() const;
+
+        /*!
+            \brief Returns the index of the value object.
+
+            \return The value index.
+        */
+        [[nodiscard]] std::size_t value_index() const;
+
+        /*!
+            \brief Returns the view of the value array when it holds the value objects of the given type.
+
+            \param value_type A value type.
+
+            \return A pointer to the view of the value array. Or nullptr when the storage does not expose it, or when it
+                    does not hold the value objects of the given type.
+        */
+        [[nodiscard]] const storage::value_array_view_type*
+        typed_value_array_view(const std::type_info& value_type) const;
+
         /*!
             \brief Returns true when one iterator is equal to another.
 
@@ -88,6 +117,15 @@ namespace tetengo::trie
         double_array_iterator m_double_array_iterator;
 
         storage* m_p_storage;
+
+        std::optional<storage::value_array_view_type> m_o_value_array_view;
+
+        mutable std::shared_ptr<const std::any> m_p_value;
+
+
+        // functions
+
+        const std::any& value() const;
     };
 
 
@@ -126,7 +164,7 @@ namespace tetengo::trie
         */
         [[nodiscard]] const value_type& operator*() const
         {
-            return *std::any_cast<value_type>(&*m_impl);
+            return *operator->();
         }
 
         /*!
@@ -136,7 +174,7 @@ namespace tetengo::trie
         */
         [[nodiscard]] value_type& operator*()
         {
-            return *std::any_cast<value_type>(&*m_impl);
+            return *operator->();
         }
 
         /*!
@@ -146,6 +184,10 @@ namespace tetengo::trie
         */
         [[nodiscard]] const value_type* operator->() const
         {
+            if (m_impl.typed_value_array_view(typeid(value_type)))
+            {
+                return typed_value();
+            }
             return std::any_cast<value_type>(&*m_impl);
         }
 
@@ -156,9 +198,28 @@ namespace tetengo::trie
         */
         [[nodiscard]] value_type* operator->()
         {
+            if (m_impl.typed_value_array_view(typeid(value_type)))
+            {
+                return const_cast<value_type*>(typed_value());
+            }
             return std::any_cast<value_type>(&*m_impl);
         }
 
+        /*!
+            \brief Returns the key.
+
+            The key is the serialized one relative to the root of the trie, and is obtained with the value in the same
+            traversal. It is valid until the iterator is incremented or destroyed.
+
+            \return The serialized key.
+
+            \throw std::logic_error When the iterator is not dereferenceable.
+        */
+        [[nodiscard]] std::string_view key() const
+        {
+            return m_impl.key();
+        }
+
         /*!
             \brief Returns true when one iterator is equal to another.
 
@@ -201,6 +262,20 @@ namespace tetengo::trie
         // variables
 
         trie_iterator_impl m_impl;
+
+
+        // functions
+
+        const value_type* typed_value() const
+        {
+            const auto* const p_view = m_impl.typed_value_array_view(typeid(value_type));
+            const auto        value_index = m_impl.value_index();
+            if (value_index >= p_view->size || (p_view->p_presences && !p_view->p_presences[value_index]))
+            {
+                return nullptr;
+            }
+            return static_cast<const value_type*>(p_view->p_head) + value_index;
+        }
     };
 
 
@@ -0,0 +1,450 @@
+/*! \file
+    \brief A trie set.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(TETENGO_TRIE_TRIESET_HPP)
+#define TETENGO_TRIE_TRIESET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+#include <boost/stl_interfaces/iterator_interface.hpp>
+
+#include <tetengo/trie/default_serializer.hpp> // IWYU pragma: keep
+#include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/trie.hpp>
+#include <tetengo/trie/trie_iterator.hpp>
+
+
+namespace tetengo::trie
+{
+    /*!
+        \brief A trie set iterator.
+
+        It yields the serialized keys relative to the root of the trie set.
+    */
+    class trie_set_iterator :
+    public boost::stl_interfaces::
+        iterator_interface<trie_set_iterator, std::forward_iterator_tag, std::string_view, std::string_view>
+    {
+    public:
+        // constructors and destructor
+
+        /*!
+            \brief Creates an iterator.
+
+            \param impl An implementation of trie iterator.
+        */
+        trie_set_iterator(trie_iterator_impl&& impl) : m_impl{ std::move(impl) } {}
+
+
+        // functions
+
+        /*!
+            \brief Dereferences the iterator.
+
+            The key is valid until the iterator is incremented or destroyed.
+
+            \return The serialized key.
+
+            \throw std::logic_error When the iterator is not dereferenceable.
+        */
+        [[nodiscard]] std::string_view operator*() const
+        {
+            return m_impl.key();
+        }
+
+        /*!
+            \brief Returns true when one iterator is equal to another.
+
+            \param one   One iterator.
+            \param another Another iterator.
+
+            \retval true  When one is equal to another.
+            \retval false Otherwise.
+        */
+        friend bool operator==(const trie_set_iterator& one, const trie_set_iterator& another)
+        {
+            return one.m_impl == another.m_impl;
+        }
+
+        /*!
+            \brief Increments the iterator.
+
+            \return This iterator.
+        */
+        trie_set_iterator& operator++()
+        {
+            ++m_impl;
+            return *this;
+        }
+
+        /*!
+            \brief Postincrements the iterator.
+
+            \return The iterator before the incrementation.
+        */
+        trie_set_iterator operator++(int)
+        {
+            trie_set_iterator original{ *this };
+            ++(*this);
+            return original;
+        }
+
+
+    private:
+        // variables
+
+        trie_iterator_impl m_impl;
+    };
+
+
+    /*!
+        \brief A trie set.
+
+        It holds only the keys. No value object is stored, and its storage has no value object. So it is smaller than
+        a trie both in the memory and in the serialized form.
+
+        A trie set built minimized shares the base-check elements among the equivalent suffix subtrees, which have the
+        same labels in the same structure. Since all the keys have the same value index, its double array is a minimal
+        acyclic automaton of the keys. It is stored in the same format as the others, and needs no special reader. But
+        its storage can't be modified by a double array. A minimized trie set is always built by a single thread though
+        the keys are sorted by double_array_build_thread_count threads.
+
+        Unlike a minimized trie, whose value indices are counted, a minimized trie set holds the value index 0 at the
+        key terminators. So its storage can be serialized in both of the format versions.
+
+        \tparam Key           A key type.
+        \tparam KeySerializer A key serializer type.
+    */
+    template <typename Key, typename KeySerializer = default_serializer<Key, void>>
+    class trie_set : private boost::noncopyable
+    {
+    public:
+        // types
+
+        //! The key type.
+        using key_type = Key;
+
+        //! The key serializer_type.
+        using key_serializer_type = KeySerializer;
+
+        //! The iterator type.
+        using iterator = trie_set_iterator;
+
+        //! The building observer set type.
+        using building_observer_set_type = trie_impl::building_observer_set_type;
+
+
+        // static functions
+
+        /*!
+            \brief Returns the null building observer set.
+
+            \return The null bulding observer set.
+        */
+        [[nodiscard]] static const building_observer_set_type& null_building_observer_set()
+        {
+            return trie_impl::null_building_observer_set();
+        }
+
+        /*!
+            \brief Returns the default double array density factor.
+
+            \return The default double array density factor.
+        */
+        [[nodiscard]] static std::size_t default_double_array_density_factor()
+        {
+            return trie_impl::default_double_array_density_factor();
+        }
+
+        /*!
+            \brief Returns the default double array build thread count.
+
+            \return The default double array build thread count.
+        */
+        [[nodiscard]] static std::size_t default_double_array_build_thread_count()
+        {
+            return trie_impl::default_double_array_build_thread_count();
+        }
+
+
+        // constructors and destructor
+
+        /*!
+            \brief Creates a trie set.
+
+            \param key_serializer A key serializer.
+        */
+        explicit trie_set(const key_serializer_type& key_serializer = default_serializer<key_type, void>{ true }) :
+        m_impl{},
+        m_key_serializer{ key_serializer }
+        {}
+
+        /*!
+            \brief Creates a trie set.
+
+            \param keys                            Initial keys.
+            \param key_serializer                  A key serializer.
+            \param building_observer_set           A building observer set.
+            \param double_array_density_factor     A double array density factor.
+            \param double_array_build_thread_count A double array build thread count.
+            \param double_array_minimized          True to build a minimized double array.
+        */
+        explicit trie_set(
+            std::initializer_list<key_type>   keys,
+            const key_serializer_type&        key_serializer = default_serializer<key_type, void>{ true },
+            const building_observer_set_type& building_observer_set = null_building_observer_set(),
+            std::size_t                       double_array_density_factor = default_double_array_density_factor(),
+            std::size_t double_array_build_thread_count = default_double_array_build_thread_count(),
+            bool        double_array_minimized = false) :
+        m_impl{ build(
+            std::begin(keys),
+            std::end(keys),
+            key_serializer,
+            building_observer_set,
+            double_array_density_factor,
+            double_array_build_thread_count,
+            double_array_minimized) },
+        m_key_serializer{ key_serializer }
+        {}
+
+        /*!
+            \brief Creates a trie set.
+
+            \tparam InputIterator An input iterator type.
+
+            \param first                           An iterator to the first key.
+            \param last                            An iterator to the last key.
+            \param key_serializer                  A key serializer.
+            \param building_observer_set           A building observer set.
+            \param double_array_density_factor     A double array density factor.
+            \param double_array_build_thread_count A double array build thread count.
+            \param double_array_minimized          True to build a minimized double array.
+        */
+        template <typename InputIterator>
+        trie_set(
+            InputIterator                     first,
+            InputIterator                     last,
+            const key_serializer_type&        key_serializer = default_serializer<key_type, void>{ true },
+            const building_observer_set_type& building_observer_set = null_building_observer_set(),
+            std::size_t                       double_array_density_factor = default_double_array_density_factor(),
+            std::size_t double_array_build_thread_count = default_double_array_build_thread_count(),
+            bool        double_array_minimized = false) :
+        m_impl{ build(
+            first,
+            last,
+            key_serializer,
+            building_observer_set,
+            double_array_density_factor,
+            double_array_build_thread_count,
+            double_array_minimized) },
+        m_key_serializer{ key_serializer }
+        {}
+
+        /*!
+            \brief Creates a trie set.
+
+            \param p_storage      A unique pointer to a storage.
+            \param key_serializer A key serializer.
+        */
+        explicit trie_set(
+            std::unique_ptr<storage>&& p_storage,
+            const key_serializer_type& key_serializer = default_serializer<key_type, void>{ true }) :
+        m_impl{ std::move(p_storage) },
+        m_key_serializer{ key_serializer }
+        {}
+
+
+        // functions
+
+        /*!
+            \brief Returns true when the trie set is empty.
+
+            \retval true  When the trie set is empty.
+            \retval false Otherwise.
+        */
+        [[nodiscard]] bool empty() const
+        {
+            return begin() == end();
+        }
+
+        /*!
+            \brief Returns the size of the trie set.
+
+            Since the key count is not stored, the keys are counted by a traversal.
+
+            \return The size.
+        */
+        [[nodiscard]] std::size_t size() const
+        {
+            return static_cast<std::size_t>(std::distance(begin(), end()));
+        }
+
+        /*!
+            \brief Returns true when the trie set contains the given key.
+
+            \param key A key.
+
+            \retval true  When the trie set contains the given key.
+            \retval false Otherwise.
+        */
+        [[nodiscard]] bool contains(const key_type& key) const
+        {
+            const auto& serialized_key = m_key_serializer(key);
+            return m_impl.contains(to_string_view(serialized_key));
+        }
+
+        /*!
+            \brief Finds the keys which are the prefixes of the given key.
+
+            The prefix lengths are counted in the serialized key.
+
+            \param key A key.
+
+            \return The prefix lengths in ascending order.
+        */
+        [[nodiscard]] std::vector<std::size_t> common_prefix_search(const key_type& key) const
+        {
+            const auto& serialized_key = m_key_serializer(key);
+            const auto  found = m_impl.common_prefix_search_value_indices(to_string_view(serialized_key));
+
+            std::vector<std::size_t> prefix_lengths{};
+            prefix_lengths.reserve(std::size(found));
+            std::transform(std::begin(found), std::end(found), std::back_inserter(prefix_lengths), [](const auto& e) {
+                return e.first;
+            });
+            return prefix_lengths;
+        }
+
+        /*!
+            \brief Returns the first iterator.
+
+            \return The first iterator.
+        */
+        [[nodiscard]] iterator begin() const
+        {
+            return iterator{ std::begin(m_impl) };
+        }
+
+        /*!
+            \brief Returns the last iterator.
+
+            \return The last iterator.
+        */
+        [[nodiscard]] iterator end() const
+        {
+            return iterator{ std::end(m_impl) };
+        }
+
+        /*!
+            \brief Returns a subtrie set.
+
+            The keys of the subtrie set are the ones following the key prefix.
+
+            \param key_prefix A key prefix.
+
+            \return A unique pointer to a subtrie set.
+                    Or nullptr when the trie set does not have the given key prefix.
+        */
+        [[nodiscard]] std::unique_ptr<trie_set> subtrie(const key_type& key_prefix) const
+        {
+            const auto& serialized_key_prefix = m_key_serializer(key_prefix);
+            auto        p_trie_impl = m_impl.subtrie(to_string_view(serialized_key_prefix));
+            if (!p_trie_impl)
+            {
+                return nullptr;
+            }
+            std::unique_ptr<trie_set> p_trie_set{ new trie_set{ std::move(p_trie_impl), m_key_serializer } };
+            return p_trie_set;
+        }
+
+        /*!
+            \brief Returns the storage.
+
+            \return The storage.
+        */
+        [[nodiscard]] const storage& get_storage() const
+        {
+            return m_impl.get_storage();
+        }
+
+
+    private:
+        // types
+
+        using serialized_key_type =
+            std::conditional_t<std::is_same_v<key_type, std::string_view>, std::string_view, std::string>;
+
+
+        // static functions
+
+        template <typename SerializedKey>
+        static std::string_view to_string_view(const SerializedKey& serialized_key)
+        {
+            return std::string_view{ std::data(serialized_key), std::size(serialized_key) };
+        }
+
+        template <typename InputIterator>
+        static trie_impl build(
+            InputIterator                     first,
+            InputIterator                     last,
+            const key_serializer_type&        key_serializer,
+            const building_observer_set_type& building_observer_set,
+            const std::size_t                 double_array_density_factor,
+            const std::size_t                 double_array_build_thread_count,
+            const bool                        double_array_minimized)
+        {
+            std::vector<serialized_key_type> serialized_keys{};
+            std::transform(first, last, std::back_inserter(serialized_keys), [&key_serializer](const auto& key) {
+                const auto& serialized_key = key_serializer(key);
+                return serialized_key_type{ std::data(serialized_key), std::size(serialized_key) };
+            });
+
+            std::vector<std::string_view> serialized_key_views{};
+            serialized_key_views.reserve(std::size(serialized_keys));
+            std::transform(
+                std::begin(serialized_keys),
+                std::end(serialized_keys),
+                std::back_inserter(serialized_key_views),
+                [](const auto& serialized_key) { return to_string_view(serialized_key); });
+
+            return trie_impl{ std::move(serialized_key_views),
+                              building_observer_set,
+                              double_array_density_factor,
+                              double_array_build_thread_count,
+                              double_array_minimized };
+        }
+
+
+        // variables
+
+        const trie_impl m_impl;
+
+        const key_serializer_type m_key_serializer;
+
+
+        // constructors
+
+        trie_set(std::unique_ptr<trie_impl>&& p_impl, const key_serializer_type& key_serializer) :
+        m_impl{ std::move(*p_impl) },
+        m_key_serializer{ key_serializer }
+        {}
+    };
+
+
+}
+
+
+#endif
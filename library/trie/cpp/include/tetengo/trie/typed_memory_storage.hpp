@@ -0,0 +1,321 @@
+/*! \file
+    \brief A typed memory storage.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(TETENGO_TRIE_TYPEDMEMORYSTORAGE_HPP)
+#define TETENGO_TRIE_TYPEDMEMORYSTORAGE_HPP
+
+#include <algorithm>
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <tetengo/trie/memory_storage.hpp>
+#include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/value_serializer.hpp>
+
+
+namespace tetengo::trie
+{
+    /*!
+        \brief A typed memory storage.
+
+        The value objects are held in a contiguous array of the value type, not wrapped in std::any, and are exposed
+        by value_array_view(). So a trie with this storage finds the value objects without any type erasure.
+
+        value_at() returns a std::any copy of the value object made on the first access to it. It is only for the
+        compatibility with the other storages. The copy is made under a lock, so value_at() can be called by multiple
+        threads at the same time. The returned pointer is valid until the storage is destroyed, and the value object it
+        points to is updated when the value object in the array is replaced.
+
+        The serialized form is the same as the one of memory_storage.
+
+        \tparam Value A value type. It must be default constructible and copy constructible.
+    */
+    template <typename Value>
+    class typed_memory_storage : public memory_storage
+    {
+    public:
+        // types
+
+        //! The value type.
+        using value_type = Value;
+
+        static_assert(std::is_default_constructible_v<value_type>);
+        static_assert(std::is_copy_constructible_v<value_type>);
+        static_assert(!std::is_same_v<value_type, bool>, "std::vector<bool> cannot expose its elements.");
+
+
+        // constructors and destructor
+
+        /*!
+            \brief Creates a typed memory storage.
+        */
+        typed_memory_storage() :
+        memory_storage{},
+        m_values{},
+        m_presences{},
+        m_vacant_value_indices{},
+        m_any_value_mutex{},
+        m_p_any_values{}
+        {}
+
+        /*!
+            \brief Creates a typed memory storage.
+
+            The base-check array, the preceding key counts and the value objects are copied from another storage.
+
+            \param storage_ A storage.
+
+            \throw std::bad_any_cast When a value object in the storage is not of the value type.
+        */
+        explicit typed_memory_storage(const storage& storage_) :
+        memory_storage{},
+        m_values{},
+        m_presences{},
+        m_vacant_value_indices{},
+        m_any_value_mutex{},
+        m_p_any_values{}
+        {
+            copy_base_check_array(storage_);
+            copy_values(storage_);
+        }
+
+        /*!
+            \brief Creates a typed memory storage.
+
+            \param input_stream        An input stream.
+            \param value_deserializer_ A deserializer for value objects.
+
+            \throw std::ios_base::failure When the input stream is broken.
+            \throw std::bad_any_cast      When a deserialized value object is not of the value type.
+        */
+        typed_memory_storage(std::istream& input_stream, const value_deserializer& value_deserializer_) :
+        memory_storage{ input_stream },
+        m_values{},
+        m_presences{},
+        m_vacant_value_indices{},
+        m_any_value_mutex{},
+        m_p_any_values{}
+        {
+            deserialize_values(input_stream, value_deserializer_);
+        }
+
+        /*!
+            \brief Destroys the typed memory storage.
+        */
+        virtual ~typed_memory_storage() = default;
+
+
+    private:
+        // variables
+
+        std::vector<value_type> m_values;
+
+        std::vector<std::uint8_t> m_presences;
+
+        std::vector<std::size_t> m_vacant_value_indices;
+
+        mutable std::mutex m_any_value_mutex;
+
+        mutable std::vector<std::unique_ptr<std::any>> m_p_any_values;
+
+
+        // virtual functions
+
+        virtual std::size_t value_count_impl() const override
+        {
+            return std::size(m_values);
+        }
+
+        virtual const std::any* value_at_impl(const std::size_t value_index) const override
+        {
+            if (value_index >= std::size(m_values) || !m_presences[value_index])
+            {
+                return nullptr;
+            }
+
+            const std::lock_guard lock{ m_any_value_mutex };
+            if (std::size(m_p_any_values) < std::size(m_values))
+            {
+                m_p_any_values.resize(std::size(m_values));
+            }
+            auto& p_any_value = m_p_any_values[value_index];
+            if (!p_any_value)
+            {
+                p_any_value = std::make_unique<std::any>(m_values[value_index]);
+            }
+            return p_any_value.get();
+        }
+
+        virtual std::optional<value_array_view_type> value_array_view_impl() const override
+        {
+            return std::make_optional(value_array_view_type{
+                &typeid(value_type), std::data(m_values), std::size(m_values), std::data(m_presences) });
+        }
+
+        virtual std::optional<std::vector<char>>
+        serialize_value_at_impl(const std::size_t value_index, const value_serializer& value_serializer_) const override
+        {
+            if (value_index >= std::size(m_values) || !m_presences[value_index])
+            {
+                return std::nullopt;
+            }
+            return std::make_optional(value_serializer_(std::any{ m_values[value_index] }));
+        }
+
+        virtual void add_value_at_impl(const std::size_t value_index, std::any value) override
+        {
+            set_value_at(value_index, std::any_cast<value_type>(std::move(value)));
+        }
+
+        virtual void erase_value_at_impl(const std::size_t value_index) override
+        {
+            if (value_index >= std::size(m_values) || !m_presences[value_index])
+            {
+                return;
+            }
+            m_values[value_index] = value_type{};
+            m_presences[value_index] = 0;
+            m_vacant_value_indices.push_back(value_index);
+        }
+
+        virtual std::size_t vacant_value_count_impl() const override
+        {
+            return std::size(m_vacant_value_indices);
+        }
+
+        virtual std::optional<std::size_t> vacant_value_index_impl() const override
+        {
+            return std::empty(m_vacant_value_indices) ? std::nullopt :
+                                                        std::make_optional(m_vacant_value_indices.back());
+        }
+
+        virtual void
+        serialize_impl(std::ostream& output_stream, const value_serializer& value_serializer_) const override
+        {
+            serialize_base_check_array(output_stream);
+            serialize_value_array(
+                output_stream,
+                value_serializer_,
+                std::size(m_values),
+                [this, &value_serializer_](const std::size_t value_index) {
+                    return serialize_value_at_impl(value_index, value_serializer_);
+                });
+        }
+
+        virtual std::unique_ptr<storage> clone_impl() const override
+        {
+            return std::make_unique<typed_memory_storage>(static_cast<const storage&>(*this));
+        }
+
+
+        // functions
+
+        void copy_base_check_array(const storage& storage_)
+        {
+            for (auto i = static_cast<std::size_t>(0); i < storage_.base_check_size(); ++i)
+            {
+                set_base_at(i, storage_.base_at(i));
+                set_check_at(i, storage_.check_at(i));
+                if (storage_.has_preceding_key_counts())
+                {
+                    set_preceding_key_count_at(i, storage_.preceding_key_count_at(i));
+                }
+            }
+        }
+
+        void copy_values(const storage& storage_)
+        {
+            if (const auto* const p_typed = dynamic_cast<const typed_memory_storage*>(&storage_); p_typed)
+            {
+                m_values = p_typed->m_values;
+                m_presences = p_typed->m_presences;
+                m_vacant_value_indices = p_typed->m_vacant_value_indices;
+                return;
+            }
+
+            const auto value_count = storage_.value_count();
+            m_values.reserve(value_count);
+            m_presences.reserve(value_count);
+            for (auto i = static_cast<std::size_t>(0); i < value_count; ++i)
+            {
+                if (const auto* const p_value = storage_.value_at(i); p_value)
+                {
+                    m_values.push_back(std::any_cast<value_type>(*p_value));
+                    m_presences.push_back(1);
+                }
+                else
+                {
+                    m_vacant_value_indices.push_back(std::size(m_values));
+                    m_values.emplace_back();
+                    m_presences.push_back(0);
+                }
+            }
+        }
+
+        void deserialize_values(std::istream& input_stream, const value_deserializer& value_deserializer_)
+        {
+            deserialize_value_array(
+                input_stream,
+                [this](const std::size_t value_count) {
+                    m_values.reserve(value_count);
+                    m_presences.reserve(value_count);
+                },
+                [this, &value_deserializer_](const std::vector<char>* const p_serialized) {
+                    if (p_serialized)
+                    {
+                        m_values.push_back(std::any_cast<value_type>(value_deserializer_(*p_serialized)));
+                        m_presences.push_back(1);
+                    }
+                    else
+                    {
+                        m_vacant_value_indices.push_back(std::size(m_values));
+                        m_values.emplace_back();
+                        m_presences.push_back(0);
+                    }
+                });
+        }
+
+        void set_value_at(const std::size_t value_index, value_type value)
+        {
+            if (value_index >= std::size(m_values))
+            {
+                for (auto i = std::size(m_values); i < value_index; ++i)
+                {
+                    m_vacant_value_indices.push_back(i);
+                }
+                m_values.resize(value_index + 1);
+                m_presences.resize(value_index + 1, 0);
+            }
+            else if (!m_presences[value_index])
+            {
+                m_vacant_value_indices.erase(
+                    std::find(std::begin(m_vacant_value_indices), std::end(m_vacant_value_indices), value_index));
+            }
+            m_values[value_index] = std::move(value);
+            m_presences[value_index] = 1;
+            if (value_index < std::size(m_p_any_values) && m_p_any_values[value_index])
+            {
+                *m_p_any_values[value_index] = m_values[value_index];
+            }
+        }
+    };
+
+
+}
+
+
+#endif
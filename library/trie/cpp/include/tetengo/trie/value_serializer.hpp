@@ -28,8 +28,13 @@ namespace tetengo::trie
 
             \param serialize        A serializing function.
             \param fixed_value_size The value size if it is fixed. Or 0 if the size is variable.
+            \param indexed          True to serialize the variable size values with an offset index.
+                                    Ignored when fixed_value_size is not 0.
         */
-        value_serializer(std::function<std::vector<char>(const std::any&)> serialize, std::size_t fixed_value_size);
+        value_serializer(
+            std::function<std::vector<char>(const std::any&)> serialize,
+            std::size_t                                       fixed_value_size,
+            bool                                              indexed = false);
 
 
         // functions
@@ -51,6 +56,16 @@ namespace tetengo::trie
         */
         std::size_t fixed_value_size() const;
 
+        /*!
+            \brief Returns true when the variable size values are serialized with an offset index.
+
+            The values serialized with an offset index can be read directly by mmap_storage.
+
+            \retval true  When the variable size values are serialized with an offset index.
+            \retval false Otherwise, or the value size is fixed.
+        */
+        bool indexed() const;
+
 
     private:
         // variables
@@ -58,6 +73,8 @@ namespace tetengo::trie
         std::function<std::vector<char>(const std::any&)> m_serialize;
 
         std::size_t m_fixed_value_size;
+
+        bool m_indexed;
     };
 
 
@@ -0,0 +1,396 @@
+/*! \file
+    \brief An Aho-Corasick automaton.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include <tetengo/trie/aho_corasick.hpp>
+#include <tetengo/trie/double_array.hpp>
+#include <tetengo/trie/storage.hpp>
+
+#include "tetengo.trie.base_check_accessor.hpp"
+#include "tetengo.trie.storage_format.hpp"
+
+
+namespace tetengo::trie
+{
+    /*
+        The links are serialized as below. All the words are little-endian.
+
+            offset          size  content
+                 0             8  the base-check element count of the double array
+                 8             8  the root base-check index of the double array
+                16             8  the checksum of the base-check array of the double array
+                24  12 * (count)  the failure link, the output link and the depth of each element as 32-bit words
+
+        A link to no element is 0xFFFFFFFF. The checksum is the 64-bit FNV-1a hash of the base as a little-endian
+        32-bit word and the check as a byte of each element.
+    */
+    class aho_corasick::impl : private boost::noncopyable
+    {
+    public:
+        // types
+
+        using match_callback_type = aho_corasick::match_callback_type;
+
+
+        // constructors and destructor
+
+        explicit impl(const double_array& double_array_) :
+        m_double_array{ double_array_ },
+        m_root_base_check_index{ double_array_.root_base_check_index() },
+        m_links{}
+        {
+            if (m_double_array.get_storage().has_preceding_key_counts())
+            {
+                throw std::invalid_argument{ "A double array whose values are counted is not supported." };
+            }
+            with_base_check_accessor(m_double_array.get_storage(), [this](const auto& accessor) {
+                build_links(accessor);
+            });
+        }
+
+        impl(const double_array& double_array_, std::istream& input_stream) :
+        m_double_array{ double_array_ },
+        m_root_base_check_index{ double_array_.root_base_check_index() },
+        m_links{}
+        {
+            deserialize(input_stream);
+        }
+
+
+        // functions
+
+        void scan(const std::string_view& text, const match_callback_type& callback) const
+        {
+            with_base_check_accessor(m_double_array.get_storage(), [this, &text, &callback](const auto& accessor) {
+                scan_with(accessor, text, m_root_base_check_index, 0, callback);
+            });
+        }
+
+        void scan(std::istream& input_stream, const match_callback_type& callback) const
+        {
+            with_base_check_accessor(
+                m_double_array.get_storage(), [this, &input_stream, &callback](const auto& accessor) {
+                    std::vector<char> block(block_size());
+                    auto              state = m_root_base_check_index;
+                    auto              offset = static_cast<std::size_t>(0);
+                    while (input_stream)
+                    {
+                        input_stream.read(std::data(block), std::size(block));
+                        const auto read_size = static_cast<std::size_t>(input_stream.gcount());
+                        state = scan_with(
+                            accessor, std::string_view{ std::data(block), read_size }, state, offset, callback);
+                        offset += read_size;
+                    }
+                });
+        }
+
+        void serialize(std::ostream& output_stream) const
+        {
+            std::vector<char> serialized(header_size() + link_size() * std::size(m_links));
+            store_little_endian<std::uint64_t>(std::size(m_links), std::data(serialized));
+            store_little_endian<std::uint64_t>(m_root_base_check_index, std::data(serialized) + 8);
+            store_little_endian<std::uint64_t>(base_check_checksum(), std::data(serialized) + 16);
+            auto* p_link = std::data(serialized) + header_size();
+            for (const auto& link: m_links)
+            {
+                store_little_endian<std::uint32_t>(static_cast<std::uint32_t>(link.failure), p_link);
+                store_little_endian<std::uint32_t>(static_cast<std::uint32_t>(link.output), p_link + 4);
+                store_little_endian<std::uint32_t>(static_cast<std::uint32_t>(link.depth), p_link + 8);
+                p_link += link_size();
+            }
+            output_stream.write(std::data(serialized), std::size(serialized));
+        }
+
+
+    private:
+        // types
+
+        struct link_type
+        {
+            // The element of the longest proper suffix of the path which is also a path.
+            std::int32_t failure;
+
+            // The element of the longest key which is a suffix of the path.
+            std::int32_t output;
+
+            std::int32_t depth;
+        };
+
+
+        // static functions
+
+        static std::size_t block_size()
+        {
+            return 65536;
+        }
+
+        static std::size_t header_size()
+        {
+            return 24;
+        }
+
+        static std::size_t link_size()
+        {
+            return 12;
+        }
+
+        template <typename Accessor>
+        static std::optional<std::size_t>
+        child_index(const Accessor& accessor, const std::size_t base_check_index, const std::uint8_t char_code)
+        {
+            if (char_code == static_cast<std::uint8_t>(double_array::key_terminator()) ||
+                char_code == double_array::vacant_check_value())
+            {
+                return std::nullopt;
+            }
+            const auto index = static_cast<std::int64_t>(accessor.base_at(base_check_index)) + char_code;
+            if (index < 0 || index >= static_cast<std::int64_t>(accessor.size()) ||
+                accessor.check_at(static_cast<std::size_t>(index)) != char_code)
+            {
+                return std::nullopt;
+            }
+            return std::make_optional(static_cast<std::size_t>(index));
+        }
+
+        template <typename Accessor>
+        static std::optional<std::size_t> terminator_index(const Accessor& accessor, const std::size_t base_check_index)
+        {
+            const auto index = static_cast<std::int64_t>(accessor.base_at(base_check_index));
+            if (index < 0 || index >= static_cast<std::int64_t>(accessor.size()) ||
+                accessor.check_at(static_cast<std::size_t>(index)) !=
+                    static_cast<std::uint8_t>(double_array::key_terminator()))
+            {
+                return std::nullopt;
+            }
+            return std::make_optional(static_cast<std::size_t>(index));
+        }
+
+
+        // variables
+
+        const double_array& m_double_array;
+
+        const std::size_t m_root_base_check_index;
+
+        std::vector<link_type> m_links;
+
+
+        // functions
+
+        template <typename Accessor>
+        void build_links(const Accessor& accessor)
+        {
+            m_links.assign(accessor.size(), link_type{ -1, -1, -1 });
+            if (m_root_base_check_index >= accessor.size())
+            {
+                return;
+            }
+            m_links[m_root_base_check_index].depth = 0;
+
+            std::vector<std::size_t> queue{ m_root_base_check_index };
+            for (auto head = static_cast<std::size_t>(0); head < std::size(queue); ++head)
+            {
+                const auto parent = queue[head];
+                const auto base = static_cast<std::int64_t>(accessor.base_at(parent));
+                const auto first = std::max<std::int64_t>(1, -base);
+                const auto last = std::min<std::int64_t>(
+                    double_array::vacant_check_value(), static_cast<std::int64_t>(accessor.size()) - base);
+                for (auto char_code = first; char_code < last; ++char_code)
+                {
+                    const auto child = static_cast<std::size_t>(base + char_code);
+                    if (accessor.check_at(child) != char_code)
+                    {
+                        continue;
+                    }
+                    auto& child_link = m_links[child];
+                    if (child_link.depth >= 0)
+                    {
+                        throw std::invalid_argument{
+                            "A double array sharing its elements among nodes is not supported."
+                        };
+                    }
+                    child_link.depth = m_links[parent].depth + 1;
+
+                    auto failure = m_root_base_check_index;
+                    for (auto suffix = parent; suffix != m_root_base_check_index;)
+                    {
+                        suffix = static_cast<std::size_t>(m_links[suffix].failure);
+                        if (const auto o_next = child_index(accessor, suffix, static_cast<std::uint8_t>(char_code));
+                            o_next)
+                        {
+                            failure = *o_next;
+                            break;
+                        }
+                    }
+                    child_link.failure = static_cast<std::int32_t>(failure);
+                    child_link.output =
+                        terminator_index(accessor, child) ? static_cast<std::int32_t>(child) : m_links[failure].output;
+
+                    queue.push_back(child);
+                }
+            }
+        }
+
+        template <typename Accessor>
+        std::size_t scan_with(
+            const Accessor&            accessor,
+            const std::string_view&    text,
+            std::size_t                state,
+            const std::size_t          offset,
+            const match_callback_type& callback) const
+        {
+            if (m_root_base_check_index >= accessor.size())
+            {
+                return state;
+            }
+
+            for (auto i = static_cast<std::size_t>(0); i < std::size(text); ++i)
+            {
+                const auto char_code = static_cast<std::uint8_t>(text[i]);
+                for (;;)
+                {
+                    if (const auto o_next = child_index(accessor, state, char_code); o_next)
+                    {
+                        state = *o_next;
+                        break;
+                    }
+                    if (state == m_root_base_check_index || m_links[state].failure < 0)
+                    {
+                        state = m_root_base_check_index;
+                        break;
+                    }
+                    state = static_cast<std::size_t>(m_links[state].failure);
+                }
+
+                for (auto output = m_links[state].output; output >= 0;)
+                {
+                    const auto& output_link = m_links[static_cast<std::size_t>(output)];
+                    if (const auto o_terminator_index =
+                            terminator_index(accessor, static_cast<std::size_t>(output));
+                        o_terminator_index)
+                    {
+                        const auto length = static_cast<std::size_t>(output_link.depth);
+                        callback(offset + i + 1 - length, length, accessor.base_at(*o_terminator_index));
+                    }
+                    output = output_link.failure >= 0 ? m_links[static_cast<std::size_t>(output_link.failure)].output :
+                                                        -1;
+                }
+            }
+            return state;
+        }
+
+        void deserialize(std::istream& input_stream)
+        {
+            char header[24]{};
+            input_stream.read(header, header_size());
+            if (input_stream.gcount() < static_cast<std::streamsize>(header_size()))
+            {
+                throw std::ios_base::failure{ "Can't read the links." };
+            }
+            const auto element_count = load_little_endian<std::uint64_t>(header);
+            const auto root_base_check_index = load_little_endian<std::uint64_t>(header + 8);
+            const auto checksum = load_little_endian<std::uint64_t>(header + 16);
+            if (element_count != m_double_array.get_storage().base_check_size() ||
+                root_base_check_index != m_root_base_check_index || checksum != base_check_checksum())
+            {
+                throw std::ios_base::failure{ "The links are not for the double array." };
+            }
+
+            std::vector<char> serialized(link_size() * static_cast<std::size_t>(element_count));
+            input_stream.read(std::data(serialized), std::size(serialized));
+            if (input_stream.gcount() < static_cast<std::streamsize>(std::size(serialized)))
+            {
+                throw std::ios_base::failure{ "Can't read the links." };
+            }
+            m_links.reserve(static_cast<std::size_t>(element_count));
+            for (auto i = static_cast<std::size_t>(0); i < static_cast<std::size_t>(element_count); ++i)
+            {
+                const auto* const p_link = std::data(serialized) + link_size() * i;
+                m_links.push_back({ static_cast<std::int32_t>(load_little_endian<std::uint32_t>(p_link)),
+                                    static_cast<std::int32_t>(load_little_endian<std::uint32_t>(p_link + 4)),
+                                    static_cast<std::int32_t>(load_little_endian<std::uint32_t>(p_link + 8)) });
+            }
+            validate_links();
+        }
+
+        std::uint64_t base_check_checksum() const
+        {
+            return with_base_check_accessor(m_double_array.get_storage(), [](const auto& accessor) {
+                auto       checksum = static_cast<std::uint64_t>(0xCBF29CE484222325);
+                const auto hash = [&checksum](const std::uint8_t byte) {
+                    checksum = (checksum ^ byte) * static_cast<std::uint64_t>(0x00000100000001B3);
+                };
+                for (auto i = static_cast<std::size_t>(0); i < accessor.size(); ++i)
+                {
+                    const auto base = static_cast<std::uint32_t>(accessor.base_at(i));
+                    hash(static_cast<std::uint8_t>(base));
+                    hash(static_cast<std::uint8_t>(base >> 8));
+                    hash(static_cast<std::uint8_t>(base >> 16));
+                    hash(static_cast<std::uint8_t>(base >> 24));
+                    hash(accessor.check_at(i));
+                }
+                return checksum;
+            });
+        }
+
+        // The depths must decrease along the links so that the scanning never loops.
+        void validate_links() const
+        {
+            const auto in_range = [this](const std::int32_t index) {
+                return index >= -1 && index < static_cast<std::int64_t>(std::size(m_links));
+            };
+            for (const auto& link: m_links)
+            {
+                if (!in_range(link.failure) || !in_range(link.output) ||
+                    (link.failure >= 0 && m_links[static_cast<std::size_t>(link.failure)].depth >= link.depth) ||
+                    (link.output >= 0 && m_links[static_cast<std::size_t>(link.output)].depth > link.depth))
+                {
+                    throw std::ios_base::failure{ "Broken links." };
+                }
+            }
+        }
+    };
+
+
+    aho_corasick::aho_corasick(const double_array& double_array_) : m_p_impl{ std::make_unique<impl>(double_array_) }
+    {}
+
+    aho_corasick::aho_corasick(const double_array& double_array_, std::istream& input_stream) :
+    m_p_impl{ std::make_unique<impl>(double_array_, input_stream) }
+    {}
+
+    aho_corasick::~aho_corasick() = default;
+
+    void aho_corasick::scan(const std::string_view& text, const match_callback_type& callback) const
+    {
+        m_p_impl->scan(text, callback);
+    }
+
+    void aho_corasick::scan(std::istream& input_stream, const match_callback_type& callback) const
+    {
+        m_p_impl->scan(input_stream, callback);
+    }
+
+    void aho_corasick::serialize(std::ostream& output_stream) const
+    {
+        m_p_impl->serialize(output_stream);
+    }
+
+
+}
@@ -0,0 +1,218 @@
+/*! \file
+    \brief A base-check accessor.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#if !defined(TETENGO_TRIE_BASECHECKACCESSOR_HPP)
+#define TETENGO_TRIE_BASECHECKACCESSOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <tetengo/trie/double_array.hpp>
+#include <tetengo/trie/storage.hpp>
+
+#include "tetengo.trie.base_check_layout.hpp"
+#include "tetengo.trie.prefetch.hpp"
+
+
+namespace tetengo::trie
+{
+    /*
+        The accessors give the traversal kernels a common way to read a base-check array. The kernels are templated on
+        them, so that the reading of a base-check array exposed by a storage is inlined into the kernels.
+
+        The preceding key counts are read through the storage only when it has them. Otherwise they are 0, so that the
+        value of a key is the sum of the preceding key counts on its path and the base of its key terminator either way.
+    */
+
+    template <typename Word, bool BigEndian>
+    class base_check_array_accessor
+    {
+    public:
+        // constructors
+
+        base_check_array_accessor(const storage& storage_, const void* const p_head, const std::size_t size) :
+        m_p_head{ static_cast<const unsigned char*>(p_head) },
+        m_size{ size },
+        m_p_counted_storage{ storage_.has_preceding_key_counts() ? &storage_ : nullptr }
+        {}
+
+
+        // functions
+
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+        std::int32_t base_at(const std::size_t base_check_index) const
+        {
+            if constexpr (sizeof(Word) == sizeof(std::uint64_t))
+            {
+                return wide_base_of(word_at(base_check_index));
+            }
+            else
+            {
+                return narrow_base_of(word_at(base_check_index));
+            }
+        }
+
+        std::uint8_t check_at(const std::size_t base_check_index) const
+        {
+            return static_cast<std::uint8_t>(word_at(base_check_index) & 0xFF);
+        }
+
+        std::uint32_t preceding_key_count_at(const std::size_t base_check_index) const
+        {
+            return m_p_counted_storage ? m_p_counted_storage->preceding_key_count_at(base_check_index) : 0;
+        }
+
+        void prefetch_at(const std::size_t base_check_index) const
+        {
+            if (base_check_index < m_size)
+            {
+                prefetch(m_p_head + sizeof(Word) * base_check_index);
+            }
+        }
+
+
+    private:
+        // variables
+
+        const unsigned char* m_p_head;
+
+        std::size_t m_size;
+
+        const storage* m_p_counted_storage;
+
+
+        // functions
+
+        Word word_at(const std::size_t base_check_index) const
+        {
+            const auto* const p_bytes = m_p_head + sizeof(Word) * base_check_index;
+            if constexpr (BigEndian)
+            {
+                auto word = static_cast<Word>(0);
+                for (auto i = static_cast<std::size_t>(0); i < sizeof(Word); ++i)
+                {
+                    word = static_cast<Word>(word << 8) | p_bytes[i];
+                }
+                return word;
+            }
+            else
+            {
+                return *reinterpret_cast<const Word*>(p_bytes);
+            }
+        }
+    };
+
+    class storage_accessor
+    {
+    public:
+        // constructors
+
+        explicit storage_accessor(const storage& storage_) :
+        m_storage{ storage_ },
+        m_counted{ storage_.has_preceding_key_counts() }
+        {}
+
+
+        // functions
+
+        std::size_t size() const
+        {
+            return m_storage.base_check_size();
+        }
+
+        std::int32_t base_at(const std::size_t base_check_index) const
+        {
+            return m_storage.base_at(base_check_index);
+        }
+
+        std::uint8_t check_at(const std::size_t base_check_index) const
+        {
+            return m_storage.check_at(base_check_index);
+        }
+
+        std::uint32_t preceding_key_count_at(const std::size_t base_check_index) const
+        {
+            return m_counted ? m_storage.preceding_key_count_at(base_check_index) : 0;
+        }
+
+        void prefetch_at(const std::size_t base_check_index) const
+        {
+            m_storage.prefetch_base_check_at(base_check_index);
+        }
+
+
+    private:
+        // variables
+
+        const storage& m_storage;
+
+        bool m_counted;
+    };
+
+    template <typename Function>
+    decltype(auto) with_base_check_accessor(const storage& storage_, Function&& function)
+    {
+        using layout_type = storage::base_check_array_view_type::layout_type;
+
+        if (const auto o_view = storage_.base_check_array_view(); o_view)
+        {
+            switch (o_view->layout)
+            {
+            case layout_type::narrow:
+                return function(
+                    base_check_array_accessor<std::uint32_t, false>{ storage_, o_view->p_head, o_view->size });
+            case layout_type::wide:
+                return function(
+                    base_check_array_accessor<std::uint64_t, false>{ storage_, o_view->p_head, o_view->size });
+            case layout_type::narrow_big_endian:
+                return function(
+                    base_check_array_accessor<std::uint32_t, true>{ storage_, o_view->p_head, o_view->size });
+            case layout_type::wide_big_endian:
+                return function(
+                    base_check_array_accessor<std::uint64_t, true>{ storage_, o_view->p_head, o_view->size });
+            default:
+                break;
+            }
+        }
+        return function(storage_accessor{ storage_ });
+    }
+
+    /*
+        The children of a node are the elements in the child range from its base whose check values equal their offsets
+        from the base. They are enumerated by reading the check values of the range through an accessor, so that no
+        side table is needed and a modification of the storage is seen at once.
+    */
+    template <typename Accessor>
+    std::uint8_t
+    next_child_char_code(const Accessor& accessor, const std::int32_t base, const std::int32_t first_char_code)
+    {
+        const auto vacant = static_cast<std::int64_t>(double_array::vacant_check_value());
+        const auto first = std::max<std::int64_t>(first_char_code, -static_cast<std::int64_t>(base));
+        const auto last = std::min<std::int64_t>(vacant, static_cast<std::int64_t>(accessor.size()) - base);
+        for (auto char_code = first; char_code < last; ++char_code)
+        {
+            if (accessor.check_at(static_cast<std::size_t>(base + char_code)) == char_code)
+            {
+                return static_cast<std::uint8_t>(char_code);
+            }
+        }
+        return static_cast<std::uint8_t>(vacant);
+    }
+
+
+}
+
+
+#endif
+
+#endif
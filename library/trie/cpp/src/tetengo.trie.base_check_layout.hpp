@@ -0,0 +1,62 @@
+/*! \file
+    \brief A base-check layout.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#if !defined(TETENGO_TRIE_BASECHECKLAYOUT_HPP)
+#define TETENGO_TRIE_BASECHECKLAYOUT_HPP
+
+#include <cstdint>
+
+
+namespace tetengo::trie
+{
+    /*
+        The narrow layout packs a base-check element into a 32-bit word as (base << 8) | check, so that a base is
+        limited to 24 bits. The wide layout uses a 64-bit word in the same manner, so that a base can use all the
+        32 bits.
+
+        A serialized wide base-check array starts with wide_base_check_marker() followed by the element count. Since
+        the element count of a narrow one is always less than it, the layouts are distinguished by the first word.
+    */
+
+    inline constexpr std::uint32_t wide_base_check_marker()
+    {
+        return 0xFFFFFFFF;
+    }
+
+    inline constexpr bool fits_narrow_base(const std::int32_t base)
+    {
+        return -0x00800000 <= base && base <= 0x007FFFFF;
+    }
+
+    inline constexpr std::uint32_t narrow_base_check_of(const std::int32_t base, const std::uint8_t check)
+    {
+        return (static_cast<std::uint32_t>(base) << 8) | check;
+    }
+
+    inline constexpr std::int32_t narrow_base_of(const std::uint32_t base_check)
+    {
+        return static_cast<std::int32_t>(base_check) >> 8;
+    }
+
+    inline constexpr std::uint64_t wide_base_check_of(const std::int32_t base, const std::uint8_t check)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(base)) << 8) | check;
+    }
+
+    inline constexpr std::int32_t wide_base_of(const std::uint64_t base_check)
+    {
+        return static_cast<std::int32_t>(static_cast<std::uint32_t>(base_check >> 8));
+    }
+
+
+}
+
+
+#endif
+
+#endif
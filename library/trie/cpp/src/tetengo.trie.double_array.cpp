@@ -4,12 +4,17 @@
     Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
 */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <numeric>
 #include <optional>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits> // IWYU pragma: keep
@@ -20,7 +25,9 @@
 #include <tetengo/trie/double_array_iterator.hpp>
 #include <tetengo/trie/storage.hpp>
 
+#include "tetengo.trie.base_check_accessor.hpp"
 #include "tetengo.trie.double_array_builder.hpp"
+#include "tetengo.trie.double_array_updater.hpp"
 
 
 namespace tetengo::trie
@@ -32,6 +39,22 @@ namespace tetengo::trie
 
         using building_observer_set_type = double_array::building_observer_set_type;
 
+        using fuzzy_search_element_type = double_array::fuzzy_search_element_type;
+
+        // The double arrays sharing a storage, such as the subtries, share one updater. A modification may move the
+        // root of a subtrie, so a subtrie finds its root again from the whole root by its key prefix when the
+        // modification count has changed since it last did.
+        struct shared_state_type
+        {
+            std::unique_ptr<storage> p_storage;
+
+            std::size_t root_base_check_index;
+
+            std::unique_ptr<double_array_updater> p_updater;
+
+            std::size_t modification_count;
+        };
+
 
         // static functions
 
@@ -47,6 +70,11 @@ namespace tetengo::trie
             return double_array_builder::default_density_factor();
         }
 
+        static std::size_t default_build_thread_count()
+        {
+            return double_array_builder::default_build_thread_count();
+        }
+
         static constexpr char key_terminator()
         {
             return '\0';
@@ -61,33 +89,68 @@ namespace tetengo::trie
         // constructors and destructor
 
         impl() :
-        m_p_storage{ double_array_builder::build(
+        m_p_shared_state{ make_shared_state(double_array_builder::build(
             std::vector<std::pair<std::string_view, std::int32_t>>{},
             null_building_observer_set(),
-            default_density_factor()) },
-        m_root_base_check_index{ 0 }
+            default_density_factor(),
+            default_build_thread_count(),
+            double_array_builder::minimization_type::none)) },
+        m_key_prefix{},
+        m_root_value_offset{ 0 },
+        m_root_base_check_index{ 0 },
+        m_root_modification_count{ 0 }
         {}
 
         impl(
             const std::vector<std::pair<std::string_view, std::int32_t>>& elements,
             const building_observer_set_type&                             building_observer_set,
-            const std::size_t                                             density_factor) :
-        m_p_storage{ double_array_builder::build(elements, building_observer_set, density_factor) },
-        m_root_base_check_index{ 0 }
+            const std::size_t                                             density_factor,
+            const std::size_t                                             build_thread_count,
+            const bool                                                    minimized) :
+        m_p_shared_state{ make_shared_state(double_array_builder::build(
+            elements,
+            building_observer_set,
+            density_factor,
+            build_thread_count,
+            minimized ? double_array_builder::minimization_type::counted_values :
+                        double_array_builder::minimization_type::none)) },
+        m_key_prefix{},
+        m_root_value_offset{ 0 },
+        m_root_base_check_index{ 0 },
+        m_root_modification_count{ 0 }
         {}
 
         impl(
             const std::vector<std::pair<std::string, std::int32_t>>& elements,
             const building_observer_set_type&                        building_observer_set,
-            const std::size_t                                        density_factor) :
+            const std::size_t                                        density_factor,
+            const std::size_t                                        build_thread_count,
+            const bool                                               minimized) :
         impl{ std::vector<std::pair<std::string_view, std::int32_t>>{ std::begin(elements), std::end(elements) },
               building_observer_set,
-              density_factor }
+              density_factor,
+              build_thread_count,
+              minimized }
         {}
 
         impl(std::unique_ptr<storage>&& p_storage, const std::size_t root_base_check_index) :
-        m_p_storage{ std::move(p_storage) },
-        m_root_base_check_index{ root_base_check_index }
+        m_p_shared_state{ make_shared_state(std::move(p_storage), root_base_check_index) },
+        m_key_prefix{},
+        m_root_value_offset{ 0 },
+        m_root_base_check_index{ root_base_check_index },
+        m_root_modification_count{ 0 }
+        {}
+
+        impl(
+            std::shared_ptr<shared_state_type> p_shared_state,
+            std::string                        key_prefix,
+            const std::int32_t                 root_value_offset,
+            const std::size_t                  root_base_check_index) :
+        m_p_shared_state{ std::move(p_shared_state) },
+        m_key_prefix{ std::move(key_prefix) },
+        m_root_value_offset{ root_value_offset },
+        m_root_base_check_index{ root_base_check_index },
+        m_root_modification_count{ m_p_shared_state->modification_count }
         {}
 
 
@@ -95,13 +158,42 @@ namespace tetengo::trie
 
         std::optional<std::int32_t> find(const std::string_view& key) const
         {
-            const auto o_index = traverse(std::string{ key } + double_array::key_terminator());
-            return o_index ? std::make_optional(m_p_storage->base_at(*o_index)) : std::nullopt;
+            follow_root();
+            return with_base_check_accessor(*m_p_shared_state->p_storage, [this, &key](const auto& accessor) {
+                return find_with(accessor, key);
+            });
+        }
+
+        std::vector<std::optional<std::int32_t>> find_batch(const std::vector<std::string_view>& keys) const
+        {
+            follow_root();
+            return with_base_check_accessor(*m_p_shared_state->p_storage, [this, &keys](const auto& accessor) {
+                return find_batch_with(accessor, keys);
+            });
+        }
+
+        std::vector<std::pair<std::size_t, std::int32_t>> common_prefix_search(const std::string_view& key) const
+        {
+            follow_root();
+            return with_base_check_accessor(*m_p_shared_state->p_storage, [this, &key](const auto& accessor) {
+                return common_prefix_search_with(accessor, key);
+            });
+        }
+
+        std::vector<fuzzy_search_element_type>
+        fuzzy_search(const std::string_view& key, const std::size_t max_distance) const
+        {
+            follow_root();
+            return with_base_check_accessor(
+                *m_p_shared_state->p_storage, [this, &key, max_distance](const auto& accessor) {
+                    return fuzzy_search_with(accessor, key, max_distance);
+                });
         }
 
         double_array_iterator begin() const
         {
-            return double_array_iterator{ *m_p_storage, m_root_base_check_index };
+            follow_root();
+            return double_array_iterator{ *m_p_shared_state->p_storage, root_index(), m_root_value_offset };
         }
 
         double_array_iterator end() const
@@ -111,47 +203,416 @@ namespace tetengo::trie
 
         std::unique_ptr<double_array> subtrie(const std::string_view& key_prefix) const
         {
-            const auto o_index = traverse(key_prefix);
-            return o_index ? std::make_unique<double_array>(m_p_storage->clone(), *o_index) : nullptr;
+            follow_root();
+            const auto o_traversal =
+                with_base_check_accessor(*m_p_shared_state->p_storage, [this, &key_prefix](const auto& accessor) {
+                    return traverse(accessor, root_index(), key_prefix);
+                });
+            if (!o_traversal)
+            {
+                return nullptr;
+            }
+            auto subtrie_key_prefix = m_key_prefix + std::string{ key_prefix };
+            return std::unique_ptr<double_array>{ new double_array{ std::make_unique<impl>(
+                m_p_shared_state,
+                std::move(subtrie_key_prefix),
+                m_root_value_offset + o_traversal->value_offset,
+                o_traversal->base_check_index) } };
+        }
+
+        std::unique_ptr<storage> relocated_storage(const std::vector<std::string_view>& sample_keys) const
+        {
+            follow_root();
+            return double_array_builder::relocate(
+                *m_p_shared_state->p_storage, root_index(), sample_keys, default_density_factor(), m_root_value_offset);
+        }
+
+        bool insert(const std::string_view& key, const std::int32_t value)
+        {
+            follow_root();
+            const auto inserted = updater().insert(root_index(), key, value);
+            if (inserted)
+            {
+                count_modification();
+            }
+            return inserted;
+        }
+
+        bool erase(const std::string_view& key)
+        {
+            follow_root();
+            const auto erased = updater().erase(root_index(), key);
+            if (erased)
+            {
+                count_modification();
+            }
+            return erased;
+        }
+
+        std::size_t root_base_check_index() const
+        {
+            follow_root();
+            return root_index();
         }
 
         const storage& get_storage() const
         {
-            return *m_p_storage;
+            return *m_p_shared_state->p_storage;
         }
 
         storage& get_storage()
         {
-            return *m_p_storage;
+            return *m_p_shared_state->p_storage;
         }
 
 
     private:
+        // types
+
+        struct batch_lane_type
+        {
+            std::size_t key_index;
+
+            std::size_t key_offset;
+
+            std::size_t base_check_index;
+
+            std::uint8_t char_code;
+
+            std::int32_t value_offset;
+        };
+
+        struct traversal_type
+        {
+            std::size_t base_check_index;
+
+            // The sum of the preceding key counts on the path.
+            std::int32_t value_offset;
+        };
+
+
+        // static variables
+
+        static constexpr std::size_t batch_width = 8;
+
+        static constexpr std::size_t erased_root_index = static_cast<std::size_t>(-1);
+
+
+        // static functions
+
+        static std::shared_ptr<shared_state_type>
+        make_shared_state(std::unique_ptr<storage>&& p_storage, const std::size_t root_base_check_index = 0)
+        {
+            auto p_shared_state = std::make_shared<shared_state_type>();
+            p_shared_state->p_storage = std::move(p_storage);
+            p_shared_state->root_base_check_index = root_base_check_index;
+            p_shared_state->modification_count = 0;
+            return p_shared_state;
+        }
+
+        static std::uint8_t char_code_at(const std::string_view& key, const std::size_t offset)
+        {
+            return offset < key.length() ? static_cast<std::uint8_t>(key[offset]) :
+                                           static_cast<std::uint8_t>(double_array::key_terminator());
+        }
+
+        template <typename Accessor>
+        static std::optional<std::size_t>
+        next_index(const Accessor& accessor, const std::size_t base_check_index, const char c)
+        {
+            const auto next_base_check_index =
+                static_cast<std::size_t>(accessor.base_at(base_check_index)) + static_cast<std::uint8_t>(c);
+            if (next_base_check_index >= accessor.size() ||
+                accessor.check_at(next_base_check_index) != static_cast<std::uint8_t>(c))
+            {
+                return std::nullopt;
+            }
+            return std::make_optional(next_base_check_index);
+        }
+
+
         // variables
 
-        std::unique_ptr<storage> m_p_storage;
+        const std::shared_ptr<shared_state_type> m_p_shared_state;
+
+        const std::string m_key_prefix;
 
-        std::size_t m_root_base_check_index;
+        // The values under a subtrie root are offset by the preceding key counts on the path to it.
+        const std::int32_t m_root_value_offset;
+
+        mutable std::atomic<std::size_t> m_root_base_check_index;
+
+        mutable std::atomic<std::size_t> m_root_modification_count;
 
 
         // functions
 
-        std::optional<std::size_t> traverse(const std::string_view& key) const
+        void follow_root() const
+        {
+            const auto modification_count = m_p_shared_state->modification_count;
+            if (m_root_modification_count.load(std::memory_order_acquire) != modification_count)
+            {
+                // The readers racing here find the same root, as the storage is not modified while they read it.
+                const auto o_traversal =
+                    with_base_check_accessor(*m_p_shared_state->p_storage, [this](const auto& accessor) {
+                        return traverse(accessor, m_p_shared_state->root_base_check_index, m_key_prefix);
+                    });
+                m_root_base_check_index.store(
+                    o_traversal ? o_traversal->base_check_index : erased_root_index, std::memory_order_relaxed);
+                m_root_modification_count.store(modification_count, std::memory_order_release);
+            }
+            if (root_index() == erased_root_index)
+            {
+                throw std::logic_error{ "The key prefix of the subtrie is erased." };
+            }
+        }
+
+        std::size_t root_index() const
+        {
+            return m_root_base_check_index.load(std::memory_order_relaxed);
+        }
+
+        double_array_updater& updater()
+        {
+            if (!m_p_shared_state->p_updater)
+            {
+                m_p_shared_state->p_updater = std::make_unique<double_array_updater>(*m_p_shared_state->p_storage);
+            }
+            return *m_p_shared_state->p_updater;
+        }
+
+        void count_modification()
+        {
+            ++m_p_shared_state->modification_count;
+        }
+
+        template <typename Accessor>
+        std::optional<std::int32_t> find_with(const Accessor& accessor, const std::string_view& key) const
+        {
+            const auto o_traversal = traverse(accessor, root_index(), key);
+            if (!o_traversal)
+            {
+                return std::nullopt;
+            }
+            const auto o_terminator_index =
+                next_index(accessor, o_traversal->base_check_index, double_array::key_terminator());
+            return o_terminator_index ? std::make_optional(
+                                            accessor.base_at(*o_terminator_index) + m_root_value_offset +
+                                            o_traversal->value_offset) :
+                                        std::nullopt;
+        }
+
+        template <typename Accessor>
+        std::vector<std::optional<std::int32_t>>
+        find_batch_with(const Accessor& accessor, const std::vector<std::string_view>& keys) const
+        {
+            std::vector<std::optional<std::int32_t>> found(std::size(keys), std::nullopt);
+            if (root_index() >= accessor.size())
+            {
+                return found;
+            }
+
+            std::array<batch_lane_type, batch_width> lanes{};
+            auto                                     lane_count = static_cast<std::size_t>(0);
+            auto                                     next_key_index = static_cast<std::size_t>(0);
+            while (lane_count < std::size(lanes) && next_key_index < std::size(keys))
+            {
+                lanes[lane_count] = start_lane(accessor, keys, next_key_index);
+                ++lane_count;
+                ++next_key_index;
+            }
+
+            while (lane_count > 0)
+            {
+                for (auto i = static_cast<std::size_t>(0); i < lane_count;)
+                {
+                    if (step_lane(accessor, keys, lanes[i], found))
+                    {
+                        ++i;
+                        continue;
+                    }
+
+                    if (next_key_index < std::size(keys))
+                    {
+                        lanes[i] = start_lane(accessor, keys, next_key_index);
+                        ++next_key_index;
+                        ++i;
+                    }
+                    else
+                    {
+                        --lane_count;
+                        lanes[i] = lanes[lane_count];
+                    }
+                }
+            }
+
+            return found;
+        }
+
+        template <typename Accessor>
+        std::vector<std::pair<std::size_t, std::int32_t>>
+        common_prefix_search_with(const Accessor& accessor, const std::string_view& key) const
+        {
+            std::vector<std::pair<std::size_t, std::int32_t>> found{};
+            if (root_index() >= accessor.size())
+            {
+                return found;
+            }
+
+            auto base_check_index = root_index();
+            auto value_offset = m_root_value_offset;
+            for (auto i = static_cast<std::size_t>(0);; ++i)
+            {
+                if (const auto o_terminator_index =
+                        next_index(accessor, base_check_index, double_array::key_terminator()))
+                {
+                    found.emplace_back(i, accessor.base_at(*o_terminator_index) + value_offset);
+                }
+                if (i >= key.length())
+                {
+                    break;
+                }
+
+                const auto o_next_index = next_index(accessor, base_check_index, key[i]);
+                if (!o_next_index)
+                {
+                    break;
+                }
+                base_check_index = *o_next_index;
+                value_offset += static_cast<std::int32_t>(accessor.preceding_key_count_at(base_check_index));
+            }
+
+            return found;
+        }
+
+        template <typename Accessor>
+        std::vector<fuzzy_search_element_type>
+        fuzzy_search_with(const Accessor& accessor, const std::string_view& key, const std::size_t max_distance) const
         {
-            auto base_check_index = m_root_base_check_index;
+            std::vector<fuzzy_search_element_type> found{};
+            if (root_index() >= accessor.size())
+            {
+                return found;
+            }
+
+            std::vector<std::size_t> root_row(key.length() + 1);
+            std::iota(std::begin(root_row), std::end(root_row), static_cast<std::size_t>(0));
+            std::string path{};
+            fuzzy_search_from(accessor, key, max_distance, root_index(), m_root_value_offset, root_row, path, found);
+            return found;
+        }
+
+        // The row holds the edit distances between the path to the node and the prefixes of the key.
+        template <typename Accessor>
+        void fuzzy_search_from(
+            const Accessor&                         accessor,
+            const std::string_view&                 key,
+            const std::size_t                       max_distance,
+            const std::size_t                       base_check_index,
+            const std::int32_t                      value_offset,
+            const std::vector<std::size_t>&         row,
+            std::string&                            path,
+            std::vector<fuzzy_search_element_type>& found) const
+        {
+            const auto               base = accessor.base_at(base_check_index);
+            std::vector<std::size_t> child_row(std::size(row));
+            for (auto char_code = next_child_char_code(accessor, base, 0);
+                 char_code != double_array::vacant_check_value();
+                 char_code = next_child_char_code(accessor, base, char_code + 1))
+            {
+                const auto child_base_check_index = static_cast<std::size_t>(base + char_code);
+                if (char_code == static_cast<std::uint8_t>(double_array::key_terminator()))
+                {
+                    if (row.back() <= max_distance)
+                    {
+                        found.push_back({ path, row.back(), accessor.base_at(child_base_check_index) + value_offset });
+                    }
+                    continue;
+                }
+
+                child_row[0] = row[0] + 1;
+                auto minimum_distance = child_row[0];
+                for (auto i = static_cast<std::size_t>(1); i < std::size(row); ++i)
+                {
+                    const auto substitution_distance =
+                        row[i - 1] + (static_cast<std::uint8_t>(key[i - 1]) == char_code ? 0 : 1);
+                    child_row[i] = std::min({ row[i] + 1, child_row[i - 1] + 1, substitution_distance });
+                    minimum_distance = std::min(minimum_distance, child_row[i]);
+                }
+                if (minimum_distance > max_distance)
+                {
+                    continue;
+                }
+
+                path.push_back(static_cast<char>(char_code));
+                const auto child_value_offset =
+                    value_offset + static_cast<std::int32_t>(accessor.preceding_key_count_at(child_base_check_index));
+                fuzzy_search_from(
+                    accessor, key, max_distance, child_base_check_index, child_value_offset, child_row, path, found);
+                path.pop_back();
+            }
+        }
+
+        template <typename Accessor>
+        static std::optional<traversal_type>
+        traverse(const Accessor& accessor, const std::size_t root_base_check_index, const std::string_view& key)
+        {
+            if (root_base_check_index >= accessor.size())
+            {
+                return std::nullopt;
+            }
+
+            traversal_type traversal{ root_base_check_index, 0 };
             for (const auto c: key)
             {
-                const auto next_base_check_index =
-                    static_cast<std::size_t>(m_p_storage->base_at(base_check_index)) + static_cast<std::uint8_t>(c);
-                if (next_base_check_index >= m_p_storage->base_check_size() ||
-                    m_p_storage->check_at(next_base_check_index) != static_cast<std::uint8_t>(c))
+                const auto o_next_index = next_index(accessor, traversal.base_check_index, c);
+                if (!o_next_index)
                 {
                     return std::nullopt;
                 }
-                base_check_index = next_base_check_index;
+                traversal.base_check_index = *o_next_index;
+                traversal.value_offset += static_cast<std::int32_t>(accessor.preceding_key_count_at(*o_next_index));
             }
 
-            return std::make_optional(base_check_index);
+            return std::make_optional(traversal);
+        }
+
+        template <typename Accessor>
+        batch_lane_type start_lane(
+            const Accessor&                      accessor,
+            const std::vector<std::string_view>& keys,
+            const std::size_t                    key_index) const
+        {
+            const auto char_code = char_code_at(keys[key_index], 0);
+            const auto next_base_check_index =
+                static_cast<std::size_t>(accessor.base_at(root_index())) + char_code;
+            accessor.prefetch_at(next_base_check_index);
+            return batch_lane_type{ key_index, 0, next_base_check_index, char_code, m_root_value_offset };
+        }
+
+        template <typename Accessor>
+        bool step_lane(
+            const Accessor&                           accessor,
+            const std::vector<std::string_view>&      keys,
+            batch_lane_type&                          lane,
+            std::vector<std::optional<std::int32_t>>& found) const
+        {
+            if (lane.base_check_index >= accessor.size() || accessor.check_at(lane.base_check_index) != lane.char_code)
+            {
+                return false;
+            }
+            if (lane.char_code == static_cast<std::uint8_t>(double_array::key_terminator()))
+            {
+                found[lane.key_index] = accessor.base_at(lane.base_check_index) + lane.value_offset;
+                return false;
+            }
+
+            lane.value_offset += static_cast<std::int32_t>(accessor.preceding_key_count_at(lane.base_check_index));
+            ++lane.key_offset;
+            lane.char_code = char_code_at(keys[lane.key_index], lane.key_offset);
+            lane.base_check_index = static_cast<std::size_t>(accessor.base_at(lane.base_check_index)) + lane.char_code;
+            accessor.prefetch_at(lane.base_check_index);
+            return true;
         }
     };
 
@@ -166,6 +627,11 @@ namespace tetengo::trie
         return impl::default_density_factor();
     }
 
+    std::size_t double_array::default_build_thread_count()
+    {
+        return impl::default_build_thread_count();
+    }
+
     char double_array::key_terminator()
     {
         return impl::key_terminator();
@@ -181,15 +647,19 @@ namespace tetengo::trie
     double_array::double_array(
         const std::vector<std::pair<std::string_view, std::int32_t>>& elements,
         const building_observer_set_type& building_observer_set /*= null_building_observer_set()*/,
-        std::size_t                       density_factor /*= default_density_factor()*/) :
-    m_p_impl{ std::make_unique<impl>(elements, building_observer_set, density_factor) }
+        std::size_t                       density_factor /*= default_density_factor()*/,
+        std::size_t                       build_thread_count /*= default_build_thread_count()*/,
+        bool                              minimized /*= false*/) :
+    m_p_impl{ std::make_unique<impl>(elements, building_observer_set, density_factor, build_thread_count, minimized) }
     {}
 
     double_array::double_array(
         const std::vector<std::pair<std::string, std::int32_t>>& elements,
         const building_observer_set_type& building_observer_set /*= null_building_observer_set()*/,
-        std::size_t                       density_factor /*= default_density_factor()*/) :
-    m_p_impl{ std::make_unique<impl>(elements, building_observer_set, density_factor) }
+        std::size_t                       density_factor /*= default_density_factor()*/,
+        std::size_t                       build_thread_count /*= default_build_thread_count()*/,
+        bool                              minimized /*= false*/) :
+    m_p_impl{ std::make_unique<impl>(elements, building_observer_set, density_factor, build_thread_count, minimized) }
     {}
 
     double_array::double_array(std::unique_ptr<storage>&& p_storage, const std::size_t root_base_check_index) :
@@ -198,11 +668,30 @@ namespace tetengo::trie
 
     double_array::~double_array() = default;
 
+    double_array::double_array(std::unique_ptr<impl>&& p_impl) : m_p_impl{ std::move(p_impl) } {}
+
     std::optional<std::int32_t> double_array::find(const std::string_view& key) const
     {
         return m_p_impl->find(key);
     }
 
+    std::vector<std::optional<std::int32_t>> double_array::find_batch(const std::vector<std::string_view>& keys) const
+    {
+        return m_p_impl->find_batch(keys);
+    }
+
+    std::vector<std::pair<std::size_t, std::int32_t>>
+    double_array::common_prefix_search(const std::string_view& key) const
+    {
+        return m_p_impl->common_prefix_search(key);
+    }
+
+    std::vector<double_array::fuzzy_search_element_type>
+    double_array::fuzzy_search(const std::string_view& key, const std::size_t max_distance) const
+    {
+        return m_p_impl->fuzzy_search(key, max_distance);
+    }
+
     double_array_iterator double_array::begin() const
     {
         return m_p_impl->begin();
@@ -218,6 +707,27 @@ namespace tetengo::trie
         return m_p_impl->subtrie(key_prefix);
     }
 
+    std::unique_ptr<storage> double_array::relocated_storage(
+        const std::vector<std::string_view>& sample_keys /*= std::vector<std::string_view>{}*/) const
+    {
+        return m_p_impl->relocated_storage(sample_keys);
+    }
+
+    bool double_array::insert(const std::string_view& key, const std::int32_t value)
+    {
+        return m_p_impl->insert(key, value);
+    }
+
+    bool double_array::erase(const std::string_view& key)
+    {
+        return m_p_impl->erase(key);
+    }
+
+    std::size_t double_array::root_base_check_index() const
+    {
+        return m_p_impl->root_base_check_index();
+    }
+
     const storage& double_array::get_storage() const
     {
         return m_p_impl->get_storage();
@@ -7,17 +7,22 @@
 #if !defined(DOCUMENTATION)
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <compare> // IWYU pragma: keep
+#include <deque>
 #include <functional>
+#include <future>
 #include <iterator>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
-#include <unordered_set>
 
 #include <tetengo/trie/double_array.hpp>
 #include <tetengo/trie/memory_storage.hpp>
 #include <tetengo/trie/storage.hpp>
 
+#include "tetengo.trie.base_check_accessor.hpp"
 #include "tetengo.trie.double_array_builder.hpp"
 
 
@@ -28,47 +33,348 @@ namespace tetengo::trie
         return 1000;
     }
 
+    std::size_t double_array_builder::default_build_thread_count()
+    {
+        return 1;
+    }
+
     std::unique_ptr<storage> double_array_builder::build(
         std::vector<std::pair<std::string_view, std::int32_t>> elements,
         const double_array::building_observer_set_type&        observer,
-        const std::size_t                                      density_factor)
+        const std::size_t                                      density_factor,
+        const std::size_t                                      build_thread_count,
+        const minimization_type                                minimization)
     {
         if (density_factor == 0)
         {
             throw std::invalid_argument{ "density_factor must be greater than 0." };
         }
+        if (build_thread_count == 0)
+        {
+            throw std::invalid_argument{ "build_thread_count must be greater than 0." };
+        }
 
-        std::stable_sort(std::begin(elements), std::end(elements), [](const auto& e1, const auto& e2) {
-            return e1.first < e2.first;
-        });
+        sort_elements(elements, build_thread_count);
 
-        auto p_storage = std::make_unique<memory_storage>();
+        auto       p_storage = std::make_unique<memory_storage>();
+        const auto counted = minimization == minimization_type::counted_values;
+        if (counted)
+        {
+            // The root has no sibling. Its count is set even without any key, so that the storage has the counts.
+            p_storage->set_preceding_key_count_at(0, 0);
+        }
 
         if (!std::empty(elements))
         {
-            std::unordered_set<std::int32_t> base_uniquer{};
-            build_iter(
-                std::begin(elements), std::end(elements), 0, *p_storage, 0, base_uniquer, observer, density_factor);
+            if (minimization != minimization_type::none)
+            {
+                placement_type       placement{};
+                suffix_register_type suffix_register{};
+                const auto           root = build_minimized_iter(
+                    std::begin(elements),
+                    std::end(elements),
+                    0,
+                    *p_storage,
+                    placement,
+                    suffix_register,
+                    observer,
+                    density_factor,
+                    counted);
+                p_storage->set_base_at(0, root.base);
+            }
+            else if (build_thread_count == 1)
+            {
+                placement_type            placement{};
+                std::vector<subtree_type> deferred_subtrees{};
+                build_iter(
+                    std::begin(elements),
+                    std::end(elements),
+                    0,
+                    *p_storage,
+                    0,
+                    placement,
+                    observer,
+                    density_factor,
+                    0,
+                    deferred_subtrees);
+            }
+            else
+            {
+                build_parallel(elements, *p_storage, observer, density_factor, build_thread_count);
+            }
         }
 
         observer.done();
         return p_storage;
     }
 
+    std::unique_ptr<storage> double_array_builder::relocate(
+        const storage&                       storage_,
+        const std::size_t                    root_base_check_index,
+        const std::vector<std::string_view>& sample_keys,
+        const std::size_t                    density_factor,
+        const std::int32_t                   root_value_offset)
+    {
+        if (density_factor == 0)
+        {
+            throw std::invalid_argument{ "density_factor must be greater than 0." };
+        }
+
+        auto p_relocated = std::make_unique<memory_storage>();
+        if (storage_.has_preceding_key_counts())
+        {
+            p_relocated->set_preceding_key_count_at(0, 0);
+        }
+        with_base_check_accessor(
+            storage_, [root_base_check_index, &sample_keys, density_factor, &p_relocated](const auto& accessor) {
+                relocate_with(accessor, root_base_check_index, sample_keys, density_factor, *p_relocated);
+            });
+
+        // The values of the keys under a subtrie root are offset by the keys preceding it. The offset is added to the
+        // children of the relocated root, which no other node shares since no other node is as high as the root.
+        if (root_value_offset != 0)
+        {
+            const storage_accessor accessor{ *p_relocated };
+            const auto             root_base = p_relocated->base_at(0);
+            for (auto char_code = next_child_char_code(accessor, root_base, 0);
+                 char_code != double_array::vacant_check_value();
+                 char_code = next_child_char_code(accessor, root_base, char_code + 1))
+            {
+                const auto child_base_check_index = static_cast<std::size_t>(root_base + char_code);
+                p_relocated->set_preceding_key_count_at(
+                    child_base_check_index,
+                    p_relocated->preceding_key_count_at(child_base_check_index) +
+                        static_cast<std::uint32_t>(root_value_offset));
+            }
+        }
+
+        for (auto i = static_cast<std::size_t>(0); i < storage_.value_count(); ++i)
+        {
+            if (const auto p_value = storage_.shared_value_at(i); p_value)
+            {
+                p_relocated->add_value_at(i, *p_value);
+            }
+        }
+
+        return p_relocated;
+    }
+
+    void double_array_builder::sort_elements(element_vector_type& elements, const std::size_t build_thread_count)
+    {
+        const auto less = [](const auto& e1, const auto& e2) { return e1.first < e2.first; };
+
+        if (build_thread_count == 1 || std::size(elements) < build_thread_count)
+        {
+            std::stable_sort(std::begin(elements), std::end(elements), less);
+            return;
+        }
+
+        std::vector<element_vector_type::iterator> bounds{};
+        bounds.reserve(build_thread_count + 1);
+        for (auto i = static_cast<std::size_t>(0); i <= build_thread_count; ++i)
+        {
+            bounds.push_back(std::next(std::begin(elements), std::size(elements) * i / build_thread_count));
+        }
+
+        {
+            std::vector<std::future<void>> sortings{};
+            sortings.reserve(build_thread_count);
+            for (auto i = static_cast<std::size_t>(0); i + 1 < std::size(bounds); ++i)
+            {
+                sortings.push_back(std::async(std::launch::async, [&bounds, &less, i]() {
+                    std::stable_sort(bounds[i], bounds[i + 1], less);
+                }));
+            }
+            for (auto& sorting: sortings)
+            {
+                sorting.get();
+            }
+        }
+
+        while (std::size(bounds) > 2)
+        {
+            std::vector<std::future<void>>             mergings{};
+            std::vector<element_vector_type::iterator> merged_bounds{ bounds[0] };
+            for (auto i = static_cast<std::size_t>(0); i + 2 < std::size(bounds); i += 2)
+            {
+                mergings.push_back(std::async(std::launch::async, [&bounds, &less, i]() {
+                    std::inplace_merge(bounds[i], bounds[i + 1], bounds[i + 2], less);
+                }));
+                merged_bounds.push_back(bounds[i + 2]);
+            }
+            if (std::size(bounds) % 2 == 0)
+            {
+                merged_bounds.push_back(bounds.back());
+            }
+            for (auto& merging: mergings)
+            {
+                merging.get();
+            }
+            bounds = std::move(merged_bounds);
+        }
+    }
+
+    void double_array_builder::build_parallel(
+        const element_vector_type&                      elements,
+        storage&                                        storage_,
+        const double_array::building_observer_set_type& observer,
+        const std::size_t                               density_factor,
+        const std::size_t                               build_thread_count)
+    {
+        // The upper part of the trie is built on this thread, and the subtrees with few elements are deferred.
+        std::vector<subtree_type> deferred_subtrees{};
+        {
+            placement_type placement{};
+            build_iter(
+                std::begin(elements),
+                std::end(elements),
+                0,
+                storage_,
+                0,
+                placement,
+                observer,
+                density_factor,
+                std::max<std::size_t>(std::size(elements) / (build_thread_count * 8), 1),
+                deferred_subtrees);
+        }
+
+        // The deferred subtrees are grouped into regions, and each region is built on a worker thread.
+        std::vector<std::vector<subtree_type>> region_subtrees{};
+        {
+            const auto region_element_count = std::max<std::size_t>(std::size(elements) / (build_thread_count * 4), 1);
+            auto       element_count = region_element_count;
+            for (const auto& subtree: deferred_subtrees)
+            {
+                if (element_count >= region_element_count)
+                {
+                    region_subtrees.emplace_back();
+                    element_count = 0;
+                }
+                region_subtrees.back().push_back(subtree);
+                element_count += static_cast<std::size_t>(std::distance(subtree.first, subtree.last));
+            }
+        }
+
+        std::mutex                                     observer_mutex{};
+        const double_array::building_observer_set_type synchronized_observer{
+            [&observer, &observer_mutex](const std::pair<std::string_view, std::int32_t>& element) {
+                const std::unique_lock<std::mutex> lock{ observer_mutex };
+                observer.adding(element);
+            },
+            []() {}
+        };
+        std::vector<std::unique_ptr<storage>> regions(std::size(region_subtrees));
+        {
+            std::atomic<std::size_t>       next_region_index{ 0 };
+            std::vector<std::future<void>> workers{};
+            const auto                     worker_count = std::min(build_thread_count, std::size(region_subtrees));
+            workers.reserve(worker_count);
+            for (auto i = static_cast<std::size_t>(0); i < worker_count; ++i)
+            {
+                workers.push_back(std::async(
+                    std::launch::async,
+                    [&region_subtrees, &regions, &next_region_index, &synchronized_observer, density_factor]() {
+                        for (auto region_index = next_region_index++; region_index < std::size(region_subtrees);
+                             region_index = next_region_index++)
+                        {
+                            regions[region_index] =
+                                build_region(region_subtrees[region_index], synchronized_observer, density_factor);
+                        }
+                    }));
+            }
+            for (auto& worker: workers)
+            {
+                worker.get();
+            }
+        }
+
+        // The regions are placed after the upper part, keeping the bases of the regions apart.
+        for (auto i = static_cast<std::size_t>(0); i < std::size(regions); ++i)
+        {
+            const auto offset = storage_.base_check_size() + std::numeric_limits<std::uint8_t>::max() + 1;
+            merge_region(storage_, *regions[i], region_subtrees[i], offset);
+            regions[i].reset();
+        }
+    }
+
+    std::unique_ptr<storage> double_array_builder::build_region(
+        const std::vector<subtree_type>&                subtrees,
+        const double_array::building_observer_set_type& observer,
+        const std::size_t                               density_factor)
+    {
+        auto p_region = std::make_unique<memory_storage>();
+
+        // The first elements of the region are reserved for the roots of the subtrees.
+        placement_type placement{};
+        for (auto i = static_cast<std::size_t>(0); i < std::size(subtrees); ++i)
+        {
+            p_region->set_check_at(i, double_array::key_terminator());
+            placement.checks.occupy(i);
+        }
+
+        std::vector<subtree_type> deferred_subtrees{};
+        for (auto i = static_cast<std::size_t>(0); i < std::size(subtrees); ++i)
+        {
+            build_iter(
+                subtrees[i].first,
+                subtrees[i].last,
+                subtrees[i].key_offset,
+                *p_region,
+                i,
+                placement,
+                observer,
+                density_factor,
+                0,
+                deferred_subtrees);
+        }
+
+        return p_region;
+    }
+
+    void double_array_builder::merge_region(
+        storage&                         storage_,
+        const storage&                   region,
+        const std::vector<subtree_type>& subtrees,
+        const std::size_t                offset)
+    {
+        const auto base_offset = static_cast<std::int32_t>(offset);
+
+        for (auto i = static_cast<std::size_t>(0); i < std::size(subtrees); ++i)
+        {
+            storage_.set_base_at(subtrees[i].base_check_index, region.base_at(i) + base_offset);
+        }
+        for (auto i = std::size(subtrees); i < region.base_check_size(); ++i)
+        {
+            const auto check = region.check_at(i);
+            if (check == double_array::vacant_check_value())
+            {
+                continue;
+            }
+
+            // The base of a key terminator is not an index but a value.
+            const auto base = region.base_at(i);
+            const auto is_terminator = check == static_cast<std::uint8_t>(double_array::key_terminator());
+            storage_.set_base_at(offset + i, is_terminator ? base : base + base_offset);
+            storage_.set_check_at(offset + i, check);
+        }
+    }
+
     void double_array_builder::build_iter(
         const element_iterator_type                     first,
         const element_iterator_type                     last,
         const std::size_t                               key_offset,
         storage&                                        storage_,
         const std::size_t                               base_check_index,
-        std::unordered_set<std::int32_t>&               base_uniquer,
+        placement_type&                                 placement,
         const double_array::building_observer_set_type& observer,
-        const std::size_t                               density_factor)
+        const std::size_t                               density_factor,
+        const std::size_t                               max_deferred_element_count,
+        std::vector<subtree_type>&                      deferred_subtrees)
     {
         const auto children_firsts_ = children_firsts(first, last, key_offset);
 
-        const auto base =
-            calc_base(children_firsts_, key_offset, storage_, base_check_index, density_factor, base_uniquer);
+        const auto base = calc_base(
+            children_char_codes(children_firsts_, key_offset), base_check_index, density_factor, placement);
         storage_.set_base_at(base_check_index, base);
 
         for (auto i = std::begin(children_firsts_); i != std::prev(std::end(children_firsts_)); ++i)
@@ -76,6 +382,7 @@ namespace tetengo::trie
             const auto char_code = char_code_at((*i)->first, key_offset);
             const auto next_base_check_index = base + char_code;
             storage_.set_check_at(next_base_check_index, char_code);
+            placement.checks.occupy(next_base_check_index);
         }
         for (auto i = std::begin(children_firsts_); i != std::prev(std::end(children_firsts_)); ++i)
         {
@@ -87,44 +394,330 @@ namespace tetengo::trie
                 storage_.set_base_at(next_base_check_index, (*i)->second);
                 continue;
             }
+            if (static_cast<std::size_t>(std::distance(*i, *std::next(i))) <= max_deferred_element_count)
+            {
+                deferred_subtrees.push_back(subtree_type{
+                    *i, *std::next(i), key_offset + 1, static_cast<std::size_t>(next_base_check_index) });
+                continue;
+            }
             build_iter(
                 *i,
                 *std::next(i),
                 key_offset + 1,
                 storage_,
                 next_base_check_index,
-                base_uniquer,
+                placement,
+                observer,
+                density_factor,
+                max_deferred_element_count,
+                deferred_subtrees);
+        }
+    }
+
+    double_array_builder::minimized_subtree_type double_array_builder::build_minimized_iter(
+        const element_iterator_type                     first,
+        const element_iterator_type                     last,
+        const std::size_t                               key_offset,
+        storage&                                        storage_,
+        placement_type&                                 placement,
+        suffix_register_type&                           suffix_register,
+        const double_array::building_observer_set_type& observer,
+        const std::size_t                               density_factor,
+        const bool                                      counted)
+    {
+        const auto children_firsts_ = children_firsts(first, last, key_offset);
+
+        // The children are built first. Then a subtree is identified by the labels and the bases of its children.
+        // When the values are counted, the key terminators hold no value, and the key counts follow the bases.
+        suffix_signature_type      signature{};
+        std::vector<std::uint32_t> key_counts{};
+        signature.reserve(std::size(children_firsts_) - 1);
+        key_counts.reserve(std::size(children_firsts_) - 1);
+        for (auto i = std::begin(children_firsts_); i != std::prev(std::end(children_firsts_)); ++i)
+        {
+            const auto char_code = char_code_at((*i)->first, key_offset);
+            if (char_code == double_array::key_terminator())
+            {
+                observer.adding(**i);
+                signature.emplace_back(char_code, counted ? 0 : (*i)->second);
+                key_counts.push_back(1);
+                continue;
+            }
+            const auto child = build_minimized_iter(
+                *i,
+                *std::next(i),
+                key_offset + 1,
+                storage_,
+                placement,
+                suffix_register,
                 observer,
+                density_factor,
+                counted);
+            signature.emplace_back(char_code, child.base);
+            key_counts.push_back(child.key_count);
+        }
+
+        // An equivalent subtree already placed is shared, since a check holds not a parent but a label.
+        if (const auto found = suffix_register.find(signature); found != std::end(suffix_register))
+        {
+            return found->second;
+        }
+
+        // The position of the node itself is not determined yet, so the search starts a block width before the tail.
+        const auto block_width = static_cast<std::size_t>(std::numeric_limits<std::uint8_t>::max()) + 1;
+        const auto tail_index = storage_.base_check_size();
+        const auto base = calc_base(
+            children_char_codes(children_firsts_, key_offset),
+            tail_index > block_width ? tail_index - block_width : 0,
+            density_factor,
+            placement);
+        auto preceding_key_count = static_cast<std::uint32_t>(0);
+        for (auto i = static_cast<std::size_t>(0); i < std::size(signature); ++i)
+        {
+            const auto [char_code, child_base] = signature[i];
+            const auto next_base_check_index = base + char_code;
+            storage_.set_check_at(next_base_check_index, char_code);
+            storage_.set_base_at(next_base_check_index, child_base);
+            if (counted)
+            {
+                storage_.set_preceding_key_count_at(next_base_check_index, preceding_key_count);
+            }
+            placement.checks.occupy(next_base_check_index);
+            preceding_key_count += key_counts[i];
+        }
+        const minimized_subtree_type subtree{ base, preceding_key_count };
+        suffix_register.emplace(std::move(signature), subtree);
+        return subtree;
+    }
+
+    std::size_t double_array_builder::top_level_element_count()
+    {
+        // The elements in a page of the narrow base-check array.
+        return 4096 / sizeof(std::uint32_t);
+    }
+
+    template <typename Accessor>
+    void double_array_builder::relocate_with(
+        const Accessor&                      accessor,
+        const std::size_t                    root_base_check_index,
+        const std::vector<std::string_view>& sample_keys,
+        const std::size_t                    density_factor,
+        storage&                             relocated)
+    {
+        const auto pass_counts = count_passes(accessor, root_base_check_index, sample_keys);
+
+        // The relocated bases are indexed like the bases in the placement.
+        placement_type      placement{};
+        relocation_map_type relocated_bases(
+            base_bit_index(static_cast<std::int32_t>(accessor.size())), std::numeric_limits<std::int32_t>::min());
+
+        // The top levels, which all the lookups pass through, are placed breadth-first in about a page.
+        std::deque<relocated_child_type> queue{ relocated_child_type{ root_base_check_index, 0 } };
+        while (!std::empty(queue) && relocated.base_check_size() < top_level_element_count())
+        {
+            const auto [base_check_index, relocated_base_check_index] = queue.front();
+            queue.pop_front();
+            const auto children = relocate_node(
+                accessor,
+                base_check_index,
+                relocated,
+                relocated_base_check_index,
+                pass_counts,
+                placement,
+                relocated_bases,
+                density_factor);
+            queue.insert(std::end(queue), std::begin(children), std::end(children));
+        }
+
+        // The rest are placed depth-first, so that the elements on a lookup path below the top levels are close.
+        for (const auto& [base_check_index, relocated_base_check_index]: queue)
+        {
+            relocate_iter(
+                accessor,
+                base_check_index,
+                relocated,
+                relocated_base_check_index,
+                pass_counts,
+                placement,
+                relocated_bases,
+                density_factor);
+        }
+    }
+
+    template <typename Accessor>
+    std::vector<std::size_t> double_array_builder::count_passes(
+        const Accessor&                      accessor,
+        const std::size_t                    root_base_check_index,
+        const std::vector<std::string_view>& sample_keys)
+    {
+        if (std::empty(sample_keys))
+        {
+            return {};
+        }
+
+        std::vector<std::size_t> pass_counts(accessor.size(), 0);
+        for (const auto& key: sample_keys)
+        {
+            auto base_check_index = root_base_check_index;
+            for (auto i = static_cast<std::size_t>(0); i <= key.length(); ++i)
+            {
+                const auto char_code = char_code_at(key, i);
+                const auto next_base_check_index = accessor.base_at(base_check_index) + char_code;
+                if (next_base_check_index < 0 || static_cast<std::size_t>(next_base_check_index) >= accessor.size() ||
+                    accessor.check_at(static_cast<std::size_t>(next_base_check_index)) != char_code)
+                {
+                    break;
+                }
+                base_check_index = static_cast<std::size_t>(next_base_check_index);
+                ++pass_counts[base_check_index];
+            }
+        }
+        return pass_counts;
+    }
+
+    template <typename Accessor>
+    void double_array_builder::relocate_iter(
+        const Accessor&                 accessor,
+        const std::size_t               base_check_index,
+        storage&                        relocated,
+        const std::size_t               relocated_base_check_index,
+        const std::vector<std::size_t>& pass_counts,
+        placement_type&                 placement,
+        relocation_map_type&            relocated_bases,
+        const std::size_t               density_factor)
+    {
+        const auto children = relocate_node(
+            accessor,
+            base_check_index,
+            relocated,
+            relocated_base_check_index,
+            pass_counts,
+            placement,
+            relocated_bases,
+            density_factor);
+        for (const auto& [child_base_check_index, relocated_child_base_check_index]: children)
+        {
+            relocate_iter(
+                accessor,
+                child_base_check_index,
+                relocated,
+                relocated_child_base_check_index,
+                pass_counts,
+                placement,
+                relocated_bases,
                 density_factor);
         }
     }
 
+    template <typename Accessor>
+    std::vector<double_array_builder::relocated_child_type> double_array_builder::relocate_node(
+        const Accessor&                 accessor,
+        const std::size_t               base_check_index,
+        storage&                        relocated,
+        const std::size_t               relocated_base_check_index,
+        const std::vector<std::size_t>& pass_counts,
+        placement_type&                 placement,
+        relocation_map_type&            relocated_bases,
+        const std::size_t               density_factor)
+    {
+        // The children shared with a node already relocated, as in a minimized double array, stay shared.
+        const auto base = accessor.base_at(base_check_index);
+        if (const auto relocated_base = relocated_bases[base_bit_index(base)];
+            relocated_base != std::numeric_limits<std::int32_t>::min())
+        {
+            relocated.set_base_at(relocated_base_check_index, relocated_base);
+            return {};
+        }
+
+        std::vector<std::uint8_t> char_codes{};
+        for (auto char_code = static_cast<std::int32_t>(0); char_code < double_array::vacant_check_value(); ++char_code)
+        {
+            const auto child_base_check_index = base + char_code;
+            if (child_base_check_index >= 0 && static_cast<std::size_t>(child_base_check_index) < accessor.size() &&
+                accessor.check_at(static_cast<std::size_t>(child_base_check_index)) == char_code)
+            {
+                char_codes.push_back(static_cast<std::uint8_t>(char_code));
+            }
+        }
+        if (std::empty(char_codes))
+        {
+            return {};
+        }
+
+        const auto relocated_base = calc_base(char_codes, relocated_base_check_index, density_factor, placement);
+        relocated.set_base_at(relocated_base_check_index, relocated_base);
+        relocated_bases[base_bit_index(base)] = relocated_base;
+
+        std::vector<relocated_child_type> children{};
+        children.reserve(std::size(char_codes));
+        for (const auto char_code: char_codes)
+        {
+            const auto child_base_check_index = static_cast<std::size_t>(base + char_code);
+            const auto relocated_child_base_check_index = static_cast<std::size_t>(relocated_base + char_code);
+            relocated.set_check_at(relocated_child_base_check_index, char_code);
+            placement.checks.occupy(relocated_child_base_check_index);
+            if (relocated.has_preceding_key_counts())
+            {
+                relocated.set_preceding_key_count_at(
+                    relocated_child_base_check_index, accessor.preceding_key_count_at(child_base_check_index));
+            }
+
+            // The base of a key terminator is not an index but a value.
+            if (char_code == double_array::key_terminator())
+            {
+                relocated.set_base_at(relocated_child_base_check_index, accessor.base_at(child_base_check_index));
+                continue;
+            }
+            children.emplace_back(child_base_check_index, relocated_child_base_check_index);
+        }
+
+        // The children more frequently passed through by the sample keys come first.
+        if (!std::empty(pass_counts))
+        {
+            std::stable_sort(
+                std::begin(children), std::end(children), [&pass_counts](const auto& one, const auto& another) {
+                    return pass_counts[one.first] > pass_counts[another.first];
+                });
+        }
+
+        return children;
+    }
+
     std::int32_t double_array_builder::calc_base(
-        const std::vector<element_iterator_type>& firsts,
-        const std::size_t                         key_offset,
-        const storage&                            storage_,
-        const std::size_t                         base_check_index,
-        const std::size_t                         density_factor,
-        std::unordered_set<std::int32_t>&         base_uniquer)
-    {
-        const auto base_first = static_cast<std::int32_t>(base_check_index - base_check_index / density_factor) -
-                                char_code_at(firsts[0]->first, key_offset) + 1;
-        for (auto base = base_first;; ++base)
-        {
-            const auto first_last = std::prev(std::end(firsts));
-            const auto occupied =
-                std::find_if(std::begin(firsts), first_last, [key_offset, &storage_, base](const auto& first) {
-                    const auto next_base_check_index = base + char_code_at(first->first, key_offset);
-                    return storage_.check_at(next_base_check_index) != double_array::vacant_check_value();
+        const std::vector<std::uint8_t>& char_codes,
+        const std::size_t                base_check_index,
+        const std::size_t                density_factor,
+        placement_type&                  placement)
+    {
+        // Only the bases which put the first child on a vacant element are tried.
+        const auto first_index = base_check_index - base_check_index / density_factor + 1;
+        for (auto index = placement.checks.first_vacant_from(first_index);;
+             index = placement.checks.first_vacant_from(index + 1))
+        {
+            const auto base = static_cast<std::int32_t>(index) - char_codes[0];
+            if (placement.bases.occupied(base_bit_index(base)))
+            {
+                continue;
+            }
+
+            const auto occupied = std::any_of(
+                std::next(std::begin(char_codes)), std::end(char_codes), [&placement, base](const auto char_code) {
+                    return placement.checks.occupied(base + char_code);
                 });
-            if (occupied == first_last && base_uniquer.find(base) == std::end(base_uniquer))
+            if (!occupied)
             {
-                base_uniquer.insert(base);
+                placement.bases.occupy(base_bit_index(base));
                 return base;
             }
         }
     }
 
+    std::size_t double_array_builder::base_bit_index(const std::int32_t base)
+    {
+        // A base is not less than -254 since the first child is placed at or after the index 1.
+        return static_cast<std::size_t>(base + std::numeric_limits<std::uint8_t>::max() + 1);
+    }
+
     std::vector<double_array_builder::element_iterator_type> double_array_builder::children_firsts(
         const element_iterator_type first,
         const element_iterator_type last,
@@ -145,6 +738,19 @@ namespace tetengo::trie
         return firsts;
     }
 
+    std::vector<std::uint8_t> double_array_builder::children_char_codes(
+        const std::vector<element_iterator_type>& firsts,
+        const std::size_t                         key_offset)
+    {
+        std::vector<std::uint8_t> char_codes{};
+        char_codes.reserve(std::size(firsts) - 1);
+        for (auto i = std::begin(firsts); i != std::prev(std::end(firsts)); ++i)
+        {
+            char_codes.push_back(char_code_at((*i)->first, key_offset));
+        }
+        return char_codes;
+    }
+
     std::uint8_t double_array_builder::char_code_at(const std::string_view& string, const std::size_t index)
     {
         return index < string.length() ? string[index] : double_array::key_terminator();
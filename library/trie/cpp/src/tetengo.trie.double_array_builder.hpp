@@ -12,14 +12,16 @@
 #include <cstddef>
 #include <cstdint>
 #include <iterator> // IWYU pragma: keep
+#include <map>
 #include <memory>
 #include <string_view>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <tetengo/trie/double_array.hpp>
 
+#include "tetengo.trie.occupancy_bitmap.hpp"
+
 
 namespace tetengo::trie
 {
@@ -29,14 +31,57 @@ namespace tetengo::trie
     class double_array_builder
     {
     public:
+        // types
+
+        enum class minimization_type
+        {
+            // Nothing is shared.
+            none,
+
+            // The equivalent suffix subtrees with the same values at the key terminators are shared.
+            terminator_values,
+
+            // The equivalent suffix subtrees are shared, and the values are counted in ascending order of the keys.
+            counted_values,
+        };
+
+        struct placement_type
+        {
+            occupancy_bitmap checks;
+
+            occupancy_bitmap bases;
+        };
+
+
         // static functions
 
         static std::size_t default_density_factor();
 
+        static std::size_t default_build_thread_count();
+
         static std::unique_ptr<storage> build(
             std::vector<std::pair<std::string_view, std::int32_t>> elements,
             const double_array::building_observer_set_type&        observer,
-            std::size_t                                            density_factor);
+            std::size_t                                            density_factor,
+            std::size_t                                            build_thread_count,
+            minimization_type                                      minimization);
+
+        static std::unique_ptr<storage> relocate(
+            const storage&                       storage_,
+            std::size_t                          root_base_check_index,
+            const std::vector<std::string_view>& sample_keys,
+            std::size_t                          density_factor,
+            std::int32_t                         root_value_offset);
+
+        static std::int32_t calc_base(
+            const std::vector<std::uint8_t>& char_codes,
+            std::size_t                      base_check_index,
+            std::size_t                      density_factor,
+            placement_type&                  placement);
+
+        static std::size_t base_bit_index(std::int32_t base);
+
+        static std::uint8_t char_code_at(const std::string_view& string, std::size_t index);
 
 
         // constructors
@@ -51,31 +96,121 @@ namespace tetengo::trie
 
         using element_iterator_type = element_vector_type::const_iterator;
 
+        struct subtree_type
+        {
+            element_iterator_type first;
+
+            element_iterator_type last;
+
+            std::size_t key_offset;
+
+            std::size_t base_check_index;
+        };
+
+        using suffix_signature_type = std::vector<std::pair<std::uint8_t, std::int32_t>>;
+
+        struct minimized_subtree_type
+        {
+            std::int32_t base;
+
+            std::uint32_t key_count;
+        };
+
+        using suffix_register_type = std::map<suffix_signature_type, minimized_subtree_type>;
+
+        using relocated_child_type = std::pair<std::size_t, std::size_t>;
+
+        using relocation_map_type = std::vector<std::int32_t>;
+
 
         // static functions
 
+        static void sort_elements(element_vector_type& elements, std::size_t build_thread_count);
+
+        static void build_parallel(
+            const element_vector_type&                      elements,
+            storage&                                        storage_,
+            const double_array::building_observer_set_type& observer,
+            std::size_t                                     density_factor,
+            std::size_t                                     build_thread_count);
+
+        static std::unique_ptr<storage> build_region(
+            const std::vector<subtree_type>&                subtrees,
+            const double_array::building_observer_set_type& observer,
+            std::size_t                                     density_factor);
+
+        static void merge_region(
+            storage&                         storage_,
+            const storage&                   region,
+            const std::vector<subtree_type>& subtrees,
+            std::size_t                      offset);
+
         static void build_iter(
             element_iterator_type                           first,
             element_iterator_type                           last,
             std::size_t                                     key_offset,
             storage&                                        storage_,
             std::size_t                                     base_check_index,
-            std::unordered_set<std::int32_t>&               base_uniquer,
+            placement_type&                                 placement,
             const double_array::building_observer_set_type& observer,
-            std::size_t                                     density_factor);
+            std::size_t                                     density_factor,
+            std::size_t                                     max_deferred_element_count,
+            std::vector<subtree_type>&                      deferred_subtrees);
 
-        static std::int32_t calc_base(
-            const std::vector<element_iterator_type>& firsts,
-            std::size_t                               key_offset,
-            const storage&                            storage_,
-            std::size_t                               base_check_index,
-            std::size_t                               density_factor,
-            std::unordered_set<std::int32_t>&         base_uniquer);
+        static minimized_subtree_type build_minimized_iter(
+            element_iterator_type                           first,
+            element_iterator_type                           last,
+            std::size_t                                     key_offset,
+            storage&                                        storage_,
+            placement_type&                                 placement,
+            suffix_register_type&                           suffix_register,
+            const double_array::building_observer_set_type& observer,
+            std::size_t                                     density_factor,
+            bool                                            counted);
+
+        static std::size_t top_level_element_count();
+
+        template <typename Accessor>
+        static void relocate_with(
+            const Accessor&                      accessor,
+            std::size_t                          root_base_check_index,
+            const std::vector<std::string_view>& sample_keys,
+            std::size_t                          density_factor,
+            storage&                             relocated);
+
+        template <typename Accessor>
+        static std::vector<std::size_t> count_passes(
+            const Accessor&                      accessor,
+            std::size_t                          root_base_check_index,
+            const std::vector<std::string_view>& sample_keys);
+
+        template <typename Accessor>
+        static void relocate_iter(
+            const Accessor&                 accessor,
+            std::size_t                     base_check_index,
+            storage&                        relocated,
+            std::size_t                     relocated_base_check_index,
+            const std::vector<std::size_t>& pass_counts,
+            placement_type&                 placement,
+            relocation_map_type&            relocated_bases,
+            std::size_t                     density_factor);
+
+        template <typename Accessor>
+        static std::vector<relocated_child_type> relocate_node(
+            const Accessor&                 accessor,
+            std::size_t                     base_check_index,
+            storage&                        relocated,
+            std::size_t                     relocated_base_check_index,
+            const std::vector<std::size_t>& pass_counts,
+            placement_type&                 placement,
+            relocation_map_type&            relocated_bases,
+            std::size_t                     density_factor);
 
         static std::vector<element_iterator_type>
         children_firsts(element_iterator_type first, element_iterator_type last, std::size_t key_offset);
 
-        static std::uint8_t char_code_at(const std::string_view& string, std::size_t index);
+        static std::vector<std::uint8_t>
+        children_char_codes(const std::vector<element_iterator_type>& firsts, std::size_t key_offset);
     };
 
 
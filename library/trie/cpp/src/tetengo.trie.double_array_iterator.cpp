@@ -4,33 +4,51 @@
     Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
 */
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <optional>
-#include <stack>
 #include <stdexcept>
 #include <string>
-#include <type_traits> // IWYU pragma: keep
-#include <utility>
+#include <string_view>
 #include <vector>
 
 #include <tetengo/trie/double_array.hpp>
 #include <tetengo/trie/double_array_iterator.hpp>
 #include <tetengo/trie/storage.hpp>
 
+#include "tetengo.trie.base_check_accessor.hpp"
+
 
 namespace tetengo::trie
 {
-    double_array_iterator::double_array_iterator() : m_p_storage{ nullptr }, m_base_check_index_key_stack{}, m_current{}
+    double_array_iterator::double_array_iterator() :
+    m_p_storage{ nullptr },
+    m_frames{},
+    m_key{},
+    m_current{}
     {}
 
-    double_array_iterator::double_array_iterator(const storage& storage_, const std::size_t root_base_check_index) :
+    double_array_iterator::double_array_iterator(
+        const storage&     storage_,
+        const std::size_t  root_base_check_index,
+        const std::int32_t root_value_offset /*= 0*/) :
     m_p_storage{ &storage_ },
-    m_base_check_index_key_stack{ std::vector<std::pair<std::size_t, std::string>>{
-        std::make_pair(root_base_check_index, std::string{}) } },
+    m_frames{},
+    m_key{},
     m_current{}
     {
+        if (storage_.check_at(root_base_check_index) == double_array::key_terminator())
+        {
+            m_current = storage_.base_at(root_base_check_index) + root_value_offset;
+            return;
+        }
+        with_base_check_accessor(storage_, [this, root_base_check_index, root_value_offset](const auto& accessor) {
+            const auto base = accessor.base_at(root_base_check_index);
+            m_frames.push_back(frame_type{
+                root_base_check_index, base, next_child_char_code(accessor, base, 0), root_value_offset });
+        });
         operator++();
     }
 
@@ -62,15 +80,33 @@ namespace tetengo::trie
         return &operator*();
     }
 
+    std::string_view double_array_iterator::key() const
+    {
+        if (!m_current)
+        {
+            throw std::logic_error{ "Iterator not dereferenceable." };
+        }
+        return m_key;
+    }
+
     bool operator==(const double_array_iterator& one, const double_array_iterator& another)
     {
-        if ((!one.m_p_storage || !another.m_p_storage) && std::empty(one.m_base_check_index_key_stack) &&
-            std::empty(another.m_base_check_index_key_stack) && !one.m_current && !another.m_current)
+        if ((!one.m_p_storage || !another.m_p_storage) && std::empty(one.m_frames) && std::empty(another.m_frames) &&
+            !one.m_current && !another.m_current)
         {
             return true;
         }
         return one.m_p_storage == another.m_p_storage &&
-               one.m_base_check_index_key_stack == another.m_base_check_index_key_stack;
+               std::equal(
+                   std::begin(one.m_frames),
+                   std::end(one.m_frames),
+                   std::begin(another.m_frames),
+                   std::end(another.m_frames),
+                   [](const auto& one_frame, const auto& another_frame) {
+                       return one_frame.base_check_index == another_frame.base_check_index &&
+                              one_frame.next_char_code == another_frame.next_char_code;
+                   }) &&
+               one.m_current == another.m_current;
     }
 
     double_array_iterator& double_array_iterator::operator++()
@@ -79,43 +115,51 @@ namespace tetengo::trie
         return *this;
     }
 
-    std::optional<std::int32_t> double_array_iterator::next()
+    template <typename Accessor>
+    std::optional<std::int32_t> double_array_iterator::next_with(const Accessor& accessor)
     {
-        if (std::empty(m_base_check_index_key_stack))
+        while (!std::empty(m_frames))
         {
-            return std::nullopt;
-        }
-
-        const auto base_check_index = m_base_check_index_key_stack.top().first;
-        const auto key = m_base_check_index_key_stack.top().second;
-        m_base_check_index_key_stack.pop();
-
-        const auto base = m_p_storage->base_at(base_check_index);
-        const auto check = m_p_storage->check_at(base_check_index);
-
-        if (check == double_array::key_terminator())
-        {
-            return std::make_optional(base);
-        }
-
-        for (auto char_code = static_cast<std::int32_t>(0xFE); char_code >= 0; --char_code)
-        {
-            const auto char_code_as_uint8 = static_cast<std::uint8_t>(static_cast<char>(char_code));
-            const auto next_index = base + char_code_as_uint8;
-            if (next_index < 0)
+            auto&      frame = m_frames.back();
+            const auto char_code = frame.next_char_code;
+            if (char_code == double_array::vacant_check_value())
             {
+                m_frames.pop_back();
+                if (!std::empty(m_frames))
+                {
+                    m_key.pop_back();
+                }
                 continue;
             }
-            if (m_p_storage->check_at(next_index) == char_code_as_uint8)
+
+            const auto child_base_check_index = static_cast<std::size_t>(frame.base + char_code);
+            frame.next_char_code = next_child_char_code(accessor, frame.base, char_code + 1);
+            if (char_code == static_cast<std::uint8_t>(double_array::key_terminator()))
             {
-                const auto next_key_tail = char_code_as_uint8 != double_array::key_terminator() ?
-                                               std::string{ static_cast<char>(char_code_as_uint8) } :
-                                               std::string{};
-                m_base_check_index_key_stack.push(std::make_pair(next_index, key + next_key_tail));
+                return std::make_optional(accessor.base_at(child_base_check_index) + frame.value_offset);
             }
+
+            m_key.push_back(static_cast<char>(char_code));
+            const auto child_base = accessor.base_at(child_base_check_index);
+            const auto child_value_offset =
+                frame.value_offset + static_cast<std::int32_t>(accessor.preceding_key_count_at(child_base_check_index));
+            m_frames.push_back(frame_type{ child_base_check_index,
+                                           child_base,
+                                           next_child_char_code(accessor, child_base, 0),
+                                           child_value_offset });
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<std::int32_t> double_array_iterator::next()
+    {
+        if (std::empty(m_frames))
+        {
+            return std::nullopt;
         }
 
-        return next();
+        return with_base_check_accessor(*m_p_storage, [this](const auto& accessor) { return next_with(accessor); });
     }
 
     double_array_iterator double_array_iterator::operator++(int)
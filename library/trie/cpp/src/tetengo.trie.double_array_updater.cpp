@@ -0,0 +1,212 @@
+/*! \file
+    \brief A double array updater.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include <tetengo/trie/double_array.hpp>
+#include <tetengo/trie/storage.hpp>
+
+#include "tetengo.trie.base_check_accessor.hpp"
+#include "tetengo.trie.double_array_updater.hpp"
+
+
+namespace tetengo::trie
+{
+    double_array_updater::double_array_updater(storage& storage_) : m_storage{ storage_ }, m_placement{}
+    {
+        // An element is written as it is, so that an unwritable storage is detected before any modification.
+        m_storage.set_check_at(0, m_storage.check_at(0));
+
+        // The preceding key counts would change on the paths of all the keys after the modified one.
+        if (m_storage.has_preceding_key_counts())
+        {
+            throw std::logic_error{ "A double array whose values are counted cannot be updated." };
+        }
+
+        with_base_check_accessor(m_storage, [this](const auto& accessor) {
+            for (auto i = static_cast<std::size_t>(0); i < accessor.size(); ++i)
+            {
+                const auto check = accessor.check_at(i);
+                if (check == double_array::vacant_check_value())
+                {
+                    continue;
+                }
+                m_placement.checks.occupy(i);
+                if (check != static_cast<std::uint8_t>(double_array::key_terminator()))
+                {
+                    occupy_base_of(i);
+                }
+            }
+        });
+
+        // The element 0 is the root of the whole double array though its check is vacant. Its base is kept even when
+        // it has no child, so that no other node takes it.
+        if (!m_placement.checks.occupied(0))
+        {
+            m_placement.checks.occupy(0);
+            occupy_base_of(0);
+        }
+    }
+
+    bool double_array_updater::insert(
+        const std::size_t       root_base_check_index,
+        const std::string_view& key,
+        const std::int32_t      value)
+    {
+        auto base_check_index = root_base_check_index;
+        auto added = false;
+        for (auto i = static_cast<std::size_t>(0); i <= key.length(); ++i)
+        {
+            const auto char_code = double_array_builder::char_code_at(key, i);
+            if (!added)
+            {
+                if (const auto o_child = child_of(base_check_index, char_code); o_child)
+                {
+                    if (char_code == static_cast<std::uint8_t>(double_array::key_terminator()))
+                    {
+                        return false;
+                    }
+                    base_check_index = *o_child;
+                    continue;
+                }
+            }
+
+            // A node just added has no child, and its base is not set yet.
+            base_check_index = add_child(
+                base_check_index,
+                added ? std::vector<std::uint8_t>{} : children_char_codes_of(base_check_index),
+                char_code);
+            added = true;
+        }
+
+        // The base of a key terminator is not an index but a value.
+        m_storage.set_base_at(base_check_index, value);
+        return true;
+    }
+
+    bool double_array_updater::erase(const std::size_t root_base_check_index, const std::string_view& key)
+    {
+        std::vector<std::size_t> path{ root_base_check_index };
+        for (auto i = static_cast<std::size_t>(0); i <= key.length(); ++i)
+        {
+            const auto o_child = child_of(path.back(), double_array_builder::char_code_at(key, i));
+            if (!o_child)
+            {
+                return false;
+            }
+            path.push_back(*o_child);
+        }
+
+        // The key terminator and the nodes left without any child are vacated from the bottom. The root stays.
+        vacate(path.back());
+        path.pop_back();
+        while (std::size(path) > 1 && std::empty(children_char_codes_of(path.back())))
+        {
+            m_placement.bases.vacate(double_array_builder::base_bit_index(m_storage.base_at(path.back())));
+            vacate(path.back());
+            path.pop_back();
+        }
+
+        return true;
+    }
+
+    void double_array_updater::occupy_base_of(const std::size_t base_check_index)
+    {
+        const auto base_bit_index = double_array_builder::base_bit_index(m_storage.base_at(base_check_index));
+        if (m_placement.bases.occupied(base_bit_index))
+        {
+            throw std::logic_error{ "A double array sharing its elements among nodes cannot be updated." };
+        }
+        m_placement.bases.occupy(base_bit_index);
+    }
+
+    std::optional<std::size_t>
+    double_array_updater::child_of(const std::size_t base_check_index, const std::uint8_t char_code) const
+    {
+        const auto child_base_check_index = m_storage.base_at(base_check_index) + char_code;
+        if (child_base_check_index < 0 ||
+            static_cast<std::size_t>(child_base_check_index) >= m_storage.base_check_size() ||
+            m_storage.check_at(static_cast<std::size_t>(child_base_check_index)) != char_code)
+        {
+            return std::nullopt;
+        }
+        return std::make_optional(static_cast<std::size_t>(child_base_check_index));
+    }
+
+    std::vector<std::uint8_t> double_array_updater::children_char_codes_of(const std::size_t base_check_index) const
+    {
+        std::vector<std::uint8_t> char_codes{};
+        for (auto char_code = static_cast<std::int32_t>(0); char_code < double_array::vacant_check_value(); ++char_code)
+        {
+            if (child_of(base_check_index, static_cast<std::uint8_t>(char_code)))
+            {
+                char_codes.push_back(static_cast<std::uint8_t>(char_code));
+            }
+        }
+        return char_codes;
+    }
+
+    std::size_t double_array_updater::add_child(
+        const std::size_t                base_check_index,
+        const std::vector<std::uint8_t>& char_codes,
+        const std::uint8_t               char_code)
+    {
+        const auto base = m_storage.base_at(base_check_index);
+        if (!std::empty(char_codes))
+        {
+            const auto child_base_check_index = base + char_code;
+            if (child_base_check_index > 0 &&
+                !m_placement.checks.occupied(static_cast<std::size_t>(child_base_check_index)))
+            {
+                m_storage.set_check_at(static_cast<std::size_t>(child_base_check_index), char_code);
+                m_placement.checks.occupy(static_cast<std::size_t>(child_base_check_index));
+                return static_cast<std::size_t>(child_base_check_index);
+            }
+        }
+
+        // On a conflict, the children are moved to a base where all of them and the new one fit. Since a check holds
+        // not the parent but a label, the grandchildren need not be modified.
+        auto new_char_codes = char_codes;
+        new_char_codes.insert(
+            std::upper_bound(std::begin(new_char_codes), std::end(new_char_codes), char_code), char_code);
+        const auto new_base = double_array_builder::calc_base(
+            new_char_codes, base_check_index, double_array_builder::default_density_factor(), m_placement);
+        for (const auto moved_char_code: char_codes)
+        {
+            const auto from = static_cast<std::size_t>(base + moved_char_code);
+            const auto to = static_cast<std::size_t>(new_base + moved_char_code);
+            m_storage.set_base_at(to, m_storage.base_at(from));
+            m_storage.set_check_at(to, moved_char_code);
+            m_placement.checks.occupy(to);
+            vacate(from);
+        }
+        if (!std::empty(char_codes))
+        {
+            m_placement.bases.vacate(double_array_builder::base_bit_index(base));
+        }
+        m_storage.set_base_at(base_check_index, new_base);
+
+        const auto child_base_check_index = static_cast<std::size_t>(new_base + char_code);
+        m_storage.set_check_at(child_base_check_index, char_code);
+        m_placement.checks.occupy(child_base_check_index);
+        return child_base_check_index;
+    }
+
+    void double_array_updater::vacate(const std::size_t base_check_index)
+    {
+        m_storage.set_base_at(base_check_index, 0);
+        m_storage.set_check_at(base_check_index, double_array::vacant_check_value());
+        m_placement.checks.vacate(base_check_index);
+    }
+
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*! \file
+    \brief A double array updater.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#if !defined(TETENGO_TRIE_DOUBLEARRAYUPDATER_HPP)
+#define TETENGO_TRIE_DOUBLEARRAYUPDATER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "tetengo.trie.double_array_builder.hpp"
+
+
+namespace tetengo::trie
+{
+    class storage;
+
+
+    class double_array_updater : private boost::noncopyable
+    {
+    public:
+        // constructors
+
+        explicit double_array_updater(storage& storage_);
+
+
+        // functions
+
+        bool insert(std::size_t root_base_check_index, const std::string_view& key, std::int32_t value);
+
+        bool erase(std::size_t root_base_check_index, const std::string_view& key);
+
+
+    private:
+        // variables
+
+        storage& m_storage;
+
+        double_array_builder::placement_type m_placement;
+
+
+        // functions
+
+        void occupy_base_of(std::size_t base_check_index);
+
+        std::optional<std::size_t> child_of(std::size_t base_check_index, std::uint8_t char_code) const;
+
+        std::vector<std::uint8_t> children_char_codes_of(std::size_t base_check_index) const;
+
+        std::size_t
+        add_child(std::size_t base_check_index, const std::vector<std::uint8_t>& char_codes, std::uint8_t char_code);
+
+        void vacate(std::size_t base_check_index);
+    };
+
+
+}
+
+
+#endif
+
+#endif
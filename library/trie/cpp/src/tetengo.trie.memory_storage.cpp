@@ -6,15 +6,17 @@
 
 #include <algorithm>
 #include <any>
+#include <bit>
 #include <cassert>
 #include <cstddef> // IWYU pragma: keep
 #include <cstdint>
+#include <functional>
 #include <istream>
 #include <iterator>
 #include <limits>
 #include <memory>
 #include <optional>
-#include <type_traits>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -26,55 +28,290 @@
 #include <tetengo/trie/storage.hpp>
 #include <tetengo/trie/value_serializer.hpp>
 
+#include "tetengo.trie.base_check_layout.hpp"
+#include "tetengo.trie.prefetch.hpp"
+#include "tetengo.trie.storage_format.hpp"
+#include "tetengo.trie.value_section_layout.hpp"
+
 
 namespace tetengo::trie
 {
     class memory_storage::impl : private boost::noncopyable
     {
     public:
+        // static functions
+
+        static void serialize_value_array(
+            std::ostream&                                                       output_stream,
+            const value_serializer&                                             value_serializer_,
+            const std::size_t                                                   value_count,
+            const std::function<std::optional<std::vector<char>>(std::size_t)>& serialized_value_at)
+        {
+            assert(value_count < std::numeric_limits<std::uint32_t>::max());
+            write_uint32(output_stream, static_cast<std::uint32_t>(value_count));
+
+            if (value_serializer_.indexed())
+            {
+                write_uint32(output_stream, indexed_value_size_marker());
+
+                std::vector<char> values{};
+                write_uint32(output_stream, 0);
+                for (auto i = static_cast<std::size_t>(0); i < value_count; ++i)
+                {
+                    if (const auto o_serialized = serialized_value_at(i); o_serialized)
+                    {
+                        if (std::size(values) + std::size(*o_serialized) > std::numeric_limits<std::uint32_t>::max())
+                        {
+                            throw std::length_error{ "The values are too large to be indexed." };
+                        }
+                        values.insert(std::end(values), std::begin(*o_serialized), std::end(*o_serialized));
+                    }
+                    write_uint32(output_stream, static_cast<std::uint32_t>(std::size(values)));
+                }
+                output_stream.write(std::data(values), std::size(values));
+                return;
+            }
+
+            assert(value_serializer_.fixed_value_size() < std::numeric_limits<std::uint32_t>::max());
+            const auto fixed_value_size = static_cast<std::uint32_t>(value_serializer_.fixed_value_size());
+            write_uint32(output_stream, fixed_value_size);
+
+            if (fixed_value_size == 0)
+            {
+                for (auto i = static_cast<std::size_t>(0); i < value_count; ++i)
+                {
+                    if (const auto o_serialized = serialized_value_at(i); o_serialized)
+                    {
+                        assert(std::size(*o_serialized) < std::numeric_limits<std::uint32_t>::max());
+                        write_uint32(output_stream, static_cast<std::uint32_t>(std::size(*o_serialized)));
+                        output_stream.write(std::data(*o_serialized), std::size(*o_serialized));
+                    }
+                    else
+                    {
+                        write_uint32(output_stream, 0);
+                    }
+                }
+            }
+            else
+            {
+                for (auto i = static_cast<std::size_t>(0); i < value_count; ++i)
+                {
+                    if (const auto o_serialized = serialized_value_at(i); o_serialized)
+                    {
+                        assert(std::size(*o_serialized) == fixed_value_size);
+                        output_stream.write(std::data(*o_serialized), fixed_value_size);
+                    }
+                    else
+                    {
+                        std::vector<char> uninitialized(fixed_value_size, uninitialized_value_byte());
+                        output_stream.write(std::data(uninitialized), fixed_value_size);
+                    }
+                }
+            }
+        }
+
         // constructors and destructor
 
-        impl() : m_base_check_array{ 0x00000000U | double_array::vacant_check_value() }, m_value_array{} {};
+        impl() :
+        m_v2{ false },
+        m_wide{ false },
+        m_base_check_array{ 0x00000000U | double_array::vacant_check_value() },
+        m_wide_base_check_array{},
+        m_preceding_key_counts{},
+        m_value_array{},
+        m_vacant_value_indices{} {};
+
+        explicit impl(std::istream& input_stream) :
+        m_v2{ false },
+        m_wide{ false },
+        m_base_check_array{},
+        m_wide_base_check_array{},
+        m_preceding_key_counts{},
+        m_value_array{},
+        m_vacant_value_indices{}
+        {
+            deserialize_base_check_array(input_stream);
+        };
 
         explicit impl(std::istream& input_stream, const value_deserializer& value_deserializer_) :
+        m_v2{ false },
+        m_wide{ false },
         m_base_check_array{},
-        m_value_array{}
+        m_wide_base_check_array{},
+        m_preceding_key_counts{},
+        m_value_array{},
+        m_vacant_value_indices{}
         {
-            deserialize(input_stream, value_deserializer_, m_base_check_array, m_value_array);
+            deserialize_base_check_array(input_stream);
+            deserialize_value_array(
+                input_stream,
+                [this](const std::size_t value_count) { m_value_array.reserve(value_count); },
+                [this, &value_deserializer_](const std::vector<char>* const p_serialized) {
+                    if (p_serialized)
+                    {
+                        m_value_array.emplace_back(value_deserializer_(*p_serialized));
+                    }
+                    else
+                    {
+                        m_vacant_value_indices.push_back(std::size(m_value_array));
+                        m_value_array.emplace_back(std::nullopt);
+                    }
+                });
         };
 
 
         // functions
 
+        void deserialize_value_array(
+            std::istream&                                         input_stream,
+            const std::function<void(std::size_t)>&               reserve,
+            const std::function<void(const std::vector<char>*)>& add_serialized_value) const
+        {
+            if (m_v2)
+            {
+                deserialize_v2_value_array(input_stream, reserve, add_serialized_value);
+                return;
+            }
+
+            const auto size = read_uint32(input_stream);
+            reserve(size);
+
+            const auto fixed_value_size = read_uint32(input_stream);
+
+            if (fixed_value_size == indexed_value_size_marker())
+            {
+                std::vector<std::uint32_t> offsets{};
+                read_word_array<std::uint32_t, true>(input_stream, static_cast<std::size_t>(size) + 1, offsets);
+                deserialize_indexed_values(input_stream, offsets, add_serialized_value);
+            }
+            else if (fixed_value_size == 0)
+            {
+                std::vector<char> to_deserialize{};
+                for (auto i = static_cast<std::uint32_t>(0); i < size; ++i)
+                {
+                    const auto element_size = read_uint32(input_stream);
+                    if (element_size > 0)
+                    {
+                        to_deserialize.resize(element_size);
+                        read_value(input_stream, to_deserialize);
+                        add_serialized_value(&to_deserialize);
+                    }
+                    else
+                    {
+                        add_serialized_value(nullptr);
+                    }
+                }
+            }
+            else
+            {
+                deserialize_fixed_size_values(input_stream, size, fixed_value_size, add_serialized_value);
+            }
+        }
+
         std::size_t base_check_size_impl() const
         {
-            return std::size(m_base_check_array);
+            return m_wide ? std::size(m_wide_base_check_array) : std::size(m_base_check_array);
         }
 
         std::int32_t base_at_impl(const std::size_t base_check_index) const
         {
             ensure_base_check_size(base_check_index + 1);
-            return static_cast<std::int32_t>(m_base_check_array[base_check_index]) >> 8;
+            return m_wide ? wide_base_of(m_wide_base_check_array[base_check_index]) :
+                            narrow_base_of(m_base_check_array[base_check_index]);
         }
 
         void set_base_at_impl(const std::size_t base_check_index, const std::int32_t base)
         {
+            if (!m_wide && !fits_narrow_base(base))
+            {
+                widen();
+            }
+
             ensure_base_check_size(base_check_index + 1);
-            m_base_check_array[base_check_index] &= 0x000000FF;
-            m_base_check_array[base_check_index] |= static_cast<std::uint32_t>(base << 8);
+            if (m_wide)
+            {
+                auto& base_check = m_wide_base_check_array[base_check_index];
+                base_check = wide_base_check_of(base, base_check & 0xFF);
+            }
+            else
+            {
+                auto& base_check = m_base_check_array[base_check_index];
+                base_check = narrow_base_check_of(base, base_check & 0xFF);
+            }
         }
 
         std::uint8_t check_at_impl(const std::size_t base_check_index) const
         {
             ensure_base_check_size(base_check_index + 1);
-            return m_base_check_array[base_check_index] & 0xFF;
+            return m_wide ? m_wide_base_check_array[base_check_index] & 0xFF :
+                            m_base_check_array[base_check_index] & 0xFF;
         }
 
         void set_check_at_impl(const std::size_t base_check_index, const std::uint8_t check)
         {
             ensure_base_check_size(base_check_index + 1);
-            m_base_check_array[base_check_index] &= 0xFFFFFF00;
-            m_base_check_array[base_check_index] |= check;
+            if (m_wide)
+            {
+                m_wide_base_check_array[base_check_index] &= ~static_cast<std::uint64_t>(0xFF);
+                m_wide_base_check_array[base_check_index] |= check;
+            }
+            else
+            {
+                m_base_check_array[base_check_index] &= 0xFFFFFF00;
+                m_base_check_array[base_check_index] |= check;
+            }
+        }
+
+        void prefetch_base_check_at_impl(const std::size_t base_check_index) const
+        {
+            if (base_check_index >= base_check_size_impl())
+            {
+                return;
+            }
+            if (m_wide)
+            {
+                prefetch(&m_wide_base_check_array[base_check_index]);
+            }
+            else
+            {
+                prefetch(&m_base_check_array[base_check_index]);
+            }
+        }
+
+        std::optional<base_check_array_view_type> base_check_array_view_impl() const
+        {
+            if (m_wide)
+            {
+                return std::make_optional(base_check_array_view_type{ base_check_array_view_type::layout_type::wide,
+                                                                      std::data(m_wide_base_check_array),
+                                                                      std::size(m_wide_base_check_array) });
+            }
+            else
+            {
+                return std::make_optional(base_check_array_view_type{ base_check_array_view_type::layout_type::narrow,
+                                                                      std::data(m_base_check_array),
+                                                                      std::size(m_base_check_array) });
+            }
+        }
+
+        bool has_preceding_key_counts_impl() const
+        {
+            return !std::empty(m_preceding_key_counts);
+        }
+
+        std::uint32_t preceding_key_count_at_impl(const std::size_t base_check_index) const
+        {
+            return base_check_index < std::size(m_preceding_key_counts) ? m_preceding_key_counts[base_check_index] : 0;
+        }
+
+        void
+        set_preceding_key_count_at_impl(const std::size_t base_check_index, const std::uint32_t preceding_key_count)
+        {
+            if (base_check_index >= std::size(m_preceding_key_counts))
+            {
+                m_preceding_key_counts.resize(base_check_index + 1, 0);
+            }
+            m_preceding_key_counts[base_check_index] = preceding_key_count;
         }
 
         std::size_t value_count_impl() const
@@ -95,34 +332,91 @@ namespace tetengo::trie
         {
             if (value_index >= std::size(m_value_array))
             {
+                for (auto i = std::size(m_value_array); i < value_index; ++i)
+                {
+                    m_vacant_value_indices.push_back(i);
+                }
                 m_value_array.resize(value_index + 1, std::nullopt);
             }
+            else if (!m_value_array[value_index])
+            {
+                m_vacant_value_indices.erase(
+                    std::find(std::begin(m_vacant_value_indices), std::end(m_vacant_value_indices), value_index));
+            }
             m_value_array[value_index] = std::move(value);
         }
 
+        void erase_value_at_impl(const std::size_t value_index)
+        {
+            if (value_index >= std::size(m_value_array) || !m_value_array[value_index])
+            {
+                return;
+            }
+            m_value_array[value_index] = std::nullopt;
+            m_vacant_value_indices.push_back(value_index);
+        }
+
+        std::size_t vacant_value_count_impl() const
+        {
+            return std::size(m_vacant_value_indices);
+        }
+
+        std::optional<std::size_t> vacant_value_index_impl() const
+        {
+            return std::empty(m_vacant_value_indices) ? std::nullopt :
+                                                        std::make_optional(m_vacant_value_indices.back());
+        }
+
         double filling_rate_impl() const
         {
             const auto empty_count =
-                std::count(std::begin(m_base_check_array), std::end(m_base_check_array), 0x000000FFU);
-            return 1.0 - static_cast<double>(empty_count) / std::size(m_base_check_array);
+                m_wide ? std::count(
+                             std::begin(m_wide_base_check_array),
+                             std::end(m_wide_base_check_array),
+                             static_cast<std::uint64_t>(0x000000FFU)) :
+                         std::count(std::begin(m_base_check_array), std::end(m_base_check_array), 0x000000FFU);
+            return 1.0 - static_cast<double>(empty_count) / base_check_size_impl();
         }
 
         void serialize_impl(std::ostream& output_stream, const value_serializer& value_serializer_) const
+        {
+            serialize_base_check_array(output_stream);
+            serialize_value_array(
+                output_stream,
+                value_serializer_,
+                std::size(m_value_array),
+                [this, &value_serializer_](const std::size_t value_index) {
+                    const auto& o_value = m_value_array[value_index];
+                    return o_value ? std::make_optional(value_serializer_(*o_value)) : std::nullopt;
+                });
+        }
+
+        void serialize_base_check_array(std::ostream& output_stream) const
         {
             if (!output_stream)
             {
                 throw std::ios_base::failure{ "Bad output_stream." };
             }
 
-            serialize_base_check_array(output_stream, m_base_check_array);
-            serialize_value_array(output_stream, value_serializer_, m_value_array);
+            if (m_wide)
+            {
+                serialize_wide_base_check_array(output_stream, m_wide_base_check_array);
+            }
+            else
+            {
+                serialize_narrow_base_check_array(output_stream, m_base_check_array);
+            }
         }
 
         std::unique_ptr<storage> clone_impl() const
         {
             auto p_clone = std::make_unique<memory_storage>();
+            p_clone->m_p_impl->m_wide = m_wide;
             p_clone->m_p_impl->m_base_check_array = m_base_check_array;
+            p_clone->m_p_impl->m_wide_base_check_array = m_wide_base_check_array;
+            p_clone->m_p_impl->m_preceding_key_counts = m_preceding_key_counts;
             p_clone->m_p_impl->m_value_array = m_value_array;
+            p_clone->m_p_impl->m_vacant_value_indices = m_vacant_value_indices;
             return p_clone;
         }
 
@@ -130,8 +424,9 @@ namespace tetengo::trie
     private:
         // static functions
 
-        static void
-        serialize_base_check_array(std::ostream& output_stream, const std::vector<std::uint32_t>& base_check_array)
+        static void serialize_narrow_base_check_array(
+            std::ostream&                     output_stream,
+            const std::vector<std::uint32_t>& base_check_array)
         {
             assert(std::size(base_check_array) < std::numeric_limits<std::uint32_t>::max());
             write_uint32(output_stream, static_cast<std::uint32_t>(std::size(base_check_array)));
@@ -141,51 +436,16 @@ namespace tetengo::trie
             }
         }
 
-        static void serialize_value_array(
-            std::ostream&                               output_stream,
-            const value_serializer&                     value_serializer_,
-            const std::vector<std::optional<std::any>>& value_array)
+        static void serialize_wide_base_check_array(
+            std::ostream&                     output_stream,
+            const std::vector<std::uint64_t>& wide_base_check_array)
         {
-            assert(std::size(value_array) < std::numeric_limits<std::uint32_t>::max());
-            write_uint32(output_stream, static_cast<std::uint32_t>(std::size(value_array)));
-
-            assert(value_serializer_.fixed_value_size() < std::numeric_limits<std::uint32_t>::max());
-            const auto fixed_value_size = static_cast<std::uint32_t>(value_serializer_.fixed_value_size());
-            write_uint32(output_stream, fixed_value_size);
-
-            if (fixed_value_size == 0)
-            {
-                for (const auto& v: value_array)
-                {
-                    if (v)
-                    {
-                        const auto serialized = value_serializer_(*v);
-                        assert(std::size(serialized) < std::numeric_limits<std::uint32_t>::max());
-                        write_uint32(output_stream, static_cast<std::uint32_t>(std::size(serialized)));
-                        output_stream.write(std::data(serialized), std::size(serialized));
-                    }
-                    else
-                    {
-                        write_uint32(output_stream, 0);
-                    }
-                }
-            }
-            else
+            write_uint32(output_stream, wide_base_check_marker());
+            assert(std::size(wide_base_check_array) < std::numeric_limits<std::uint32_t>::max());
+            write_uint32(output_stream, static_cast<std::uint32_t>(std::size(wide_base_check_array)));
+            for (const auto v: wide_base_check_array)
             {
-                for (const auto& v: value_array)
-                {
-                    if (v)
-                    {
-                        const auto serialized = value_serializer_(*v);
-                        assert(std::size(serialized) == fixed_value_size);
-                        output_stream.write(std::data(serialized), fixed_value_size);
-                    }
-                    else
-                    {
-                        std::vector<char> uninitialized(fixed_value_size, uninitialized_byte());
-                        output_stream.write(std::data(uninitialized), fixed_value_size);
-                    }
-                }
+                write_uint64(output_stream, v);
             }
         }
 
@@ -197,128 +457,289 @@ namespace tetengo::trie
             output_stream.write(std::data(serialized), std::size(serialized));
         }
 
-        static void deserialize(
-            std::istream&                         input_stream,
-            const value_deserializer&             value_deserializer_,
-            std::vector<std::uint32_t>&           base_check_array,
-            std::vector<std::optional<std::any>>& value_array)
+        static void write_uint64(std::ostream& output_stream, const std::uint64_t value)
+        {
+            static const default_serializer<std::uint64_t> uint64_serializer{ false };
+
+            const auto serialized = uint64_serializer(value);
+            output_stream.write(std::data(serialized), std::size(serialized));
+        }
+
+        static std::uint32_t read_uint32(std::istream& input_stream)
         {
-            deserialize_base_check_array(input_stream, base_check_array);
-            deserialize_value_array(input_stream, value_deserializer_, value_array);
+            return read_word<std::uint32_t, true>(input_stream);
         }
 
-        static void
-        deserialize_base_check_array(std::istream& input_stream, std::vector<std::uint32_t>& base_check_array)
+        template <typename UInt, bool BigEndian>
+        static UInt read_word(std::istream& input_stream)
         {
-            const auto size = read_uint32(input_stream);
-            base_check_array.reserve(size);
-            for (auto i = static_cast<std::uint32_t>(0); i < size; ++i)
+            char bytes[sizeof(UInt)]{};
+            input_stream.read(bytes, sizeof(UInt));
+            if (input_stream.gcount() < static_cast<std::streamsize>(sizeof(UInt)))
             {
-                base_check_array.push_back(read_uint32(input_stream));
+                throw std::ios_base::failure("Can't read a word.");
             }
+            return BigEndian ? load_big_endian<UInt>(bytes) : load_little_endian<UInt>(bytes);
         }
 
-        static void deserialize_value_array(
-            std::istream&                         input_stream,
-            const value_deserializer&             value_deserializer_,
-            std::vector<std::optional<std::any>>& value_array)
+        template <typename UInt, bool BigEndian>
+        static void read_word_array(std::istream& input_stream, const std::size_t size, std::vector<UInt>& array)
         {
-            const auto size = read_uint32(input_stream);
-            value_array.reserve(size);
+            static constexpr std::size_t chunk_size = 0x10000;
 
-            const auto fixed_value_size = read_uint32(input_stream);
-
-            if (fixed_value_size == 0)
+            array.reserve(std::size(array) + std::min(size, chunk_size));
+            for (auto offset = static_cast<std::size_t>(0); offset < size; offset += chunk_size)
             {
-                for (auto i = static_cast<std::uint32_t>(0); i < size; ++i)
+                const auto element_count = std::min(size - offset, chunk_size);
+                const auto head = std::size(array);
+                array.resize(head + element_count);
+                auto* const p_bytes = reinterpret_cast<char*>(std::data(array) + head);
+                input_stream.read(p_bytes, sizeof(UInt) * element_count);
+                if (input_stream.gcount() < static_cast<std::streamsize>(sizeof(UInt) * element_count))
                 {
-                    const auto element_size = read_uint32(input_stream);
-                    if (element_size > 0)
-                    {
-                        std::vector<char> to_deserialize(element_size, 0);
-                        input_stream.read(std::data(to_deserialize), element_size);
-                        if (input_stream.gcount() < static_cast<std::streamsize>(element_size))
-                        {
-                            throw std::ios_base::failure("Can't read value.");
-                        }
-                        value_array.push_back(value_deserializer_(to_deserialize));
-                    }
-                    else
+                    throw std::ios_base::failure("Can't read a word array.");
+                }
+                if constexpr (BigEndian ? std::endian::native != std::endian::big :
+                                          std::endian::native != std::endian::little)
+                {
+                    for (auto i = static_cast<std::size_t>(0); i < element_count; ++i)
                     {
-                        std::remove_reference_t<decltype(value_array)>::value_type nullopt_{};
-                        value_array.push_back(std::move(nullopt_));
+                        array[head + i] = BigEndian ? load_big_endian<UInt>(p_bytes + sizeof(UInt) * i) :
+                                                      load_little_endian<UInt>(p_bytes + sizeof(UInt) * i);
                     }
                 }
             }
+        }
+
+        static void skip(std::istream& input_stream, const std::uint64_t size)
+        {
+            if (size == 0)
+            {
+                return;
+            }
+            input_stream.ignore(static_cast<std::streamsize>(size));
+            if (input_stream.gcount() < static_cast<std::streamsize>(size))
+            {
+                throw std::ios_base::failure("Can't skip the padding.");
+            }
+        }
+
+        static void read_value(std::istream& input_stream, std::vector<char>& value)
+        {
+            input_stream.read(std::data(value), std::size(value));
+            if (input_stream.gcount() < static_cast<std::streamsize>(std::size(value)))
+            {
+                throw std::ios_base::failure("Can't read value.");
+            }
+        }
+
+        static void deserialize_v2_value_array(
+            std::istream&                                         input_stream,
+            const std::function<void(std::size_t)>&               reserve,
+            const std::function<void(const std::vector<char>*)>& add_serialized_value)
+        {
+            const auto size = static_cast<std::size_t>(read_word<std::uint64_t, false>(input_stream));
+            reserve(size);
+
+            const auto fixed_value_size = read_word<std::uint32_t, false>(input_stream);
+            read_word<std::uint32_t, false>(input_stream);
+
+            if (fixed_value_size == 0)
+            {
+                std::vector<std::uint64_t> offsets{};
+                read_word_array<std::uint64_t, false>(input_stream, size + 1, offsets);
+                deserialize_indexed_values(input_stream, offsets, add_serialized_value);
+            }
             else
             {
-                for (auto i = static_cast<std::uint32_t>(0); i < size; ++i)
-                {
-                    std::vector<char> to_deserialize(fixed_value_size, 0);
-                    input_stream.read(std::data(to_deserialize), fixed_value_size);
-                    if (input_stream.gcount() < static_cast<std::streamsize>(fixed_value_size))
-                    {
-                        throw std::ios_base::failure("Can't read value.");
-                    }
-                    if (std::all_of(std::begin(to_deserialize), std::end(to_deserialize), [](const auto e) {
-                            return e == uninitialized_byte();
-                        }))
-                    {
-                        std::remove_reference_t<decltype(value_array)>::value_type nullopt_{};
-                        value_array.push_back(std::move(nullopt_));
-                    }
-                    else
-                    {
-                        value_array.push_back(value_deserializer_(to_deserialize));
-                    }
-                }
+                deserialize_fixed_size_values(input_stream, size, fixed_value_size, add_serialized_value);
             }
         }
 
-        static std::uint32_t read_uint32(std::istream& input_stream)
+        template <typename Offset>
+        static void deserialize_indexed_values(
+            std::istream&                                         input_stream,
+            const std::vector<Offset>&                            offsets,
+            const std::function<void(const std::vector<char>*)>& add_serialized_value)
         {
-            static const default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            for (auto i = static_cast<std::size_t>(0); i + 1 < std::size(offsets); ++i)
+            {
+                if (offsets[i + 1] < offsets[i])
+                {
+                    throw std::ios_base::failure("Broken value offset.");
+                }
+            }
+
+            std::vector<char> values(std::empty(offsets) ? 0 : static_cast<std::size_t>(offsets.back()), 0);
+            read_value(input_stream, values);
 
             std::vector<char> to_deserialize{};
-            to_deserialize.reserve(sizeof(std::uint32_t));
-            for (auto i = static_cast<std::size_t>(0); i < sizeof(std::uint32_t); ++i)
+            for (auto i = static_cast<std::size_t>(0); i + 1 < std::size(offsets); ++i)
             {
-                auto byte_ = static_cast<char>(0);
-                input_stream.read(&byte_, sizeof(char));
-                if (input_stream.gcount() < static_cast<std::streamsize>(sizeof(char)))
+                if (offsets[i + 1] > offsets[i])
                 {
-                    throw std::ios_base::failure("Can't read uint32.");
+                    to_deserialize.assign(
+                        std::next(std::begin(values), static_cast<std::ptrdiff_t>(offsets[i])),
+                        std::next(std::begin(values), static_cast<std::ptrdiff_t>(offsets[i + 1])));
+                    add_serialized_value(&to_deserialize);
+                }
+                else
+                {
+                    add_serialized_value(nullptr);
                 }
-                to_deserialize.push_back(byte_);
             }
-            return uint32_deserializer(to_deserialize);
         }
 
-        static constexpr char uninitialized_byte()
+        static void deserialize_fixed_size_values(
+            std::istream&                                         input_stream,
+            const std::size_t                                     size,
+            const std::size_t                                     fixed_value_size,
+            const std::function<void(const std::vector<char>*)>& add_serialized_value)
         {
-            return static_cast<char>(0xFF);
+            const auto chunk_value_count = std::max<std::size_t>(0x10000 / fixed_value_size, 1);
+
+            std::vector<char> chunk{};
+            std::vector<char> to_deserialize(fixed_value_size, 0);
+            for (auto offset = static_cast<std::size_t>(0); offset < size; offset += chunk_value_count)
+            {
+                const auto value_count = std::min(size - offset, chunk_value_count);
+                chunk.resize(fixed_value_size * value_count);
+                read_value(input_stream, chunk);
+                for (auto i = static_cast<std::size_t>(0); i < value_count; ++i)
+                {
+                    const auto first = std::next(std::begin(chunk), static_cast<std::ptrdiff_t>(fixed_value_size * i));
+                    const auto last = std::next(first, static_cast<std::ptrdiff_t>(fixed_value_size));
+                    if (std::all_of(first, last, [](const auto e) { return e == uninitialized_value_byte(); }))
+                    {
+                        add_serialized_value(nullptr);
+                    }
+                    else
+                    {
+                        to_deserialize.assign(first, last);
+                        add_serialized_value(&to_deserialize);
+                    }
+                }
+            }
         }
 
 
         // variables
 
+        bool m_v2;
+
+        bool m_wide;
+
         mutable std::vector<std::uint32_t> m_base_check_array;
 
+        mutable std::vector<std::uint64_t> m_wide_base_check_array;
+
+        std::vector<std::uint32_t> m_preceding_key_counts;
+
         std::vector<std::optional<std::any>> m_value_array;
 
+        std::vector<std::size_t> m_vacant_value_indices;
+
 
         // functions
 
+        void deserialize_base_check_array(std::istream& input_stream)
+        {
+            const auto first_word = read_uint32(input_stream);
+            if (first_word == v2_magic_head_word())
+            {
+                deserialize_v2_base_check_array(input_stream);
+            }
+            else if (first_word == wide_base_check_marker())
+            {
+                m_wide = true;
+                const auto size = read_uint32(input_stream);
+                read_word_array<std::uint64_t, true>(input_stream, size, m_wide_base_check_array);
+            }
+            else
+            {
+                const auto size = first_word;
+                read_word_array<std::uint32_t, true>(input_stream, size, m_base_check_array);
+            }
+        }
+
+        void deserialize_v2_base_check_array(std::istream& input_stream)
+        {
+            std::vector<char> header(v2_header_size(), 0);
+            for (auto i = static_cast<std::size_t>(0); i < sizeof(std::uint32_t); ++i)
+            {
+                header[i] = v2_magic_byte_at(i);
+            }
+            input_stream.read(std::data(header) + sizeof(std::uint32_t), v2_header_size() - sizeof(std::uint32_t));
+            if (input_stream.gcount() < static_cast<std::streamsize>(v2_header_size() - sizeof(std::uint32_t)))
+            {
+                throw std::ios_base::failure("Can't read the header.");
+            }
+            const auto v2_header = load_v2_header(std::data(header), 0);
+
+            m_v2 = true;
+            m_wide = v2_header.wide();
+            skip(input_stream, v2_header.base_check_offset - v2_header_size());
+            const auto size = static_cast<std::size_t>(v2_header.base_check_count);
+            if (m_wide)
+            {
+                read_word_array<std::uint64_t, false>(input_stream, size, m_wide_base_check_array);
+            }
+            else
+            {
+                read_word_array<std::uint32_t, false>(input_stream, size, m_base_check_array);
+            }
+            auto tail = v2_header.base_check_offset + v2_header.base_check_count * v2_header.base_check_element_size();
+            if (v2_header.counted())
+            {
+                skip(input_stream, v2_header.preceding_key_count_offset - tail);
+                read_word_array<std::uint32_t, false>(input_stream, size, m_preceding_key_counts);
+                tail = v2_header.preceding_key_count_offset + v2_header.base_check_count * sizeof(std::uint32_t);
+            }
+            skip(input_stream, v2_header.value_section_offset - tail);
+        }
+
+        void widen()
+        {
+            assert(!m_wide);
+            m_wide_base_check_array.reserve(std::size(m_base_check_array));
+            for (const auto v: m_base_check_array)
+            {
+                m_wide_base_check_array.push_back(wide_base_check_of(narrow_base_of(v), v & 0xFF));
+            }
+            m_base_check_array.clear();
+            m_base_check_array.shrink_to_fit();
+            m_wide = true;
+        }
+
         void ensure_base_check_size(const std::size_t size) const
         {
-            if (size > std::size(m_base_check_array))
+            if (m_wide)
             {
-                m_base_check_array.resize(size, 0x00000000U | double_array::vacant_check_value());
+                if (size > std::size(m_wide_base_check_array))
+                {
+                    m_wide_base_check_array.resize(size, wide_base_check_of(0, double_array::vacant_check_value()));
+                }
+            }
+            else
+            {
+                if (size > std::size(m_base_check_array))
+                {
+                    m_base_check_array.resize(size, narrow_base_check_of(0, double_array::vacant_check_value()));
+                }
             }
         }
     };
 
 
+    void memory_storage::serialize_value_array(
+        std::ostream&                                                       output_stream,
+        const value_serializer&                                             value_serializer_,
+        const std::size_t                                                   value_count,
+        const std::function<std::optional<std::vector<char>>(std::size_t)>& serialized_value_at)
+    {
+        impl::serialize_value_array(output_stream, value_serializer_, value_count, serialized_value_at);
+    }
+
     memory_storage::memory_storage() : m_p_impl{ std::make_unique<impl>() } {}
 
     memory_storage::memory_storage(std::istream& input_stream, const value_deserializer& value_deserializer_) :
@@ -327,6 +748,21 @@ namespace tetengo::trie
 
     memory_storage::~memory_storage() = default;
 
+    memory_storage::memory_storage(std::istream& input_stream) : m_p_impl{ std::make_unique<impl>(input_stream) } {}
+
+    void memory_storage::deserialize_value_array(
+        std::istream&                                         input_stream,
+        const std::function<void(std::size_t)>&               reserve,
+        const std::function<void(const std::vector<char>*)>& add_serialized_value) const
+    {
+        m_p_impl->deserialize_value_array(input_stream, reserve, add_serialized_value);
+    }
+
+    void memory_storage::serialize_base_check_array(std::ostream& output_stream) const
+    {
+        m_p_impl->serialize_base_check_array(output_stream);
+    }
+
     std::size_t memory_storage::base_check_size_impl() const
     {
         return m_p_impl->base_check_size_impl();
@@ -352,6 +788,33 @@ namespace tetengo::trie
         m_p_impl->set_check_at_impl(base_check_index, check);
     }
 
+    void memory_storage::prefetch_base_check_at_impl(const std::size_t base_check_index) const
+    {
+        m_p_impl->prefetch_base_check_at_impl(base_check_index);
+    }
+
+    std::optional<storage::base_check_array_view_type> memory_storage::base_check_array_view_impl() const
+    {
+        return m_p_impl->base_check_array_view_impl();
+    }
+
+    bool memory_storage::has_preceding_key_counts_impl() const
+    {
+        return m_p_impl->has_preceding_key_counts_impl();
+    }
+
+    std::uint32_t memory_storage::preceding_key_count_at_impl(const std::size_t base_check_index) const
+    {
+        return m_p_impl->preceding_key_count_at_impl(base_check_index);
+    }
+
+    void memory_storage::set_preceding_key_count_at_impl(
+        const std::size_t   base_check_index,
+        const std::uint32_t preceding_key_count)
+    {
+        m_p_impl->set_preceding_key_count_at_impl(base_check_index, preceding_key_count);
+    }
+
     std::size_t memory_storage::value_count_impl() const
     {
         return m_p_impl->value_count_impl();
@@ -367,6 +830,21 @@ namespace tetengo::trie
         return m_p_impl->add_value_at_impl(value_index, std::move(value));
     }
 
+    void memory_storage::erase_value_at_impl(const std::size_t value_index)
+    {
+        m_p_impl->erase_value_at_impl(value_index);
+    }
+
+    std::size_t memory_storage::vacant_value_count_impl() const
+    {
+        return m_p_impl->vacant_value_count_impl();
+    }
+
+    std::optional<std::size_t> memory_storage::vacant_value_index_impl() const
+    {
+        return m_p_impl->vacant_value_index_impl();
+    }
+
     double memory_storage::filling_rate_impl() const
     {
         return m_p_impl->filling_rate_impl();
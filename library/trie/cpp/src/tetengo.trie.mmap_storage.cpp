@@ -4,7 +4,10 @@
     Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
 */
 
+#include <algorithm>
 #include <any>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <cstddef> // IWYU pragma: keep
 #include <cstdint>
@@ -12,7 +15,10 @@
 #include <iterator>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
+#include <span>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
@@ -22,14 +28,20 @@
 #include <boost/interprocess/file_mapping.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 
-#include <tetengo/trie/default_serializer.hpp>
 #include <tetengo/trie/mmap_storage.hpp>
 #include <tetengo/trie/storage.hpp>
 #include <tetengo/trie/value_serializer.hpp> // IWYU pragma: keep
 
+#include "tetengo.trie.base_check_layout.hpp"
+#include "tetengo.trie.prefetch.hpp"
+#include "tetengo.trie.storage_format.hpp"
+#include "tetengo.trie.value_section_layout.hpp"
+
 
 namespace
 {
+    using value_pointer_type = std::shared_ptr<const std::optional<std::any>>;
+
     class value_cache : private boost::noncopyable
     {
     public:
@@ -49,7 +61,7 @@ namespace
             return m_map.find(index) != std::end(m_map);
         }
 
-        const std::any* at(const std::size_t index) const
+        const value_pointer_type& at(const std::size_t index) const
         {
             auto& value = at_impl(index);
 
@@ -57,10 +69,10 @@ namespace
             m_access_orders.push_front(index);
             value.first = std::begin(m_access_orders);
 
-            return value.second ? &*value.second : nullptr;
+            return value.second;
         }
 
-        void insert(const std::size_t index, std::optional<std::any> o_value)
+        void insert(const std::size_t index, value_pointer_type p_value)
         {
             assert(!has(index));
 
@@ -72,7 +84,7 @@ namespace
             }
 
             m_access_orders.push_front(index);
-            m_map.insert(std::make_pair(index, std::make_pair(std::begin(m_access_orders), std::move(o_value))));
+            m_map.insert(std::make_pair(index, std::make_pair(std::begin(m_access_orders), std::move(p_value))));
             assert(std::size(m_access_orders) == std::size(m_map));
         }
 
@@ -82,7 +94,7 @@ namespace
 
         using access_order_list_type = std::list<std::size_t>;
 
-        using map_value_type = std::pair<access_order_list_type::const_iterator, std::optional<std::any>>;
+        using map_value_type = std::pair<access_order_list_type::const_iterator, value_pointer_type>;
 
         using map_type = std::unordered_map<std::size_t, map_value_type>;
 
@@ -106,6 +118,146 @@ namespace
         }
     };
 
+    /*
+        The concurrent value cache is divided into shards by the value index. Each shard has its own lock and evicts
+        its values in the CLOCK manner, so that a cache hit only takes the shared lock of the shard and sets the
+        reference bit of the value. A missed value is deserialized out of the lock.
+
+        The values are handed out as shared pointers, so that a value evicted by another thread is kept until its
+        reader releases it.
+    */
+    class concurrent_value_cache : private boost::noncopyable
+    {
+    public:
+        // constructors and destructor
+
+        concurrent_value_cache(const std::size_t cache_capacity, const std::size_t shard_count) :
+        m_shard_count{ shard_count },
+        m_p_shards{ std::make_unique<shard_type[]>(shard_count) }
+        {
+            assert(shard_count > 0);
+
+            const auto shard_capacity = std::max<std::size_t>((cache_capacity + shard_count - 1) / shard_count, 1);
+            for (auto i = static_cast<std::size_t>(0); i < m_shard_count; ++i)
+            {
+                m_p_shards[i].initialize(shard_capacity);
+            }
+        }
+
+
+        // functions
+
+        template <typename Loader>
+        value_pointer_type at(const std::size_t index, const Loader& loader) const
+        {
+            auto& shard = m_p_shards[shard_index_of(index)];
+            if (auto p_found = shard.find(index); p_found)
+            {
+                return p_found;
+            }
+
+            return shard.insert(index, std::make_shared<const std::optional<std::any>>(loader(index)));
+        }
+
+
+    private:
+        // types
+
+        struct entry_type
+        {
+            std::size_t index{ 0 };
+
+            value_pointer_type p_value{};
+
+            std::atomic<bool> referenced{ false };
+        };
+
+        class alignas(64) shard_type
+        {
+        public:
+            // functions
+
+            void initialize(const std::size_t capacity)
+            {
+                m_capacity = capacity;
+                m_p_entries = std::make_unique<entry_type[]>(capacity);
+                m_slots.reserve(capacity);
+            }
+
+            value_pointer_type find(const std::size_t index) const
+            {
+                const std::shared_lock lock{ m_mutex };
+
+                const auto found = m_slots.find(index);
+                if (found == std::end(m_slots))
+                {
+                    return nullptr;
+                }
+                auto& entry = m_p_entries[found->second];
+                entry.referenced.store(true, std::memory_order_relaxed);
+                return entry.p_value;
+            }
+
+            value_pointer_type insert(const std::size_t index, value_pointer_type p_value)
+            {
+                const std::unique_lock lock{ m_mutex };
+
+                if (const auto found = m_slots.find(index); found != std::end(m_slots))
+                {
+                    return m_p_entries[found->second].p_value;
+                }
+
+                while (m_p_entries[m_hand].referenced.exchange(false, std::memory_order_relaxed))
+                {
+                    m_hand = (m_hand + 1) % m_capacity;
+                }
+
+                auto& entry = m_p_entries[m_hand];
+                if (entry.p_value)
+                {
+                    m_slots.erase(entry.index);
+                }
+                entry.index = index;
+                entry.p_value = std::move(p_value);
+                entry.referenced.store(true, std::memory_order_relaxed);
+                m_slots.insert(std::make_pair(index, m_hand));
+                m_hand = (m_hand + 1) % m_capacity;
+
+                return entry.p_value;
+            }
+
+
+        private:
+            // variables
+
+            mutable std::shared_mutex m_mutex{};
+
+            std::size_t m_capacity{ 0 };
+
+            std::unique_ptr<entry_type[]> m_p_entries{};
+
+            std::unordered_map<std::size_t, std::size_t> m_slots{};
+
+            std::size_t m_hand{ 0 };
+        };
+
+
+        // variables
+
+        const std::size_t m_shard_count;
+
+        const std::unique_ptr<shard_type[]> m_p_shards;
+
+
+        // functions
+
+        std::size_t shard_index_of(const std::size_t index) const
+        {
+            return static_cast<std::size_t>((static_cast<std::uint64_t>(index) * 0x9E3779B97F4A7C15) >> 32) %
+                   m_shard_count;
+        }
+    };
+
 
 }
 
@@ -130,23 +282,42 @@ namespace tetengo::trie
             const std::size_t                        content_offset,
             const std::size_t                        file_size,
             value_deserializer                       value_deserializer_,
-            const std::size_t                        value_cache_capacity) :
-        m_file_mapping{ file_mapping_ },
-        m_content_offset{ content_offset },
-        m_file_size{ file_size },
+            const std::size_t                        value_cache_capacity,
+            const std::size_t                        value_cache_shard_count) :
+        m_region{ map_content(file_mapping_, content_offset, file_size) },
+        m_p_content{ static_cast<const char*>(m_region.get_address()) },
+        m_content_size{ m_region.get_size() },
+        m_v2{ m_content_size >= v2_header_size() && is_v2_magic(m_p_content) },
+        m_o_v2_header{ m_v2 ? std::make_optional(load_v2_header(m_p_content, m_content_size)) : std::nullopt },
+        m_wide{ m_o_v2_header ? m_o_v2_header->wide() : read_uint32(0) == wide_base_check_marker() },
+        m_base_check_count{ base_check_count_of(m_o_v2_header) },
+        m_base_check_offset{ base_check_head_offset_of(m_o_v2_header) },
+        m_value_section_offset{ m_o_v2_header ? static_cast<std::size_t>(m_o_v2_header->value_section_offset) :
+                                                m_base_check_offset + base_check_element_size() * m_base_check_count },
+        m_value_count{ static_cast<std::size_t>(
+            m_v2 ? read_uint64(m_value_section_offset) : read_uint32(m_value_section_offset)) },
+        m_indexed{ indexed_of(m_v2 ? read_uint32(m_value_section_offset + sizeof(std::uint64_t)) :
+                                     read_uint32(m_value_section_offset + sizeof(std::uint32_t))) },
+        m_fixed_value_size{ m_indexed ? 0 :
+                            m_v2      ? read_uint32(m_value_section_offset + sizeof(std::uint64_t)) :
+                                        read_uint32(m_value_section_offset + sizeof(std::uint32_t)) },
+        m_value_offset_table_offset{ m_value_section_offset +
+                                     (m_v2 ? v2_value_section_header_size() : sizeof(std::uint32_t) * 2) },
+        m_value_offset{ m_indexed ? m_value_offset_table_offset + value_offset_size() * (m_value_count + 1) :
+                                    m_value_offset_table_offset },
         m_value_deserializer{ std::move(value_deserializer_) },
-        m_value_cache{ value_cache_capacity }
+        m_value_cache{ value_cache_capacity },
+        m_p_concurrent_value_cache{
+            value_cache_shard_count > 0 ?
+                std::make_unique<concurrent_value_cache>(value_cache_capacity, value_cache_shard_count) :
+                nullptr
+        },
+        m_vacant_value_count_once{},
+        m_vacant_value_count{ 0 }
         {
-            if (content_offset > file_size)
-            {
-                throw std::invalid_argument{ "content_offset is greater than file_size." };
-            }
-
-            const auto base_check_count = base_check_size_impl();
-            const auto fixed_value_size = read_uint32(sizeof(std::uint32_t) * (1 + base_check_count + 1));
-            if (fixed_value_size == 0)
+            if (!m_indexed && m_fixed_value_size == 0 && m_value_count > 0)
             {
-                throw std::invalid_argument{ "The value size in mmap storage must be fixed." };
+                throw std::invalid_argument{ "The values in mmap storage must be fixed size or indexed." };
             }
         }
 
@@ -155,14 +326,13 @@ namespace tetengo::trie
 
         std::size_t base_check_size_impl() const
         {
-            const auto base_check_count = read_uint32(0);
-            return base_check_count;
+            return m_base_check_count;
         }
 
         std::int32_t base_at_impl(const std::size_t base_check_index) const
         {
-            const auto base_check = read_uint32(sizeof(std::uint32_t) * (1 + base_check_index));
-            return static_cast<std::int32_t>(base_check) >> 8;
+            const auto offset = base_check_offset_of(base_check_index);
+            return m_wide ? wide_base_of(read_uint64(offset)) : narrow_base_of(read_uint32(offset));
         }
 
         void set_base_at_impl(const std::size_t /*base_check_index*/, const std::int32_t /*base*/)
@@ -172,8 +342,8 @@ namespace tetengo::trie
 
         std::uint8_t check_at_impl(const std::size_t base_check_index) const
         {
-            const auto base_check = read_uint32(sizeof(std::uint32_t) * (1 + base_check_index));
-            return base_check & 0xFF;
+            const auto offset = base_check_offset_of(base_check_index);
+            return m_wide ? read_uint64(offset) & 0xFF : read_uint32(offset) & 0xFF;
         }
 
         void set_check_at_impl(const std::size_t /*base_check_index*/, const std::uint8_t /*check*/)
@@ -181,32 +351,101 @@ namespace tetengo::trie
             throw std::logic_error{ "Unsupported operation." };
         }
 
-        std::size_t value_count_impl() const
+        void prefetch_base_check_at_impl(const std::size_t base_check_index) const
         {
-            const auto base_check_count = base_check_size_impl();
-            const auto size = read_uint32(sizeof(std::uint32_t) * (1 + base_check_count));
-            return size;
+            const auto offset = base_check_offset_of(base_check_index);
+            if (offset + base_check_element_size() <= m_content_size)
+            {
+                prefetch(m_p_content + offset);
+            }
         }
 
-        const std::any* value_at_impl(const std::size_t value_index) const
+        std::optional<base_check_array_view_type> base_check_array_view_impl() const
         {
-            if (!m_value_cache.has(value_index))
+            if (m_value_section_offset > m_content_size)
             {
-                const auto base_check_count = base_check_size_impl();
-                const auto fixed_value_size = read_uint32(sizeof(std::uint32_t) * (1 + base_check_count + 1));
-                const auto offset = sizeof(std::uint32_t) * (1 + base_check_count + 2) + fixed_value_size * value_index;
-                const auto serialized = read_bytes(offset, fixed_value_size);
-                if (serialized == std::vector<char>(fixed_value_size, uninitialized_byte()))
-                {
-                    m_value_cache.insert(value_index, std::nullopt);
-                }
-                else
+                return std::nullopt;
+            }
+            if (m_v2)
+            {
+                const auto* const p_head = m_p_content + m_base_check_offset;
+                if (std::endian::native != std::endian::little ||
+                    reinterpret_cast<std::uintptr_t>(p_head) % base_check_element_size() != 0)
                 {
-                    auto value = m_value_deserializer(serialized);
-                    m_value_cache.insert(value_index, std::move(value));
+                    return std::nullopt;
                 }
+                const auto layout = m_wide ? base_check_array_view_type::layout_type::wide :
+                                             base_check_array_view_type::layout_type::narrow;
+                return std::make_optional(base_check_array_view_type{ layout, p_head, m_base_check_count });
             }
-            return m_value_cache.at(value_index);
+            const auto layout = m_wide ? base_check_array_view_type::layout_type::wide_big_endian :
+                                         base_check_array_view_type::layout_type::narrow_big_endian;
+            return std::make_optional(
+                base_check_array_view_type{ layout, m_p_content + m_base_check_offset, m_base_check_count });
+        }
+
+        bool has_preceding_key_counts_impl() const
+        {
+            return m_o_v2_header && m_o_v2_header->counted();
+        }
+
+        std::uint32_t preceding_key_count_at_impl(const std::size_t base_check_index) const
+        {
+            if (!has_preceding_key_counts_impl() || base_check_index >= m_base_check_count)
+            {
+                return 0;
+            }
+            return read_uint32(
+                static_cast<std::size_t>(m_o_v2_header->preceding_key_count_offset) +
+                sizeof(std::uint32_t) * base_check_index);
+        }
+
+        std::size_t value_count_impl() const
+        {
+            return m_value_count;
+        }
+
+        const std::any* value_at_impl(const std::size_t value_index) const
+        {
+            if (m_p_concurrent_value_cache)
+            {
+                throw std::logic_error{ "Use shared_value_at() with the concurrent value cache." };
+            }
+
+            const auto& p_value = cached_value_at(value_index);
+            return *p_value ? &**p_value : nullptr;
+        }
+
+        std::shared_ptr<const std::any> shared_value_at_impl(const std::size_t value_index) const
+        {
+            auto p_value = m_p_concurrent_value_cache ?
+                               m_p_concurrent_value_cache->at(
+                                   value_index, [this](const std::size_t index) { return load_value(index); }) :
+                               cached_value_at(value_index);
+            if (!*p_value)
+            {
+                return nullptr;
+            }
+            const auto* const p_any = &**p_value;
+            return std::shared_ptr<const std::any>{ std::move(p_value), p_any };
+        }
+
+        std::optional<std::span<const char>> serialized_value_at_impl(const std::size_t value_index) const
+        {
+            if (m_indexed)
+            {
+                return indexed_serialized_value_at(value_index);
+            }
+
+            const auto offset = m_value_offset + m_fixed_value_size * value_index;
+            const auto* const p_serialized = content_at(offset, m_fixed_value_size);
+            if (std::all_of(p_serialized, p_serialized + m_fixed_value_size, [](const auto e) {
+                    return e == uninitialized_value_byte();
+                }))
+            {
+                return std::nullopt;
+            }
+            return std::make_optional(std::span<const char>{ p_serialized, m_fixed_value_size });
         }
 
         void add_value_at_impl(const std::size_t /*value_index*/, std::any /*value*/)
@@ -214,19 +453,34 @@ namespace tetengo::trie
             throw std::logic_error{ "Unsupported operation." };
         }
 
+        std::size_t vacant_value_count_impl() const
+        {
+            // The count is made on the first call, from the serialized values without any deserialization.
+            std::call_once(m_vacant_value_count_once, [this]() {
+                for (auto i = static_cast<std::size_t>(0); i < m_value_count; ++i)
+                {
+                    if (!serialized_value_at_impl(i))
+                    {
+                        ++m_vacant_value_count;
+                    }
+                }
+            });
+            return m_vacant_value_count;
+        }
+
         double filling_rate_impl() const
         {
-            const auto base_check_count = base_check_size_impl();
-            auto       empty_count = static_cast<std::uint32_t>(0);
-            for (auto i = static_cast<std::size_t>(0); i < base_check_count; ++i)
+            auto empty_count = static_cast<std::uint32_t>(0);
+            for (auto i = static_cast<std::size_t>(0); i < m_base_check_count; ++i)
             {
-                const auto base_check = read_uint32(sizeof(std::uint32_t) * (1 + i));
-                if (base_check == 0x000000FF)
+                const auto offset = base_check_offset_of(i);
+                const auto empty = m_wide ? read_uint64(offset) == 0x000000FF : read_uint32(offset) == 0x000000FF;
+                if (empty)
                 {
                     ++empty_count;
                 }
             }
-            return 1.0 - static_cast<double>(empty_count) / base_check_count;
+            return 1.0 - static_cast<double>(empty_count) / m_base_check_count;
         }
 
         void serialize_impl(std::ostream& /*output_stream*/, const value_serializer& /*value_serializer_*/) const
@@ -243,47 +497,192 @@ namespace tetengo::trie
     private:
         // static functions
 
-        static constexpr char uninitialized_byte()
+        static boost::interprocess::mapped_region map_content(
+            const boost::interprocess::file_mapping& file_mapping_,
+            const std::size_t                        content_offset,
+            const std::size_t                        file_size)
         {
-            return static_cast<char>(0xFF);
+            if (content_offset > file_size)
+            {
+                throw std::invalid_argument{ "content_offset is greater than file_size." };
+            }
+            if (content_offset == file_size)
+            {
+                return boost::interprocess::mapped_region{};
+            }
+
+            return boost::interprocess::mapped_region{ file_mapping_,
+                                                       boost::interprocess::read_only,
+                                                       static_cast<boost::interprocess::offset_t>(content_offset),
+                                                       file_size - content_offset };
         }
 
 
         // variables
 
-        const boost::interprocess::file_mapping& m_file_mapping;
+        const boost::interprocess::mapped_region m_region;
+
+        const char* const m_p_content;
+
+        const std::size_t m_content_size;
+
+        const bool m_v2;
+
+        const std::optional<v2_header_type> m_o_v2_header;
+
+        const bool m_wide;
+
+        const std::size_t m_base_check_count;
+
+        const std::size_t m_base_check_offset;
 
-        const std::size_t m_content_offset;
+        const std::size_t m_value_section_offset;
 
-        const std::size_t m_file_size;
+        const std::size_t m_value_count;
+
+        const bool m_indexed;
+
+        const std::size_t m_fixed_value_size;
+
+        const std::size_t m_value_offset_table_offset;
+
+        const std::size_t m_value_offset;
 
         const value_deserializer m_value_deserializer;
 
         mutable value_cache m_value_cache;
 
+        const std::unique_ptr<concurrent_value_cache> m_p_concurrent_value_cache;
+
+        mutable std::once_flag m_vacant_value_count_once;
+
+        mutable std::size_t m_vacant_value_count;
+
 
         // functions
 
-        std::vector<char> read_bytes(const std::size_t offset, const std::size_t size) const
+        std::size_t base_check_count_of(const std::optional<v2_header_type>& o_v2_header) const
+        {
+            if (o_v2_header)
+            {
+                return static_cast<std::size_t>(o_v2_header->base_check_count);
+            }
+            return m_wide ? read_uint32(sizeof(std::uint32_t)) : read_uint32(0);
+        }
+
+        std::size_t base_check_head_offset_of(const std::optional<v2_header_type>& o_v2_header) const
+        {
+            if (o_v2_header)
+            {
+                return static_cast<std::size_t>(o_v2_header->base_check_offset);
+            }
+            return m_wide ? sizeof(std::uint32_t) * 2 : sizeof(std::uint32_t);
+        }
+
+        bool indexed_of(const std::uint32_t value_size_word) const
+        {
+            return m_v2 ? value_size_word == 0 : value_size_word == indexed_value_size_marker();
+        }
+
+        const value_pointer_type& cached_value_at(const std::size_t value_index) const
+        {
+            if (!m_value_cache.has(value_index))
+            {
+                m_value_cache.insert(
+                    value_index, std::make_shared<const std::optional<std::any>>(load_value(value_index)));
+            }
+            return m_value_cache.at(value_index);
+        }
+
+        std::optional<std::any> load_value(const std::size_t value_index) const
+        {
+            const auto o_serialized = serialized_value_at_impl(value_index);
+            if (!o_serialized)
+            {
+                return std::nullopt;
+            }
+            return std::make_optional(
+                m_value_deserializer(std::vector<char>{ std::begin(*o_serialized), std::end(*o_serialized) }));
+        }
+
+        std::optional<std::span<const char>> indexed_serialized_value_at(const std::size_t value_index) const
+        {
+            if (value_index >= value_count_impl())
+            {
+                return std::nullopt;
+            }
+
+            const auto first = read_value_offset(value_index);
+            const auto last = read_value_offset(value_index + 1);
+            if (last < first)
+            {
+                throw std::ios_base::failure{ "Broken value offset." };
+            }
+            if (first == last)
+            {
+                return std::nullopt;
+            }
+            const auto size = static_cast<std::size_t>(last - first);
+            return std::make_optional(std::span<const char>{ content_at(m_value_offset + first, size), size });
+        }
+
+        std::uint64_t read_value_offset(const std::size_t index) const
         {
-            if (offset + size > m_file_size)
+            const auto offset = m_value_offset_table_offset + value_offset_size() * index;
+            return m_v2 ? read_uint64(offset) : read_uint32(offset);
+        }
+
+        std::size_t value_offset_size() const
+        {
+            return m_v2 ? sizeof(std::uint64_t) : sizeof(std::uint32_t);
+        }
+
+        std::size_t base_check_element_size() const
+        {
+            return m_wide ? sizeof(std::uint64_t) : sizeof(std::uint32_t);
+        }
+
+        std::size_t base_check_offset_of(const std::size_t base_check_index) const
+        {
+            return m_base_check_offset + base_check_element_size() * base_check_index;
+        }
+
+        const char* content_at(const std::size_t offset, const std::size_t size) const
+        {
+            if (offset + size > m_content_size)
             {
                 throw std::ios_base::failure{ "The mmap region is out of the file size." };
             }
 
-            const boost::interprocess::mapped_region region{ m_file_mapping,
-                                                             boost::interprocess::read_only,
-                                                             static_cast<boost::interprocess::offset_t>(
-                                                                 m_content_offset + offset),
-                                                             size };
-            return std::vector<char>{ reinterpret_cast<const char*>(region.get_address()),
-                                      reinterpret_cast<const char*>(region.get_address()) + region.get_size() };
+            return m_p_content + offset;
         }
 
         std::uint32_t read_uint32(const std::size_t offset) const
         {
-            static const default_deserializer<std::uint32_t> uint32_deserializer{ false };
-            return uint32_deserializer(read_bytes(offset, sizeof(std::uint32_t)));
+            if (m_v2)
+            {
+                return load_little_endian<std::uint32_t>(content_at(offset, sizeof(std::uint32_t)));
+            }
+            const auto* const p_bytes =
+                reinterpret_cast<const unsigned char*>(content_at(offset, sizeof(std::uint32_t)));
+            return (static_cast<std::uint32_t>(p_bytes[0]) << 24) | (static_cast<std::uint32_t>(p_bytes[1]) << 16) |
+                   (static_cast<std::uint32_t>(p_bytes[2]) << 8) | static_cast<std::uint32_t>(p_bytes[3]);
+        }
+
+        std::uint64_t read_uint64(const std::size_t offset) const
+        {
+            if (m_v2)
+            {
+                return load_little_endian<std::uint64_t>(content_at(offset, sizeof(std::uint64_t)));
+            }
+            const auto* const p_bytes =
+                reinterpret_cast<const unsigned char*>(content_at(offset, sizeof(std::uint64_t)));
+            auto value = static_cast<std::uint64_t>(0);
+            for (auto i = static_cast<std::size_t>(0); i < sizeof(std::uint64_t); ++i)
+            {
+                value = (value << 8) | p_bytes[i];
+            }
+            return value;
         }
     };
 
@@ -298,13 +697,15 @@ namespace tetengo::trie
         const std::size_t                        content_offset,
         const std::size_t                        file_size,
         value_deserializer                       value_deserializer_,
-        const std::size_t                        value_cache_capacity /*= default_value_cache_capacity()*/) :
+        const std::size_t                        value_cache_capacity /*= default_value_cache_capacity()*/,
+        const std::size_t                        value_cache_shard_count /*= 0*/) :
     m_p_impl{ std::make_shared<impl>(
         file_mapping_,
         content_offset,
         file_size,
         std::move(value_deserializer_),
-        value_cache_capacity) }
+        value_cache_capacity,
+        value_cache_shard_count) }
     {}
 
     mmap_storage::~mmap_storage() = default;
@@ -334,6 +735,26 @@ namespace tetengo::trie
         m_p_impl->set_check_at_impl(base_check_index, check);
     }
 
+    void mmap_storage::prefetch_base_check_at_impl(const std::size_t base_check_index) const
+    {
+        m_p_impl->prefetch_base_check_at_impl(base_check_index);
+    }
+
+    std::optional<storage::base_check_array_view_type> mmap_storage::base_check_array_view_impl() const
+    {
+        return m_p_impl->base_check_array_view_impl();
+    }
+
+    bool mmap_storage::has_preceding_key_counts_impl() const
+    {
+        return m_p_impl->has_preceding_key_counts_impl();
+    }
+
+    std::uint32_t mmap_storage::preceding_key_count_at_impl(const std::size_t base_check_index) const
+    {
+        return m_p_impl->preceding_key_count_at_impl(base_check_index);
+    }
+
     std::size_t mmap_storage::value_count_impl() const
     {
         return m_p_impl->value_count_impl();
@@ -344,11 +765,26 @@ namespace tetengo::trie
         return m_p_impl->value_at_impl(value_index);
     }
 
+    std::shared_ptr<const std::any> mmap_storage::shared_value_at_impl(const std::size_t value_index) const
+    {
+        return m_p_impl->shared_value_at_impl(value_index);
+    }
+
+    std::optional<std::span<const char>> mmap_storage::serialized_value_at_impl(const std::size_t value_index) const
+    {
+        return m_p_impl->serialized_value_at_impl(value_index);
+    }
+
     void mmap_storage::add_value_at_impl(const std::size_t value_index, std::any value)
     {
         return m_p_impl->add_value_at_impl(value_index, std::move(value));
     }
 
+    std::size_t mmap_storage::vacant_value_count_impl() const
+    {
+        return m_p_impl->vacant_value_count_impl();
+    }
+
     double mmap_storage::filling_rate_impl() const
     {
         return m_p_impl->filling_rate_impl();
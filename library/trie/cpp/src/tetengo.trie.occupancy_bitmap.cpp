@@ -0,0 +1,106 @@
+/*! \file
+    \brief An occupancy bitmap.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "tetengo.trie.occupancy_bitmap.hpp"
+
+
+namespace tetengo::trie
+{
+    constexpr std::size_t occupancy_bitmap::word_bit_count()
+    {
+        return std::numeric_limits<std::uint64_t>::digits;
+    }
+
+    occupancy_bitmap::occupancy_bitmap() : m_words{}, m_full_word_flags{} {}
+
+    bool occupancy_bitmap::occupied(const std::size_t index) const
+    {
+        const auto word_index = index / word_bit_count();
+        if (word_index >= std::size(m_words))
+        {
+            return false;
+        }
+        return (m_words[word_index] >> (index % word_bit_count())) & 1U;
+    }
+
+    void occupancy_bitmap::occupy(const std::size_t index)
+    {
+        const auto word_index = index / word_bit_count();
+        if (word_index >= std::size(m_words))
+        {
+            m_words.resize(word_index + 1, 0);
+            m_full_word_flags.resize((std::size(m_words) + word_bit_count() - 1) / word_bit_count(), 0);
+        }
+
+        m_words[word_index] |= static_cast<std::uint64_t>(1) << (index % word_bit_count());
+        if (m_words[word_index] == std::numeric_limits<std::uint64_t>::max())
+        {
+            m_full_word_flags[word_index / word_bit_count()] |= static_cast<std::uint64_t>(1)
+                                                                 << (word_index % word_bit_count());
+        }
+    }
+
+    void occupancy_bitmap::vacate(const std::size_t index)
+    {
+        const auto word_index = index / word_bit_count();
+        if (word_index >= std::size(m_words))
+        {
+            return;
+        }
+
+        m_words[word_index] &= ~(static_cast<std::uint64_t>(1) << (index % word_bit_count()));
+        m_full_word_flags[word_index / word_bit_count()] &= ~(static_cast<std::uint64_t>(1)
+                                                              << (word_index % word_bit_count()));
+    }
+
+    std::size_t occupancy_bitmap::first_vacant_from(const std::size_t index) const
+    {
+        auto word_index = index / word_bit_count();
+        if (word_index >= std::size(m_words))
+        {
+            return index;
+        }
+
+        const auto vacant_bits = ~m_words[word_index] & (std::numeric_limits<std::uint64_t>::max()
+                                                         << (index % word_bit_count()));
+        if (vacant_bits != 0)
+        {
+            return word_index * word_bit_count() + std::countr_zero(vacant_bits);
+        }
+
+        // The full words are skipped by the flags, each of which stands for a word.
+        for (++word_index; word_index < std::size(m_words);)
+        {
+            const auto flag_index = word_index / word_bit_count();
+            const auto not_full_flags = ~m_full_word_flags[flag_index] & (std::numeric_limits<std::uint64_t>::max()
+                                                                          << (word_index % word_bit_count()));
+            if (not_full_flags != 0)
+            {
+                word_index = flag_index * word_bit_count() + std::countr_zero(not_full_flags);
+                break;
+            }
+            word_index = (flag_index + 1) * word_bit_count();
+        }
+        if (word_index >= std::size(m_words))
+        {
+            return std::size(m_words) * word_bit_count();
+        }
+        return word_index * word_bit_count() + std::countr_zero(~m_words[word_index]);
+    }
+
+
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*! \file
+    \brief An occupancy bitmap.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#if !defined(TETENGO_TRIE_OCCUPANCYBITMAP_HPP)
+#define TETENGO_TRIE_OCCUPANCYBITMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace tetengo::trie
+{
+    class occupancy_bitmap
+    {
+    public:
+        // constructors
+
+        occupancy_bitmap();
+
+
+        // functions
+
+        bool occupied(std::size_t index) const;
+
+        void occupy(std::size_t index);
+
+        void vacate(std::size_t index);
+
+        std::size_t first_vacant_from(std::size_t index) const;
+
+
+    private:
+        // static functions
+
+        static constexpr std::size_t word_bit_count();
+
+
+        // variables
+
+        std::vector<std::uint64_t> m_words;
+
+        std::vector<std::uint64_t> m_full_word_flags;
+    };
+
+
+}
+
+
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+/*! \file
+    \brief A prefetch.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#if !defined(TETENGO_TRIE_PREFETCH_HPP)
+#define TETENGO_TRIE_PREFETCH_HPP
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#endif
+
+
+namespace tetengo::trie
+{
+    inline void prefetch(const void* const p_address)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p_address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+        _mm_prefetch(static_cast<const char*>(p_address), _MM_HINT_T0);
+#else
+        static_cast<void>(p_address);
+#endif
+    }
+
+
+}
+
+
+#endif
+
+#endif
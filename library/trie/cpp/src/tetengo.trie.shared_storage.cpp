@@ -9,7 +9,10 @@
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <optional>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include <boost/core/noncopyable.hpp>
 
@@ -59,6 +62,32 @@ namespace tetengo::trie
             m_p_entity->set_check_at(base_check_index, check);
         }
 
+        void prefetch_base_check_at_impl(const std::size_t base_check_index) const
+        {
+            m_p_entity->prefetch_base_check_at(base_check_index);
+        }
+
+        std::optional<base_check_array_view_type> base_check_array_view_impl() const
+        {
+            return m_p_entity->base_check_array_view();
+        }
+
+        bool has_preceding_key_counts_impl() const
+        {
+            return m_p_entity->has_preceding_key_counts();
+        }
+
+        std::uint32_t preceding_key_count_at_impl(const std::size_t base_check_index) const
+        {
+            return m_p_entity->preceding_key_count_at(base_check_index);
+        }
+
+        void
+        set_preceding_key_count_at_impl(const std::size_t base_check_index, const std::uint32_t preceding_key_count)
+        {
+            m_p_entity->set_preceding_key_count_at(base_check_index, preceding_key_count);
+        }
+
         std::size_t value_count_impl() const
         {
             return m_p_entity->value_count();
@@ -69,11 +98,47 @@ namespace tetengo::trie
             return m_p_entity->value_at(value_index);
         }
 
+        std::shared_ptr<const std::any> shared_value_at_impl(const std::size_t value_index) const
+        {
+            return m_p_entity->shared_value_at(value_index);
+        }
+
+        std::optional<value_array_view_type> value_array_view_impl() const
+        {
+            return m_p_entity->value_array_view();
+        }
+
+        std::optional<std::span<const char>> serialized_value_at_impl(const std::size_t value_index) const
+        {
+            return m_p_entity->serialized_value_at(value_index);
+        }
+
+        std::optional<std::vector<char>>
+        serialize_value_at_impl(const std::size_t value_index, const value_serializer& value_serializer_) const
+        {
+            return m_p_entity->serialize_value_at(value_index, value_serializer_);
+        }
+
         void add_value_at_impl(const std::size_t value_index, std::any value)
         {
             m_p_entity->add_value_at(value_index, std::move(value));
         }
 
+        void erase_value_at_impl(const std::size_t value_index)
+        {
+            m_p_entity->erase_value_at(value_index);
+        }
+
+        std::size_t vacant_value_count_impl() const
+        {
+            return m_p_entity->vacant_value_count();
+        }
+
+        std::optional<std::size_t> vacant_value_index_impl() const
+        {
+            return m_p_entity->vacant_value_index();
+        }
+
         double filling_rate_impl() const
         {
             return m_p_entity->filling_rate();
@@ -132,6 +197,33 @@ namespace tetengo::trie
         m_p_impl->set_check_at_impl(base_check_index, check);
     }
 
+    void shared_storage::prefetch_base_check_at_impl(const std::size_t base_check_index) const
+    {
+        m_p_impl->prefetch_base_check_at_impl(base_check_index);
+    }
+
+    std::optional<storage::base_check_array_view_type> shared_storage::base_check_array_view_impl() const
+    {
+        return m_p_impl->base_check_array_view_impl();
+    }
+
+    bool shared_storage::has_preceding_key_counts_impl() const
+    {
+        return m_p_impl->has_preceding_key_counts_impl();
+    }
+
+    std::uint32_t shared_storage::preceding_key_count_at_impl(const std::size_t base_check_index) const
+    {
+        return m_p_impl->preceding_key_count_at_impl(base_check_index);
+    }
+
+    void shared_storage::set_preceding_key_count_at_impl(
+        const std::size_t   base_check_index,
+        const std::uint32_t preceding_key_count)
+    {
+        m_p_impl->set_preceding_key_count_at_impl(base_check_index, preceding_key_count);
+    }
+
     std::size_t shared_storage::value_count_impl() const
     {
         return m_p_impl->value_count_impl();
@@ -142,11 +234,48 @@ namespace tetengo::trie
         return m_p_impl->value_at_impl(value_index);
     }
 
+    std::shared_ptr<const std::any> shared_storage::shared_value_at_impl(const std::size_t value_index) const
+    {
+        return m_p_impl->shared_value_at_impl(value_index);
+    }
+
+    std::optional<storage::value_array_view_type> shared_storage::value_array_view_impl() const
+    {
+        return m_p_impl->value_array_view_impl();
+    }
+
+    std::optional<std::span<const char>> shared_storage::serialized_value_at_impl(const std::size_t value_index) const
+    {
+        return m_p_impl->serialized_value_at_impl(value_index);
+    }
+
+    std::optional<std::vector<char>> shared_storage::serialize_value_at_impl(
+        const std::size_t       value_index,
+        const value_serializer& value_serializer_) const
+    {
+        return m_p_impl->serialize_value_at_impl(value_index, value_serializer_);
+    }
+
     void shared_storage::add_value_at_impl(const std::size_t value_index, std::any value)
     {
         return m_p_impl->add_value_at_impl(value_index, std::move(value));
     }
 
+    void shared_storage::erase_value_at_impl(const std::size_t value_index)
+    {
+        m_p_impl->erase_value_at_impl(value_index);
+    }
+
+    std::size_t shared_storage::vacant_value_count_impl() const
+    {
+        return m_p_impl->vacant_value_count_impl();
+    }
+
+    std::optional<std::size_t> shared_storage::vacant_value_index_impl() const
+    {
+        return m_p_impl->vacant_value_index_impl();
+    }
+
     double shared_storage::filling_rate_impl() const
     {
         return m_p_impl->filling_rate_impl();
@@ -4,19 +4,201 @@
     Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
 */
 
+#include <algorithm>
 #include <any>
+#include <cassert>
 #include <cstddef> // IWYU pragma: keep
 #include <cstdint>
+#include <cstdio>
+#include <ios>
 #include <istream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
 #include <utility>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
 
 #include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/value_serializer.hpp>
+
+#include "tetengo.trie.base_check_accessor.hpp"
+#include "tetengo.trie.base_check_layout.hpp"
+#include "tetengo.trie.storage_format.hpp"
+#include "tetengo.trie.value_section_layout.hpp"
 
 
 namespace tetengo::trie
 {
-    class value_serializer;
+    namespace
+    {
+        constexpr std::size_t chunk_size()
+        {
+            return 65536;
+        }
+
+        void write_v2_base_check_section(std::ostream& output_stream, const storage& storage_, const bool wide)
+        {
+            with_base_check_accessor(storage_, [&output_stream, wide](const auto& accessor) {
+                const auto        element_size = wide ? sizeof(std::uint64_t) : sizeof(std::uint32_t);
+                std::vector<char> chunk(chunk_size() / element_size * element_size, 0);
+                auto              chunk_tail = static_cast<std::size_t>(0);
+                for (auto i = static_cast<std::size_t>(0); i < accessor.size(); ++i)
+                {
+                    if (chunk_tail == std::size(chunk))
+                    {
+                        output_stream.write(std::data(chunk), chunk_tail);
+                        chunk_tail = 0;
+                    }
+                    if (wide)
+                    {
+                        store_little_endian(
+                            wide_base_check_of(accessor.base_at(i), accessor.check_at(i)),
+                            std::data(chunk) + chunk_tail);
+                    }
+                    else
+                    {
+                        store_little_endian(
+                            narrow_base_check_of(accessor.base_at(i), accessor.check_at(i)),
+                            std::data(chunk) + chunk_tail);
+                    }
+                    chunk_tail += element_size;
+                }
+                output_stream.write(std::data(chunk), chunk_tail);
+            });
+        }
+
+        void write_v2_preceding_key_count_section(std::ostream& output_stream, const storage& storage_)
+        {
+            std::vector<char> chunk(chunk_size(), 0);
+            auto              chunk_tail = static_cast<std::size_t>(0);
+            for (auto i = static_cast<std::size_t>(0); i < storage_.base_check_size(); ++i)
+            {
+                if (chunk_tail == std::size(chunk))
+                {
+                    output_stream.write(std::data(chunk), chunk_tail);
+                    chunk_tail = 0;
+                }
+                store_little_endian(storage_.preceding_key_count_at(i), std::data(chunk) + chunk_tail);
+                chunk_tail += sizeof(std::uint32_t);
+            }
+            output_stream.write(std::data(chunk), chunk_tail);
+        }
+
+        class v2_value_spool : private boost::noncopyable
+        {
+        public:
+            // constructors and destructor
+
+            v2_value_spool(const storage& storage_, const value_serializer& value_serializer_) :
+            m_p_file{ std::tmpfile(), std::fclose },
+            m_offsets{ 0 }
+            {
+                if (!m_p_file)
+                {
+                    throw std::ios_base::failure{ "Can't create a temporary file." };
+                }
+
+                m_offsets.reserve(storage_.value_count() + 1);
+                for (auto i = static_cast<std::size_t>(0); i < storage_.value_count(); ++i)
+                {
+                    const auto o_serialized = storage_.serialize_value_at(i, value_serializer_);
+                    if (o_serialized && std::fwrite(
+                                            std::data(*o_serialized), 1, std::size(*o_serialized), m_p_file.get()) !=
+                                            std::size(*o_serialized))
+                    {
+                        throw std::ios_base::failure{ "Can't write the value to the temporary file." };
+                    }
+                    m_offsets.push_back(m_offsets.back() + (o_serialized ? std::size(*o_serialized) : 0));
+                }
+            }
+
+
+            // functions
+
+            std::size_t section_size() const
+            {
+                return v2_value_section_header_size() + sizeof(std::uint64_t) * std::size(m_offsets) +
+                       static_cast<std::size_t>(m_offsets.back());
+            }
+
+            void write_to(std::ostream& output_stream) const
+            {
+                std::vector<char> chunk(chunk_size(), 0);
+                auto              chunk_tail = static_cast<std::size_t>(0);
+                for (const auto offset: m_offsets)
+                {
+                    if (chunk_tail == std::size(chunk))
+                    {
+                        output_stream.write(std::data(chunk), chunk_tail);
+                        chunk_tail = 0;
+                    }
+                    store_little_endian(offset, std::data(chunk) + chunk_tail);
+                    chunk_tail += sizeof(std::uint64_t);
+                }
+                output_stream.write(std::data(chunk), chunk_tail);
+
+                std::rewind(m_p_file.get());
+                for (;;)
+                {
+                    const auto read_size = std::fread(std::data(chunk), 1, std::size(chunk), m_p_file.get());
+                    output_stream.write(std::data(chunk), read_size);
+                    if (read_size < std::size(chunk))
+                    {
+                        break;
+                    }
+                }
+                if (std::ferror(m_p_file.get()))
+                {
+                    throw std::ios_base::failure{ "Can't read the values from the temporary file." };
+                }
+            }
+
+
+        private:
+            // variables
+
+            const std::unique_ptr<std::FILE, decltype(&std::fclose)> m_p_file;
+
+            std::vector<std::uint64_t> m_offsets;
+        };
+
+        void write_v2_fixed_size_values(
+            std::ostream&           output_stream,
+            const storage&          storage_,
+            const value_serializer& value_serializer_)
+        {
+            const auto              fixed_value_size = value_serializer_.fixed_value_size();
+            const std::vector<char> absent_value(fixed_value_size, uninitialized_value_byte());
+            for (auto i = static_cast<std::size_t>(0); i < storage_.value_count(); ++i)
+            {
+                if (const auto o_serialized = storage_.serialize_value_at(i, value_serializer_); o_serialized)
+                {
+                    assert(std::size(*o_serialized) == fixed_value_size);
+                    output_stream.write(std::data(*o_serialized), std::size(*o_serialized));
+                }
+                else
+                {
+                    output_stream.write(std::data(absent_value), std::size(absent_value));
+                }
+            }
+        }
+
+        void write_padding(std::ostream& output_stream, const std::size_t size)
+        {
+            static const std::vector<char> zeros(v2_section_alignment(), 0);
+
+            assert(size < v2_section_alignment());
+            output_stream.write(std::data(zeros), size);
+        }
+
+
+    }
 
 
     storage::storage() = default;
@@ -48,6 +230,32 @@ namespace tetengo::trie
         set_check_at_impl(base_check_index, base);
     }
 
+    void storage::prefetch_base_check_at(const std::size_t base_check_index) const
+    {
+        prefetch_base_check_at_impl(base_check_index);
+    }
+
+    std::optional<storage::base_check_array_view_type> storage::base_check_array_view() const
+    {
+        return base_check_array_view_impl();
+    }
+
+    bool storage::has_preceding_key_counts() const
+    {
+        return has_preceding_key_counts_impl();
+    }
+
+    std::uint32_t storage::preceding_key_count_at(const std::size_t base_check_index) const
+    {
+        return preceding_key_count_at_impl(base_check_index);
+    }
+
+    void
+    storage::set_preceding_key_count_at(const std::size_t base_check_index, const std::uint32_t preceding_key_count)
+    {
+        set_preceding_key_count_at_impl(base_check_index, preceding_key_count);
+    }
+
     std::size_t storage::value_count() const
     {
         return value_count_impl();
@@ -58,11 +266,47 @@ namespace tetengo::trie
         return value_at_impl(value_index);
     }
 
+    std::shared_ptr<const std::any> storage::shared_value_at(const std::size_t value_index) const
+    {
+        return shared_value_at_impl(value_index);
+    }
+
+    std::optional<storage::value_array_view_type> storage::value_array_view() const
+    {
+        return value_array_view_impl();
+    }
+
+    std::optional<std::span<const char>> storage::serialized_value_at(const std::size_t value_index) const
+    {
+        return serialized_value_at_impl(value_index);
+    }
+
+    std::optional<std::vector<char>>
+    storage::serialize_value_at(const std::size_t value_index, const value_serializer& value_serializer_) const
+    {
+        return serialize_value_at_impl(value_index, value_serializer_);
+    }
+
     void storage::add_value_at(const std::size_t value_index, std::any value)
     {
         add_value_at_impl(value_index, std::move(value));
     }
 
+    void storage::erase_value_at(const std::size_t value_index)
+    {
+        erase_value_at_impl(value_index);
+    }
+
+    std::size_t storage::vacant_value_count() const
+    {
+        return vacant_value_count_impl();
+    }
+
+    std::optional<std::size_t> storage::vacant_value_index() const
+    {
+        return vacant_value_index_impl();
+    }
+
     double storage::filling_rate() const
     {
         return filling_rate_impl();
@@ -70,13 +314,157 @@ namespace tetengo::trie
 
     void storage::serialize(std::ostream& output_stream, const value_serializer& value_serializer_) const
     {
+        if (has_preceding_key_counts())
+        {
+            throw std::logic_error{ "The preceding key counts can be serialized only in the format version 2." };
+        }
         serialize_impl(output_stream, value_serializer_);
     }
 
+    void storage::serialize_v2(std::ostream& output_stream, const value_serializer& value_serializer_) const
+    {
+        if (!output_stream)
+        {
+            throw std::ios_base::failure{ "Bad output_stream." };
+        }
+
+        const auto wide = with_base_check_accessor(*this, [](const auto& accessor) {
+            for (auto i = static_cast<std::size_t>(0); i < accessor.size(); ++i)
+            {
+                if (!fits_narrow_base(accessor.base_at(i)))
+                {
+                    return true;
+                }
+            }
+            return false;
+        });
+        const auto value_count = this->value_count();
+        assert(value_serializer_.fixed_value_size() < std::numeric_limits<std::uint32_t>::max());
+        const auto fixed_value_size = value_serializer_.fixed_value_size();
+        // The variable size values are spooled first, since the offset table and the header precede them.
+        const auto p_value_spool =
+            fixed_value_size > 0 ? nullptr : std::make_unique<v2_value_spool>(*this, value_serializer_);
+
+        const auto counted = has_preceding_key_counts();
+
+        v2_header_type header{};
+        header.flags = (wide ? v2_wide_flag() : 0) | (counted ? v2_counted_flag() : 0);
+        header.base_check_offset = v2_aligned_offset(v2_header_size());
+        header.base_check_count = base_check_size();
+        const auto base_check_section_size =
+            static_cast<std::size_t>(header.base_check_count) * (wide ? sizeof(std::uint64_t) : sizeof(std::uint32_t));
+        const auto base_check_section_tail = header.base_check_offset + base_check_section_size;
+        header.preceding_key_count_offset = counted ? v2_aligned_offset(base_check_section_tail) : 0;
+        const auto preceding_key_count_section_size =
+            counted ? static_cast<std::size_t>(header.base_check_count) * sizeof(std::uint32_t) : 0;
+        const auto preceding_key_count_section_tail =
+            counted ? header.preceding_key_count_offset + preceding_key_count_section_size : base_check_section_tail;
+        header.value_section_offset = v2_aligned_offset(preceding_key_count_section_tail);
+        header.value_section_size = p_value_spool ? p_value_spool->section_size() :
+                                                    v2_value_section_header_size() + fixed_value_size * value_count;
+        header.file_size = header.value_section_offset + header.value_section_size;
+        std::vector<char> serialized_header(v2_header_size(), 0);
+        store_v2_header(header, std::data(serialized_header));
+
+        output_stream.write(std::data(serialized_header), std::size(serialized_header));
+        write_padding(output_stream, header.base_check_offset - v2_header_size());
+        write_v2_base_check_section(output_stream, *this, wide);
+        if (counted)
+        {
+            write_padding(output_stream, header.preceding_key_count_offset - base_check_section_tail);
+            write_v2_preceding_key_count_section(output_stream, *this);
+        }
+        write_padding(output_stream, header.value_section_offset - preceding_key_count_section_tail);
+
+        std::vector<char> value_section_header(v2_value_section_header_size(), 0);
+        store_little_endian(static_cast<std::uint64_t>(value_count), std::data(value_section_header));
+        store_little_endian(static_cast<std::uint32_t>(fixed_value_size), std::data(value_section_header) + 8);
+        output_stream.write(std::data(value_section_header), std::size(value_section_header));
+        if (p_value_spool)
+        {
+            p_value_spool->write_to(output_stream);
+        }
+        else
+        {
+            write_v2_fixed_size_values(output_stream, *this, value_serializer_);
+        }
+    }
+
     std::unique_ptr<storage> storage::clone() const
     {
         return clone_impl();
     }
 
+    void storage::prefetch_base_check_at_impl(const std::size_t /*base_check_index*/) const {}
+
+    std::optional<storage::base_check_array_view_type> storage::base_check_array_view_impl() const
+    {
+        return std::nullopt;
+    }
+
+    bool storage::has_preceding_key_counts_impl() const
+    {
+        return false;
+    }
+
+    std::uint32_t storage::preceding_key_count_at_impl(const std::size_t /*base_check_index*/) const
+    {
+        return 0;
+    }
+
+    void storage::set_preceding_key_count_at_impl(
+        const std::size_t /*base_check_index*/,
+        const std::uint32_t /*preceding_key_count*/)
+    {
+        throw std::logic_error{ "Unsupported operation." };
+    }
+
+    std::shared_ptr<const std::any> storage::shared_value_at_impl(const std::size_t value_index) const
+    {
+        // The value object is not owned by the pointer. It is kept as long as the one returned by value_at().
+        const auto* const p_value = value_at(value_index);
+        return p_value ? std::shared_ptr<const std::any>{ std::shared_ptr<const std::any>{}, p_value } : nullptr;
+    }
+
+    std::optional<storage::value_array_view_type> storage::value_array_view_impl() const
+    {
+        return std::nullopt;
+    }
+
+    std::optional<std::span<const char>> storage::serialized_value_at_impl(const std::size_t /*value_index*/) const
+    {
+        return std::nullopt;
+    }
+
+    std::optional<std::vector<char>>
+    storage::serialize_value_at_impl(const std::size_t value_index, const value_serializer& value_serializer_) const
+    {
+        const auto p_value = shared_value_at(value_index);
+        return p_value ? std::make_optional(value_serializer_(*p_value)) : std::nullopt;
+    }
+
+    void storage::erase_value_at_impl(const std::size_t /*value_index*/)
+    {
+        throw std::logic_error{ "Unsupported operation." };
+    }
+
+    std::size_t storage::vacant_value_count_impl() const
+    {
+        auto count = static_cast<std::size_t>(0);
+        for (auto i = static_cast<std::size_t>(0); i < value_count(); ++i)
+        {
+            if (!value_at(i))
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    std::optional<std::size_t> storage::vacant_value_index_impl() const
+    {
+        return std::nullopt;
+    }
+
 
 }
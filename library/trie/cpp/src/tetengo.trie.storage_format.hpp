@@ -0,0 +1,243 @@
+/*! \file
+    \brief A storage format.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#if !defined(TETENGO_TRIE_STORAGEFORMAT_HPP)
+#define TETENGO_TRIE_STORAGEFORMAT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+
+
+namespace tetengo::trie
+{
+    /*
+        The format version 2 starts with the header below. All the words in it are little-endian.
+
+            offset  size  content
+                 0     8  v2_magic()
+                 8     4  the version, which is 2
+                12     4  the flags; v2_wide_flag() for the wide base-check layout, v2_counted_flag() for the
+                          preceding key counts
+                16     8  the offset of the base-check section
+                24     8  the base-check element count
+                32     8  the offset of the value section
+                40     8  the size of the value section
+                48     8  the file size
+                56     8  the offset of the preceding key count section, or 0 without v2_counted_flag()
+
+        The base-check section is the array of the narrow or wide base-check words in little-endian. So a reader on a
+        little-endian machine can use it as it is.
+
+        The preceding key count section, which follows the base-check section, is the array of the 4-byte preceding key
+        counts in little-endian. It has as many elements as the base-check section.
+
+        The value section starts with the value count in 8 bytes and the fixed value size in 4 bytes followed by the
+        4 reserved bytes. When the fixed value size is positive, the values of that size follow, and a value filled
+        with uninitialized_value_byte() is absent. When it is 0, the offset table of (value count + 1) 8-byte words
+        follows, and then the values as the indexed value section of the format version 1.
+
+        The sections are aligned to v2_section_alignment() bytes from the head of the header. Since the first 4 bytes
+        of v2_magic() read as a narrow base-check element count of the format version 1 are too large for any actual
+        file, a version 1 file is never taken for a version 2 one.
+    */
+
+    inline constexpr char v2_magic_byte_at(const std::size_t index)
+    {
+        constexpr char magic[] = { static_cast<char>(0x89), 'T', 'R', 'I', 'E', '\r', '\n', static_cast<char>(0x1A) };
+        return magic[index];
+    }
+
+    inline constexpr std::size_t v2_magic_size()
+    {
+        return 8;
+    }
+
+    inline constexpr std::uint32_t v2_magic_head_word()
+    {
+        return 0x89545249;
+    }
+
+    inline constexpr std::uint32_t v2_version()
+    {
+        return 2;
+    }
+
+    inline constexpr std::uint32_t v2_wide_flag()
+    {
+        return 0x00000001;
+    }
+
+    inline constexpr std::uint32_t v2_counted_flag()
+    {
+        return 0x00000002;
+    }
+
+    inline constexpr std::size_t v2_header_size()
+    {
+        return 64;
+    }
+
+    inline constexpr std::size_t v2_value_section_header_size()
+    {
+        return 16;
+    }
+
+    inline constexpr std::size_t v2_section_alignment()
+    {
+        return 4096;
+    }
+
+    inline constexpr std::size_t v2_aligned_offset(const std::size_t offset)
+    {
+        return (offset + v2_section_alignment() - 1) / v2_section_alignment() * v2_section_alignment();
+    }
+
+    template <typename UInt>
+    UInt load_little_endian(const char* const p_bytes)
+    {
+        auto value = static_cast<UInt>(0);
+        for (auto i = sizeof(UInt); i > 0; --i)
+        {
+            value = static_cast<UInt>(value << 8) | static_cast<unsigned char>(p_bytes[i - 1]);
+        }
+        return value;
+    }
+
+    template <typename UInt>
+    UInt load_big_endian(const char* const p_bytes)
+    {
+        auto value = static_cast<UInt>(0);
+        for (auto i = static_cast<std::size_t>(0); i < sizeof(UInt); ++i)
+        {
+            value = static_cast<UInt>(value << 8) | static_cast<unsigned char>(p_bytes[i]);
+        }
+        return value;
+    }
+
+    template <typename UInt>
+    void store_little_endian(const UInt value, char* const p_bytes)
+    {
+        for (auto i = static_cast<std::size_t>(0); i < sizeof(UInt); ++i)
+        {
+            p_bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    struct v2_header_type
+    {
+        std::uint32_t flags;
+
+        std::uint64_t base_check_offset;
+
+        std::uint64_t base_check_count;
+
+        std::uint64_t value_section_offset;
+
+        std::uint64_t value_section_size;
+
+        std::uint64_t file_size;
+
+        std::uint64_t preceding_key_count_offset;
+
+        bool wide() const
+        {
+            return (flags & v2_wide_flag()) != 0;
+        }
+
+        bool counted() const
+        {
+            return (flags & v2_counted_flag()) != 0;
+        }
+
+        std::size_t base_check_element_size() const
+        {
+            return wide() ? sizeof(std::uint64_t) : sizeof(std::uint32_t);
+        }
+    };
+
+    inline bool is_v2_magic(const char* const p_bytes)
+    {
+        for (auto i = static_cast<std::size_t>(0); i < v2_magic_size(); ++i)
+        {
+            if (p_bytes[i] != v2_magic_byte_at(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline void store_v2_header(const v2_header_type& header, char* const p_bytes)
+    {
+        std::fill(p_bytes, p_bytes + v2_header_size(), '\0');
+        for (auto i = static_cast<std::size_t>(0); i < v2_magic_size(); ++i)
+        {
+            p_bytes[i] = v2_magic_byte_at(i);
+        }
+        store_little_endian<std::uint32_t>(v2_version(), p_bytes + 8);
+        store_little_endian<std::uint32_t>(header.flags, p_bytes + 12);
+        store_little_endian<std::uint64_t>(header.base_check_offset, p_bytes + 16);
+        store_little_endian<std::uint64_t>(header.base_check_count, p_bytes + 24);
+        store_little_endian<std::uint64_t>(header.value_section_offset, p_bytes + 32);
+        store_little_endian<std::uint64_t>(header.value_section_size, p_bytes + 40);
+        store_little_endian<std::uint64_t>(header.file_size, p_bytes + 48);
+        store_little_endian<std::uint64_t>(header.preceding_key_count_offset, p_bytes + 56);
+    }
+
+    /*
+        Loads the header and validates the section layout in O(1). available_size is the size of the content
+        available to the reader, or 0 when it is unknown.
+    */
+    inline v2_header_type load_v2_header(const char* const p_bytes, const std::uint64_t available_size)
+    {
+        if (!is_v2_magic(p_bytes))
+        {
+            throw std::ios_base::failure{ "Not a trie file of the format version 2." };
+        }
+        if (load_little_endian<std::uint32_t>(p_bytes + 8) != v2_version())
+        {
+            throw std::ios_base::failure{ "Unsupported trie file format version." };
+        }
+
+        const v2_header_type header{ load_little_endian<std::uint32_t>(p_bytes + 12),
+                                     load_little_endian<std::uint64_t>(p_bytes + 16),
+                                     load_little_endian<std::uint64_t>(p_bytes + 24),
+                                     load_little_endian<std::uint64_t>(p_bytes + 32),
+                                     load_little_endian<std::uint64_t>(p_bytes + 40),
+                                     load_little_endian<std::uint64_t>(p_bytes + 48),
+                                     load_little_endian<std::uint64_t>(p_bytes + 56) };
+        const auto          base_check_size = header.base_check_count * header.base_check_element_size();
+        const auto          base_check_tail = header.base_check_offset + base_check_size;
+        const auto          preceding_key_count_tail =
+            header.counted() ? header.preceding_key_count_offset + header.base_check_count * sizeof(std::uint32_t) :
+                               base_check_tail;
+        if (header.base_check_offset < v2_header_size() || header.base_check_offset > header.file_size ||
+            header.base_check_count >
+                (header.file_size - header.base_check_offset) / header.base_check_element_size() ||
+            (header.counted() && (header.preceding_key_count_offset < base_check_tail ||
+                                  header.preceding_key_count_offset > header.file_size)) ||
+            header.value_section_offset < preceding_key_count_tail ||
+            header.value_section_size < v2_value_section_header_size() ||
+            header.value_section_offset > header.file_size ||
+            header.value_section_size > header.file_size - header.value_section_offset ||
+            (available_size > 0 && header.file_size > available_size))
+        {
+            throw std::ios_base::failure{ "Broken trie file header." };
+        }
+        return header;
+    }
+
+
+}
+
+
+#endif
+
+#endif
@@ -0,0 +1,473 @@
+/*! \file
+    \brief A stream builder.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#include <algorithm>
+#include <any>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include <tetengo/trie/default_serializer.hpp>
+#include <tetengo/trie/double_array.hpp>
+#include <tetengo/trie/stream_builder.hpp>
+#include <tetengo/trie/value_serializer.hpp>
+
+#include "tetengo.trie.base_check_layout.hpp"
+#include "tetengo.trie.value_section_layout.hpp"
+
+
+namespace tetengo::trie
+{
+    class stream_builder::impl : private boost::noncopyable
+    {
+    public:
+        // static functions
+
+        static std::size_t default_window_size()
+        {
+            return 1024 * 1024;
+        }
+
+
+        // constructors and destructor
+
+        impl(
+            std::ostream&           output_stream,
+            const value_serializer& value_serializer_,
+            const std::size_t       window_size,
+            const bool              wide) :
+        m_output_stream{ output_stream },
+        m_value_serializer{ value_serializer_ },
+        m_window_size{ window_size },
+        m_wide{ wide },
+        m_p_value_buffer{ std::tmpfile(), std::fclose },
+        m_value_count{ 0 },
+        m_value_offsets{ 0 },
+        m_o_last_key{},
+        m_path{ node_type{ 0, {} } },
+        m_origin{ output_stream.tellp() },
+        m_flushed_size{ 1 },
+        m_window{},
+        m_used_bases{},
+        m_first_vacant_index{ 1 },
+        m_finished{ false }
+        {
+            if (window_size == 0)
+            {
+                throw std::invalid_argument{ "window_size must be greater than 0." };
+            }
+            if (!m_output_stream || m_origin < 0)
+            {
+                throw std::ios_base::failure{ "Bad output_stream." };
+            }
+            if (!m_p_value_buffer)
+            {
+                throw std::ios_base::failure{ "Can't create a temporary file." };
+            }
+
+            // The base-check size and the root element are written at last.
+            if (m_wide)
+            {
+                write_uint32(m_output_stream, wide_base_check_marker());
+            }
+            write_uint32(m_output_stream, 0);
+            write_base_check(0);
+        }
+
+
+        // functions
+
+        void add(const std::string_view& key, const std::any& value)
+        {
+            if (m_finished)
+            {
+                throw std::logic_error{ "The building is already finished." };
+            }
+            if (m_o_last_key && key <= *m_o_last_key)
+            {
+                throw std::invalid_argument{ "The key is not greater than the last key." };
+            }
+
+            const auto common_prefix_length = common_prefix_length_with_last_key(key);
+            while (std::size(m_path) > common_prefix_length + 1)
+            {
+                close_node();
+            }
+            for (auto i = std::size(m_path) - 1; i < key.length(); ++i)
+            {
+                m_path.push_back(node_type{ static_cast<std::uint8_t>(key[i]), {} });
+            }
+            m_path.back().children.emplace_back(
+                static_cast<std::uint8_t>(double_array::key_terminator()), static_cast<std::int32_t>(m_value_count));
+
+            write_value(value);
+            ++m_value_count;
+            m_o_last_key = std::string{ key };
+        }
+
+        void finish()
+        {
+            if (m_finished)
+            {
+                throw std::logic_error{ "The building is already finished." };
+            }
+            m_finished = true;
+
+            while (std::size(m_path) > 1)
+            {
+                close_node();
+            }
+            const auto root_base = std::empty(m_path[0].children) ? 0 : place(m_path[0].children);
+            flush(std::size(m_window));
+
+            write_value_section();
+
+            const auto end = m_output_stream.tellp();
+            m_output_stream.seekp(m_origin + static_cast<std::streamoff>(m_wide ? sizeof(std::uint32_t) : 0));
+            assert(m_flushed_size < std::numeric_limits<std::uint32_t>::max());
+            write_uint32(m_output_stream, static_cast<std::uint32_t>(m_flushed_size));
+            write_base_check(base_check_of(root_base, double_array::vacant_check_value()));
+            m_output_stream.seekp(end);
+            if (!m_output_stream)
+            {
+                throw std::ios_base::failure{ "Can't write the trie." };
+            }
+        }
+
+
+    private:
+        // types
+
+        struct node_type
+        {
+            std::uint8_t char_code;
+
+            std::vector<std::pair<std::uint8_t, std::int32_t>> children;
+        };
+
+
+        // static functions
+
+        static std::vector<char> serialize_uint32(const std::uint32_t value)
+        {
+            static const default_serializer<std::uint32_t> uint32_serializer{ false };
+            return uint32_serializer(value);
+        }
+
+        static void write_uint32(std::ostream& output_stream, const std::uint32_t value)
+        {
+            const auto serialized = serialize_uint32(value);
+            output_stream.write(std::data(serialized), std::size(serialized));
+        }
+
+        static void write_uint64(std::ostream& output_stream, const std::uint64_t value)
+        {
+            static const default_serializer<std::uint64_t> uint64_serializer{ false };
+            const auto                                     serialized = uint64_serializer(value);
+            output_stream.write(std::data(serialized), std::size(serialized));
+        }
+
+        static constexpr std::size_t value_buffer_chunk_size()
+        {
+            return 65536;
+        }
+
+
+        // variables
+
+        std::ostream& m_output_stream;
+
+        const value_serializer m_value_serializer;
+
+        const std::size_t m_window_size;
+
+        const bool m_wide;
+
+        const std::unique_ptr<std::FILE, decltype(&std::fclose)> m_p_value_buffer;
+
+        std::size_t m_value_count;
+
+        std::vector<std::uint32_t> m_value_offsets;
+
+        std::optional<std::string> m_o_last_key;
+
+        std::vector<node_type> m_path;
+
+        const std::ostream::pos_type m_origin;
+
+        std::size_t m_flushed_size;
+
+        std::deque<std::uint64_t> m_window;
+
+        std::deque<bool> m_used_bases;
+
+        std::size_t m_first_vacant_index;
+
+        bool m_finished;
+
+
+        // functions
+
+        std::uint64_t base_check_of(const std::int32_t base, const std::uint8_t check) const
+        {
+            if (!m_wide && !fits_narrow_base(base))
+            {
+                throw std::length_error{ "The base does not fit in the narrow layout." };
+            }
+            return wide_base_check_of(base, check);
+        }
+
+        void write_base_check(const std::uint64_t base_check)
+        {
+            if (m_wide)
+            {
+                write_uint64(m_output_stream, base_check);
+            }
+            else
+            {
+                const auto narrow_base_check =
+                    narrow_base_check_of(wide_base_of(base_check), static_cast<std::uint8_t>(base_check));
+                write_uint32(m_output_stream, narrow_base_check);
+            }
+        }
+
+        std::size_t common_prefix_length_with_last_key(const std::string_view& key) const
+        {
+            if (!m_o_last_key)
+            {
+                return 0;
+            }
+            const auto mismatched =
+                std::mismatch(std::begin(key), std::end(key), std::begin(*m_o_last_key), std::end(*m_o_last_key));
+            return static_cast<std::size_t>(std::distance(std::begin(key), mismatched.first));
+        }
+
+        void close_node()
+        {
+            auto node = std::move(m_path.back());
+            m_path.pop_back();
+
+            const auto base = place(node.children);
+            m_path.back().children.emplace_back(node.char_code, base);
+        }
+
+        std::int32_t place(const std::vector<std::pair<std::uint8_t, std::int32_t>>& children)
+        {
+            assert(!std::empty(children));
+            for (auto index = first_vacant_from(m_first_vacant_index);; index = first_vacant_from(index + 1))
+            {
+                const auto base = static_cast<std::int32_t>(index) - children[0].first;
+                if (base_used(base))
+                {
+                    continue;
+                }
+                const auto collided =
+                    std::any_of(std::next(std::begin(children)), std::end(children), [this, base](const auto& child) {
+                        return occupied(static_cast<std::size_t>(base + child.first));
+                    });
+                if (collided)
+                {
+                    continue;
+                }
+
+                use_base(base);
+                for (const auto& child: children)
+                {
+                    set_base_check_at(
+                        static_cast<std::size_t>(base + child.first), base_check_of(child.second, child.first));
+                }
+                m_first_vacant_index = first_vacant_from(m_first_vacant_index);
+                if (std::size(m_window) > m_window_size)
+                {
+                    flush(std::size(m_window) - m_window_size / 2);
+                }
+                return base;
+            }
+        }
+
+        std::size_t first_vacant_from(std::size_t index) const
+        {
+            while (occupied(index))
+            {
+                ++index;
+            }
+            return index;
+        }
+
+        bool occupied(const std::size_t index) const
+        {
+            assert(index >= m_flushed_size);
+            const auto offset = index - m_flushed_size;
+            return offset < std::size(m_window) && (m_window[offset] & 0xFF) != double_array::vacant_check_value();
+        }
+
+        void set_base_check_at(const std::size_t index, const std::uint64_t base_check)
+        {
+            assert(index >= m_flushed_size);
+            const auto offset = index - m_flushed_size;
+            if (offset >= std::size(m_window))
+            {
+                m_window.resize(offset + 1, base_check_of(0, double_array::vacant_check_value()));
+            }
+            m_window[offset] = base_check;
+        }
+
+        // The bases are tracked from 256 elements before the window, since a base may be less than the index of its
+        // first child by up to 255.
+        std::size_t base_offset(const std::int32_t base) const
+        {
+            const auto offset = static_cast<std::int64_t>(base) - static_cast<std::int64_t>(m_flushed_size) +
+                                std::numeric_limits<std::uint8_t>::max() + 1;
+            assert(offset >= 0);
+            return static_cast<std::size_t>(offset);
+        }
+
+        bool base_used(const std::int32_t base) const
+        {
+            const auto offset = base_offset(base);
+            return offset < std::size(m_used_bases) && m_used_bases[offset];
+        }
+
+        void use_base(const std::int32_t base)
+        {
+            const auto offset = base_offset(base);
+            if (offset >= std::size(m_used_bases))
+            {
+                m_used_bases.resize(offset + 1, false);
+            }
+            m_used_bases[offset] = true;
+        }
+
+        void flush(const std::size_t count)
+        {
+            assert(count <= std::size(m_window));
+            for (auto i = std::begin(m_window); i != std::next(std::begin(m_window), count); ++i)
+            {
+                write_base_check(*i);
+            }
+            if (!m_output_stream)
+            {
+                throw std::ios_base::failure{ "Can't write the base-check array." };
+            }
+            m_window.erase(std::begin(m_window), std::next(std::begin(m_window), count));
+            const auto used_base_count = std::min(count, std::size(m_used_bases));
+            m_used_bases.erase(std::begin(m_used_bases), std::next(std::begin(m_used_bases), used_base_count));
+            m_flushed_size += count;
+            m_first_vacant_index = first_vacant_from(std::max(m_first_vacant_index, m_flushed_size));
+        }
+
+        void write_value(const std::any& value)
+        {
+            const auto serialized = m_value_serializer(value);
+            const auto fixed_value_size = m_value_serializer.fixed_value_size();
+            if (m_value_serializer.indexed())
+            {
+                const auto offset = static_cast<std::size_t>(m_value_offsets.back()) + std::size(serialized);
+                if (offset > std::numeric_limits<std::uint32_t>::max())
+                {
+                    throw std::length_error{ "The values are too large to be indexed." };
+                }
+                m_value_offsets.push_back(static_cast<std::uint32_t>(offset));
+            }
+            else if (fixed_value_size == 0)
+            {
+                assert(std::size(serialized) < std::numeric_limits<std::uint32_t>::max());
+                write_to_value_buffer(serialize_uint32(static_cast<std::uint32_t>(std::size(serialized))));
+            }
+            else
+            {
+                assert(std::size(serialized) == fixed_value_size);
+            }
+            write_to_value_buffer(serialized);
+        }
+
+        void write_to_value_buffer(const std::vector<char>& bytes)
+        {
+            if (std::fwrite(std::data(bytes), 1, std::size(bytes), m_p_value_buffer.get()) != std::size(bytes))
+            {
+                throw std::ios_base::failure{ "Can't write the value to the temporary file." };
+            }
+        }
+
+        void write_value_section()
+        {
+            assert(m_value_count < std::numeric_limits<std::uint32_t>::max());
+            write_uint32(m_output_stream, static_cast<std::uint32_t>(m_value_count));
+            if (m_value_serializer.indexed())
+            {
+                write_uint32(m_output_stream, indexed_value_size_marker());
+                for (const auto offset: m_value_offsets)
+                {
+                    write_uint32(m_output_stream, offset);
+                }
+            }
+            else
+            {
+                assert(m_value_serializer.fixed_value_size() < std::numeric_limits<std::uint32_t>::max());
+                write_uint32(m_output_stream, static_cast<std::uint32_t>(m_value_serializer.fixed_value_size()));
+            }
+
+            std::rewind(m_p_value_buffer.get());
+            std::vector<char> chunk(value_buffer_chunk_size(), 0);
+            for (;;)
+            {
+                const auto read_size = std::fread(std::data(chunk), 1, std::size(chunk), m_p_value_buffer.get());
+                m_output_stream.write(std::data(chunk), read_size);
+                if (read_size < std::size(chunk))
+                {
+                    break;
+                }
+            }
+            if (std::ferror(m_p_value_buffer.get()))
+            {
+                throw std::ios_base::failure{ "Can't read the values from the temporary file." };
+            }
+        }
+    };
+
+
+    std::size_t stream_builder::default_window_size()
+    {
+        return impl::default_window_size();
+    }
+
+    stream_builder::stream_builder(
+        std::ostream&           output_stream,
+        const value_serializer& value_serializer_,
+        const std::size_t       window_size /*= default_window_size()*/,
+        const bool              wide /*= false*/) :
+    m_p_impl{ std::make_unique<impl>(output_stream, value_serializer_, window_size, wide) }
+    {}
+
+    stream_builder::~stream_builder() = default;
+
+    void stream_builder::add(const std::string_view& key, const std::any& value)
+    {
+        m_p_impl->add(key, value);
+    }
+
+    void stream_builder::finish()
+    {
+        m_p_impl->finish();
+    }
+
+
+}
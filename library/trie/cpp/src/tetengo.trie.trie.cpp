@@ -23,6 +23,8 @@
 #include <tetengo/trie/trie.hpp>
 #include <tetengo/trie/trie_iterator.hpp>
 
+#include "tetengo.trie.double_array_builder.hpp"
+
 
 namespace tetengo::trie
 {
@@ -33,6 +35,8 @@ namespace tetengo::trie
 
         using building_observer_set_type = trie_impl::building_observer_set_type;
 
+        using fuzzy_search_element_type = trie_impl::fuzzy_search_element_type;
+
 
         // static functions
 
@@ -47,6 +51,11 @@ namespace tetengo::trie
             return double_array::default_density_factor();
         }
 
+        static std::size_t default_double_array_build_thread_count()
+        {
+            return double_array::default_build_thread_count();
+        }
+
 
         // constructors and destructor
 
@@ -55,7 +64,9 @@ namespace tetengo::trie
         impl(
             std::vector<std::pair<std::string_view, std::any>> elements,
             const building_observer_set_type&                  building_observer_set,
-            const std::size_t                                  double_array_density_factor) :
+            const std::size_t                                  double_array_density_factor,
+            const std::size_t                                  double_array_build_thread_count,
+            const bool                                         double_array_minimized) :
         m_p_double_array{}
         {
             std::vector<std::pair<std::string_view, std::int32_t>> double_array_contents{};
@@ -65,15 +76,29 @@ namespace tetengo::trie
                 double_array_contents.emplace_back(std::move(elements[i].first), i);
             }
 
-            const double_array::building_observer_set_type double_array_building_observer_set{
-                [&building_observer_set](const std::pair<std::string_view, std::int32_t>& element) {
-                    building_observer_set.adding(element.first);
-                },
-                [&building_observer_set]() { building_observer_set.done(); }
-            };
+            build_double_array(
+                double_array_contents,
+                building_observer_set,
+                double_array_density_factor,
+                double_array_build_thread_count,
+                double_array_minimized ? double_array_builder::minimization_type::counted_values :
+                                         double_array_builder::minimization_type::none);
 
-            m_p_double_array = std::make_unique<double_array>(
-                double_array_contents, double_array_building_observer_set, double_array_density_factor);
+            if (double_array_minimized)
+            {
+                // The value indices are counted in ascending order of the keys. Of the elements with the same key, the
+                // first one is taken as in the double array not minimized.
+                auto& storage_ = m_p_double_array->get_storage();
+                for (auto& element: elements)
+                {
+                    const auto value_index = static_cast<std::size_t>(*m_p_double_array->find(element.first));
+                    if (!storage_.value_at(value_index))
+                    {
+                        storage_.add_value_at(value_index, std::move(element.second));
+                    }
+                }
+                return;
+            }
 
             for (auto i = static_cast<std::int32_t>(0); i < static_cast<std::int32_t>(std::size(elements)); ++i)
             {
@@ -84,12 +109,41 @@ namespace tetengo::trie
         impl(
             std::vector<std::pair<std::string, std::any>> elements,
             const building_observer_set_type&             building_observer_set,
-            const std::size_t                             double_array_density_factor) :
+            const std::size_t                             double_array_density_factor,
+            const std::size_t                             double_array_build_thread_count,
+            const bool                                    double_array_minimized) :
         impl{ std::vector<std::pair<std::string_view, std::any>>{ std::begin(elements), std::end(elements) },
               building_observer_set,
-              double_array_density_factor }
+              double_array_density_factor,
+              double_array_build_thread_count,
+              double_array_minimized }
         {}
 
+        impl(
+            std::vector<std::string_view>     keys,
+            const building_observer_set_type& building_observer_set,
+            const std::size_t                 double_array_density_factor,
+            const std::size_t                 double_array_build_thread_count,
+            const bool                        double_array_minimized) :
+        m_p_double_array{}
+        {
+            // The keys share the value index so that a minimized double array can merge their suffixes.
+            std::vector<std::pair<std::string_view, std::int32_t>> double_array_contents{};
+            double_array_contents.reserve(std::size(keys));
+            for (const auto& key: keys)
+            {
+                double_array_contents.emplace_back(key, 0);
+            }
+
+            build_double_array(
+                double_array_contents,
+                building_observer_set,
+                double_array_density_factor,
+                double_array_build_thread_count,
+                double_array_minimized ? double_array_builder::minimization_type::terminator_values :
+                                         double_array_builder::minimization_type::none);
+        }
+
         explicit impl(std::unique_ptr<storage>&& p_storage) :
         m_p_double_array{ std::make_unique<double_array>(std::move(p_storage), 0) }
         {}
@@ -101,12 +155,13 @@ namespace tetengo::trie
 
         bool empty() const
         {
-            return m_p_double_array->get_storage().value_count() == 0;
+            return size() == 0;
         }
 
         std::size_t size() const
         {
-            return m_p_double_array->get_storage().value_count();
+            const auto& storage_ = m_p_double_array->get_storage();
+            return storage_.value_count() - storage_.vacant_value_count();
         }
 
         bool contains(const std::string_view& key) const
@@ -124,6 +179,84 @@ namespace tetengo::trie
             return m_p_double_array->get_storage().value_at(*o_index);
         }
 
+        std::vector<const std::any*> find_batch(const std::vector<std::string_view>& keys) const
+        {
+            const auto o_indices = m_p_double_array->find_batch(keys);
+
+            std::vector<const std::any*> found{};
+            found.reserve(std::size(o_indices));
+            for (const auto& o_index: o_indices)
+            {
+                found.push_back(o_index ? m_p_double_array->get_storage().value_at(*o_index) : nullptr);
+            }
+            return found;
+        }
+
+        std::optional<std::size_t> find_value_index(const std::string_view& key) const
+        {
+            const auto o_index = m_p_double_array->find(key);
+            if (!o_index)
+            {
+                return std::nullopt;
+            }
+            return std::make_optional(static_cast<std::size_t>(*o_index));
+        }
+
+        std::vector<std::optional<std::size_t>>
+        find_batch_value_indices(const std::vector<std::string_view>& keys) const
+        {
+            const auto o_indices = m_p_double_array->find_batch(keys);
+
+            std::vector<std::optional<std::size_t>> found{};
+            found.reserve(std::size(o_indices));
+            for (const auto& o_index: o_indices)
+            {
+                found.push_back(o_index ? std::make_optional(static_cast<std::size_t>(*o_index)) : std::nullopt);
+            }
+            return found;
+        }
+
+        std::vector<std::pair<std::size_t, const std::any*>> common_prefix_search(const std::string_view& key) const
+        {
+            const auto found_indices = m_p_double_array->common_prefix_search(key);
+
+            std::vector<std::pair<std::size_t, const std::any*>> found{};
+            found.reserve(std::size(found_indices));
+            for (const auto& e: found_indices)
+            {
+                found.emplace_back(e.first, m_p_double_array->get_storage().value_at(e.second));
+            }
+            return found;
+        }
+
+        std::vector<std::pair<std::size_t, std::size_t>>
+        common_prefix_search_value_indices(const std::string_view& key) const
+        {
+            const auto found_indices = m_p_double_array->common_prefix_search(key);
+
+            std::vector<std::pair<std::size_t, std::size_t>> found{};
+            found.reserve(std::size(found_indices));
+            for (const auto& e: found_indices)
+            {
+                found.emplace_back(e.first, static_cast<std::size_t>(e.second));
+            }
+            return found;
+        }
+
+        std::vector<fuzzy_search_element_type>
+        fuzzy_search_value_indices(const std::string_view& key, const std::size_t max_distance) const
+        {
+            auto found_indices = m_p_double_array->fuzzy_search(key, max_distance);
+
+            std::vector<fuzzy_search_element_type> found{};
+            found.reserve(std::size(found_indices));
+            for (auto& e: found_indices)
+            {
+                found.push_back({ std::move(e.key), e.distance, static_cast<std::size_t>(e.value) });
+            }
+            return found;
+        }
+
         trie_iterator_impl begin() const
         {
             return trie_iterator_impl{ std::begin(*m_p_double_array), m_p_double_array->get_storage() };
@@ -144,6 +277,45 @@ namespace tetengo::trie
             return std::make_unique<trie_impl>(std::move(p_subtrie));
         }
 
+        std::unique_ptr<storage> relocated_storage(const std::vector<std::string_view>& sample_keys) const
+        {
+            return m_p_double_array->relocated_storage(sample_keys);
+        }
+
+        bool insert(const std::string_view& key, std::any value)
+        {
+            // The double array is modified first, since it may refuse the modification. The value is added after it and
+            // the key is erased again when the value can't be added, so that a failed insertion modifies nothing.
+            // A value index vacated by an erasure is reused.
+            auto&      storage_ = m_p_double_array->get_storage();
+            const auto value_index = storage_.vacant_value_index().value_or(storage_.value_count());
+            if (!m_p_double_array->insert(key, static_cast<std::int32_t>(value_index)))
+            {
+                return false;
+            }
+            try
+            {
+                storage_.add_value_at(value_index, std::move(value));
+            }
+            catch (...)
+            {
+                m_p_double_array->erase(key);
+                throw;
+            }
+            return true;
+        }
+
+        bool erase(const std::string_view& key)
+        {
+            const auto o_value_index = m_p_double_array->find(key);
+            if (!o_value_index || !m_p_double_array->erase(key))
+            {
+                return false;
+            }
+            m_p_double_array->get_storage().erase_value_at(*o_value_index);
+            return true;
+        }
+
         const storage& get_storage() const
         {
             return m_p_double_array->get_storage();
@@ -154,6 +326,33 @@ namespace tetengo::trie
         // variables
 
         std::unique_ptr<double_array> m_p_double_array;
+
+
+        // functions
+
+        void build_double_array(
+            const std::vector<std::pair<std::string_view, std::int32_t>>& double_array_contents,
+            const building_observer_set_type&                             building_observer_set,
+            const std::size_t                                             double_array_density_factor,
+            const std::size_t                                             double_array_build_thread_count,
+            const double_array_builder::minimization_type                 double_array_minimization)
+        {
+            const double_array::building_observer_set_type double_array_building_observer_set{
+                [&building_observer_set](const std::pair<std::string_view, std::int32_t>& element) {
+                    building_observer_set.adding(element.first);
+                },
+                [&building_observer_set]() { building_observer_set.done(); }
+            };
+
+            m_p_double_array = std::make_unique<double_array>(
+                double_array_builder::build(
+                    double_array_contents,
+                    double_array_building_observer_set,
+                    double_array_density_factor,
+                    double_array_build_thread_count,
+                    double_array_minimization),
+                0);
+        }
     };
 
 
@@ -167,20 +366,53 @@ namespace tetengo::trie
         return impl::default_double_array_density_factor();
     }
 
+    std::size_t trie_impl::default_double_array_build_thread_count()
+    {
+        return impl::default_double_array_build_thread_count();
+    }
+
     trie_impl::trie_impl() : m_p_impl{ std::make_unique<impl>() } {}
 
     trie_impl::trie_impl(
         std::vector<std::pair<std::string_view, std::any>> elements,
         const building_observer_set_type&                  building_observer_set,
-        const std::size_t                                  double_array_density_factor) :
-    m_p_impl{ std::make_unique<impl>(std::move(elements), building_observer_set, double_array_density_factor) }
+        const std::size_t                                  double_array_density_factor,
+        const std::size_t                                  double_array_build_thread_count,
+        const bool                                         double_array_minimized) :
+    m_p_impl{ std::make_unique<impl>(
+        std::move(elements),
+        building_observer_set,
+        double_array_density_factor,
+        double_array_build_thread_count,
+        double_array_minimized) }
     {}
 
     trie_impl::trie_impl(
         std::vector<std::pair<std::string, std::any>> elements,
         const building_observer_set_type&             building_observer_set,
-        const std::size_t                             double_array_density_factor) :
-    m_p_impl{ std::make_unique<impl>(std::move(elements), building_observer_set, double_array_density_factor) }
+        const std::size_t                             double_array_density_factor,
+        const std::size_t                             double_array_build_thread_count,
+        const bool                                    double_array_minimized) :
+    m_p_impl{ std::make_unique<impl>(
+        std::move(elements),
+        building_observer_set,
+        double_array_density_factor,
+        double_array_build_thread_count,
+        double_array_minimized) }
+    {}
+
+    trie_impl::trie_impl(
+        std::vector<std::string_view>     keys,
+        const building_observer_set_type& building_observer_set,
+        const std::size_t                 double_array_density_factor,
+        const std::size_t                 double_array_build_thread_count,
+        const bool                        double_array_minimized) :
+    m_p_impl{ std::make_unique<impl>(
+        std::move(keys),
+        building_observer_set,
+        double_array_density_factor,
+        double_array_build_thread_count,
+        double_array_minimized) }
     {}
 
     trie_impl::trie_impl(std::unique_ptr<storage>&& p_storage) :
@@ -215,6 +447,40 @@ namespace tetengo::trie
         return m_p_impl->find(key);
     }
 
+    std::vector<const std::any*> trie_impl::find_batch(const std::vector<std::string_view>& keys) const
+    {
+        return m_p_impl->find_batch(keys);
+    }
+
+    std::optional<std::size_t> trie_impl::find_value_index(const std::string_view& key) const
+    {
+        return m_p_impl->find_value_index(key);
+    }
+
+    std::vector<std::optional<std::size_t>>
+    trie_impl::find_batch_value_indices(const std::vector<std::string_view>& keys) const
+    {
+        return m_p_impl->find_batch_value_indices(keys);
+    }
+
+    std::vector<std::pair<std::size_t, const std::any*>>
+    trie_impl::common_prefix_search(const std::string_view& key) const
+    {
+        return m_p_impl->common_prefix_search(key);
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>>
+    trie_impl::common_prefix_search_value_indices(const std::string_view& key) const
+    {
+        return m_p_impl->common_prefix_search_value_indices(key);
+    }
+
+    std::vector<trie_impl::fuzzy_search_element_type>
+    trie_impl::fuzzy_search_value_indices(const std::string_view& key, const std::size_t max_distance) const
+    {
+        return m_p_impl->fuzzy_search_value_indices(key, max_distance);
+    }
+
     trie_iterator_impl trie_impl::begin() const
     {
         return m_p_impl->begin();
@@ -230,6 +496,21 @@ namespace tetengo::trie
         return m_p_impl->subtrie(key_prefix);
     }
 
+    std::unique_ptr<storage> trie_impl::relocated_storage(const std::vector<std::string_view>& sample_keys) const
+    {
+        return m_p_impl->relocated_storage(sample_keys);
+    }
+
+    bool trie_impl::insert(const std::string_view& key, std::any value)
+    {
+        return m_p_impl->insert(key, std::move(value));
+    }
+
+    bool trie_impl::erase(const std::string_view& key)
+    {
+        return m_p_impl->erase(key);
+    }
+
     const storage& trie_impl::get_storage() const
     {
         return m_p_impl->get_storage();
@@ -5,6 +5,10 @@
 */
 
 #include <any>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <typeinfo>
 #include <utility>
 
 #include <tetengo/trie/double_array_iterator.hpp>
@@ -16,19 +20,46 @@ namespace tetengo::trie
 {
     trie_iterator_impl::trie_iterator_impl(double_array_iterator double_array_iterator_, storage& storage_) :
     m_double_array_iterator{ std::move(double_array_iterator_) },
-    m_p_storage{ &storage_ }
+    m_p_storage{ &storage_ },
+    m_o_value_array_view{ storage_.value_array_view() },
+    m_p_value{}
     {}
 
-    trie_iterator_impl::trie_iterator_impl() : m_double_array_iterator{}, m_p_storage{ nullptr } {}
+    trie_iterator_impl::trie_iterator_impl() :
+    m_double_array_iterator{},
+    m_p_storage{ nullptr },
+    m_o_value_array_view{},
+    m_p_value{}
+    {}
 
     std::any& trie_iterator_impl::operator*()
     {
-        return const_cast<std::any&>(*m_p_storage->value_at(*m_double_array_iterator));
+        return const_cast<std::any&>(value());
     }
 
     const std::any& trie_iterator_impl::operator*() const
     {
-        return *m_p_storage->value_at(*m_double_array_iterator);
+        return value();
+    }
+
+    std::string_view trie_iterator_impl::key() const
+    {
+        return m_double_array_iterator.key();
+    }
+
+    std::size_t trie_iterator_impl::value_index() const
+    {
+        return static_cast<std::size_t>(*m_double_array_iterator);
+    }
+
+    const storage::value_array_view_type*
+    trie_iterator_impl::typed_value_array_view(const std::type_info& value_type) const
+    {
+        if (!m_o_value_array_view || *m_o_value_array_view->p_value_type != value_type)
+        {
+            return nullptr;
+        }
+        return &*m_o_value_array_view;
     }
 
     bool operator==(const trie_iterator_impl& one, const trie_iterator_impl& another)
@@ -39,8 +70,18 @@ namespace tetengo::trie
     trie_iterator_impl& trie_iterator_impl::operator++()
     {
         ++m_double_array_iterator;
+        m_p_value.reset();
         return *this;
     }
 
+    const std::any& trie_iterator_impl::value() const
+    {
+        if (!m_p_value)
+        {
+            m_p_value = m_p_storage->shared_value_at(*m_double_array_iterator);
+        }
+        return *m_p_value;
+    }
+
 
 }
@@ -0,0 +1,46 @@
+/*! \file
+    \brief A value section layout.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(DOCUMENTATION)
+
+#if !defined(TETENGO_TRIE_VALUESECTIONLAYOUT_HPP)
+#define TETENGO_TRIE_VALUESECTIONLAYOUT_HPP
+
+#include <cstdint>
+
+
+namespace tetengo::trie
+{
+    /*
+        A serialized value section starts with the value count and the value size word.
+
+        When the value size word is a positive size, the values of that size follow. A value filled with
+        uninitialized_value_byte() is absent.
+
+        When the value size word is 0, each value follows its size. A value of size 0 is absent.
+
+        When the value size word is indexed_value_size_marker(), the offset table of (value count + 1) words follows,
+        and then the values. The i-th value occupies [offset i, offset i + 1) from the head of the values, and an
+        empty one is absent. So a value can be located without reading the preceding ones.
+    */
+
+    inline constexpr std::uint32_t indexed_value_size_marker()
+    {
+        return 0xFFFFFFFF;
+    }
+
+    inline constexpr char uninitialized_value_byte()
+    {
+        return static_cast<char>(0xFF);
+    }
+
+
+}
+
+
+#endif
+
+#endif
@@ -17,9 +17,11 @@ namespace tetengo::trie
 {
     value_serializer::value_serializer(
         std::function<std::vector<char>(const std::any&)> serialize,
-        const std::size_t                                 fixed_value_size) :
+        const std::size_t                                 fixed_value_size,
+        const bool                                        indexed /*= false*/) :
     m_serialize{ std::move(serialize) },
-    m_fixed_value_size{ fixed_value_size }
+    m_fixed_value_size{ fixed_value_size },
+    m_indexed{ fixed_value_size == 0 && indexed }
     {}
 
     std::vector<char> value_serializer::operator()(const std::any& value) const
@@ -32,6 +34,11 @@ namespace tetengo::trie
         return m_fixed_value_size;
     }
 
+    bool value_serializer::indexed() const
+    {
+        return m_indexed;
+    }
+
 
     value_deserializer::value_deserializer(std::function<std::any(const std::vector<char>&)> deserialize) :
     m_deserialize{ std::move(deserialize) }
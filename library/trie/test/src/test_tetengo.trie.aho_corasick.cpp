@@ -0,0 +1,288 @@
+/*! \file
+    \brief An Aho-Corasick automaton.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tetengo/trie/aho_corasick.hpp>
+#include <tetengo/trie/default_serializer.hpp>
+#include <tetengo/trie/double_array.hpp>
+#include <tetengo/trie/memory_storage.hpp>
+#include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/trie_set.hpp>
+#include <tetengo/trie/value_serializer.hpp>
+
+
+namespace
+{
+    using match_type = std::tuple<std::size_t, std::size_t, std::int32_t>;
+
+    const std::vector<std::pair<std::string, std::int32_t>> elements{
+        { "he", 0 }, { "she", 1 }, { "his", 2 }, { "hers", 3 }
+    };
+
+    const tetengo::trie::value_serializer& null_value_serializer()
+    {
+        static const tetengo::trie::value_serializer singleton{ [](const std::any&) { return std::vector<char>{}; },
+                                                                0 };
+        return singleton;
+    }
+
+    const tetengo::trie::value_deserializer& null_value_deserializer()
+    {
+        static const tetengo::trie::value_deserializer singleton{ [](const std::vector<char>&) { return std::any{}; } };
+        return singleton;
+    }
+
+    std::vector<match_type> scan(const tetengo::trie::aho_corasick& aho_corasick_, const std::string_view& text)
+    {
+        std::vector<match_type> matches{};
+        aho_corasick_.scan(
+            text, [&matches](const std::size_t position, const std::size_t length, const std::int32_t value) {
+                matches.emplace_back(position, length, value);
+            });
+        return matches;
+    }
+
+    std::vector<match_type> scan(const tetengo::trie::aho_corasick& aho_corasick_, std::istream& input_stream)
+    {
+        std::vector<match_type> matches{};
+        aho_corasick_.scan(
+            input_stream, [&matches](const std::size_t position, const std::size_t length, const std::int32_t value) {
+                matches.emplace_back(position, length, value);
+            });
+        return matches;
+    }
+
+    std::vector<match_type>
+    scan_naively(const tetengo::trie::double_array& double_array_, const std::string_view& text)
+    {
+        std::vector<match_type> matches{};
+        for (auto tail = static_cast<std::size_t>(1); tail <= std::size(text); ++tail)
+        {
+            for (auto position = static_cast<std::size_t>(0); position < tail; ++position)
+            {
+                if (const auto o_value = double_array_.find(text.substr(position, tail - position)); o_value)
+                {
+                    matches.emplace_back(position, tail - position, *o_value);
+                }
+            }
+        }
+        return matches;
+    }
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_tetengo)
+BOOST_AUTO_TEST_SUITE(trie)
+BOOST_AUTO_TEST_SUITE(aho_corasick)
+
+
+BOOST_AUTO_TEST_CASE(construction)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array double_array_{};
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+    }
+    {
+        const std::vector<std::string>             keys{ "Kumamoto", "Tamana", "Uto", "Yatsushiro", "Kikuchi" };
+        const tetengo::trie::trie_set<std::string> trie_set_{
+            std::begin(keys),
+            std::end(keys),
+            tetengo::trie::default_serializer<std::string>{ true },
+            tetengo::trie::trie_set<std::string>::null_building_observer_set(),
+            tetengo::trie::trie_set<std::string>::default_double_array_density_factor(),
+            tetengo::trie::trie_set<std::string>::default_double_array_build_thread_count(),
+            true
+        };
+        const tetengo::trie::double_array double_array_{ trie_set_.get_storage().clone(), 0 };
+
+        BOOST_CHECK_THROW(const tetengo::trie::aho_corasick aho_corasick_{ double_array_ }, std::invalid_argument);
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements,
+                                                         tetengo::trie::double_array::null_building_observer_set(),
+                                                         tetengo::trie::double_array::default_density_factor(),
+                                                         tetengo::trie::double_array::default_build_thread_count(),
+                                                         true };
+
+        BOOST_CHECK_THROW(const tetengo::trie::aho_corasick aho_corasick_{ double_array_ }, std::invalid_argument);
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        std::stringstream stream{};
+        aho_corasick_.serialize(stream);
+
+        const tetengo::trie::aho_corasick deserialized{ double_array_, stream };
+
+        BOOST_TEST((::scan(deserialized, "ushers") == ::scan(aho_corasick_, "ushers")));
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        std::stringstream stream{};
+        aho_corasick_.serialize(stream);
+
+        const std::vector<std::pair<std::string, std::int32_t>> another_elements{ { "Kumamoto", 42 } };
+        const tetengo::trie::double_array                       another{ another_elements };
+        BOOST_CHECK_THROW(const tetengo::trie::aho_corasick deserialized(another, stream), std::ios_base::failure);
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        std::stringstream stream{};
+        aho_corasick_.serialize(stream);
+
+        std::vector<std::pair<std::string, std::int32_t>> another_elements{ std::begin(elements), std::end(elements) };
+        another_elements[0].second = 42;
+        const tetengo::trie::double_array another{ another_elements };
+        BOOST_TEST_REQUIRE(another.get_storage().base_check_size() == double_array_.get_storage().base_check_size());
+        BOOST_TEST_REQUIRE(another.root_base_check_index() == double_array_.root_base_check_index());
+        BOOST_CHECK_THROW(const tetengo::trie::aho_corasick deserialized(another, stream), std::ios_base::failure);
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        std::stringstream stream{};
+        double_array_.get_storage().serialize(stream, null_value_serializer());
+        aho_corasick_.serialize(stream);
+
+        const tetengo::trie::double_array deserialized_double_array{
+            std::make_unique<tetengo::trie::memory_storage>(stream, null_value_deserializer()), 0
+        };
+        const tetengo::trie::aho_corasick deserialized{ deserialized_double_array, stream };
+
+        BOOST_TEST((::scan(deserialized, "ushers") == ::scan(aho_corasick_, "ushers")));
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        std::stringstream stream{};
+        aho_corasick_.serialize(stream);
+        const auto serialized = stream.str();
+
+        std::stringstream truncated{ serialized.substr(0, std::size(serialized) - 1) };
+        BOOST_CHECK_THROW(
+            const tetengo::trie::aho_corasick deserialized(double_array_, truncated), std::ios_base::failure);
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+
+        std::stringstream stream{};
+        BOOST_CHECK_THROW(
+            const tetengo::trie::aho_corasick deserialized(double_array_, stream), std::ios_base::failure);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(scan)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array double_array_{};
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        BOOST_TEST(std::empty(::scan(aho_corasick_, "ushers")));
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        {
+            const std::vector<match_type> expected{ { 1, 3, 1 }, { 2, 2, 0 }, { 2, 4, 3 } };
+            BOOST_TEST((::scan(aho_corasick_, "ushers") == expected));
+        }
+        {
+            const std::vector<match_type> expected{ { 0, 3, 2 }, { 3, 3, 1 }, { 4, 2, 0 } };
+            BOOST_TEST((::scan(aho_corasick_, "hisshe") == expected));
+        }
+        {
+            BOOST_TEST(std::empty(::scan(aho_corasick_, "")));
+            BOOST_TEST(std::empty(::scan(aho_corasick_, "Kumamoto")));
+        }
+        {
+            const std::string             text{ "sh\0he", 5 };
+            const std::vector<match_type> expected{ { 3, 2, 0 } };
+            BOOST_TEST((::scan(aho_corasick_, text) == expected));
+        }
+    }
+    {
+        const std::vector<std::pair<std::string, std::int32_t>> overlapping_elements{
+            { "", 0 }, { "a", 1 }, { "ab", 2 }, { "bab", 3 }, { "bc", 4 }, { "bca", 5 }, { "c", 6 }, { "caa", 7 }
+        };
+        const tetengo::trie::double_array double_array_{ overlapping_elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        const std::string text{ "abccabbabcaabcbabcaacab" };
+        BOOST_TEST((::scan(aho_corasick_, text) == scan_naively(double_array_, text)));
+    }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> numeric_elements{};
+        for (auto i = static_cast<std::size_t>(0); i < 300; ++i)
+        {
+            numeric_elements.emplace_back(std::to_string(i * 7919 % 1000), static_cast<std::int32_t>(i));
+        }
+        const tetengo::trie::double_array double_array_{ numeric_elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        std::string text{};
+        for (auto i = static_cast<std::size_t>(0); i < 200; ++i)
+        {
+            text += std::to_string(i * i * 31 % 9973);
+        }
+        BOOST_TEST((::scan(aho_corasick_, text) == scan_naively(double_array_, text)));
+
+        std::istringstream stream{ text };
+        BOOST_TEST((::scan(aho_corasick_, stream) == ::scan(aho_corasick_, text)));
+    }
+    {
+        const tetengo::trie::double_array double_array_{ elements };
+        const tetengo::trie::aho_corasick aho_corasick_{ double_array_ };
+
+        std::string text{};
+        while (std::size(text) < 200000)
+        {
+            text += "ushers hisshe ";
+        }
+        std::istringstream stream{ text };
+        const auto         matches = ::scan(aho_corasick_, stream);
+
+        BOOST_TEST((matches == ::scan(aho_corasick_, text)));
+        BOOST_TEST(std::size(matches) == std::size(text) / 14 * 6);
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
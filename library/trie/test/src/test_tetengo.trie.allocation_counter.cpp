@@ -0,0 +1,185 @@
+/*! \file
+    \brief An allocation counter.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#include "test_tetengo.trie.allocation_counter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+
+namespace
+{
+    std::atomic<bool> g_counting{ false };
+
+    std::atomic<std::size_t> g_allocation_count{ 0 };
+
+    std::atomic<std::size_t> g_deallocation_count{ 0 };
+
+    void count_allocation()
+    {
+        if (g_counting.load(std::memory_order_relaxed))
+        {
+            g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void count_deallocation()
+    {
+        if (g_counting.load(std::memory_order_relaxed))
+        {
+            g_deallocation_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void* allocate(const std::size_t size)
+    {
+        count_allocation();
+        if (auto* const p = std::malloc(size > 0 ? size : 1); p)
+        {
+            return p;
+        }
+        throw std::bad_alloc{};
+    }
+
+    void deallocate(void* const p) noexcept
+    {
+        if (!p)
+        {
+            return;
+        }
+        count_deallocation();
+        std::free(p);
+    }
+
+    void* allocate_aligned(const std::size_t size, const std::align_val_t alignment)
+    {
+        count_allocation();
+        const auto alignment_ = static_cast<std::size_t>(alignment);
+#if defined(_MSC_VER)
+        auto* const p = _aligned_malloc(size > 0 ? size : 1, alignment_);
+#else
+        auto* const p = std::aligned_alloc(alignment_, (size + alignment_) / alignment_ * alignment_);
+#endif
+        if (p)
+        {
+            return p;
+        }
+        throw std::bad_alloc{};
+    }
+
+    void deallocate_aligned(void* const p) noexcept
+    {
+        if (!p)
+        {
+            return;
+        }
+        count_deallocation();
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+
+}
+
+
+// The replaced operators allocate with std::malloc, so std::free is the matching deallocation.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(const std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](const std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* const p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void* const p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void* const p, const std::size_t /*size*/) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void* const p, const std::size_t /*size*/) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void* const p, const std::align_val_t /*alignment*/) noexcept
+{
+    deallocate_aligned(p);
+}
+
+void operator delete[](void* const p, const std::align_val_t /*alignment*/) noexcept
+{
+    deallocate_aligned(p);
+}
+
+void operator delete(void* const p, const std::size_t /*size*/, const std::align_val_t /*alignment*/) noexcept
+{
+    deallocate_aligned(p);
+}
+
+void operator delete[](void* const p, const std::size_t /*size*/, const std::align_val_t /*alignment*/) noexcept
+{
+    deallocate_aligned(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+
+namespace test_tetengo::trie
+{
+    void begin_allocation_counting()
+    {
+        g_allocation_count.store(0, std::memory_order_relaxed);
+        g_deallocation_count.store(0, std::memory_order_relaxed);
+        g_counting.store(true, std::memory_order_relaxed);
+    }
+
+    allocation_counts end_allocation_counting()
+    {
+        g_counting.store(false, std::memory_order_relaxed);
+        return { g_allocation_count.load(std::memory_order_relaxed),
+                 g_deallocation_count.load(std::memory_order_relaxed) };
+    }
+
+
+}
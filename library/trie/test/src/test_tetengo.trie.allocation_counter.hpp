@@ -0,0 +1,46 @@
+/*! \file
+    \brief An allocation counter.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#if !defined(TESTTETENGO_TRIE_ALLOCATIONCOUNTER_HPP)
+#define TESTTETENGO_TRIE_ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+
+
+namespace test_tetengo::trie
+{
+    /*!
+        \brief Allocation counts.
+    */
+    struct allocation_counts
+    {
+        //! The allocation count.
+        std::size_t allocations;
+
+        //! The deallocation count.
+        std::size_t deallocations;
+    };
+
+
+    /*!
+        \brief Begins counting the allocations by the global operator new.
+
+        The counts are shared by all the threads.
+    */
+    void begin_allocation_counting();
+
+    /*!
+        \brief Ends counting the allocations by the global operator new.
+
+        \return The counts since the last call to begin_allocation_counting().
+    */
+    allocation_counts end_allocation_counting();
+
+
+}
+
+
+#endif
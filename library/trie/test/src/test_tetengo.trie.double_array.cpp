@@ -4,23 +4,31 @@
     Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
 */
 
+#include <algorithm>
+#include <any>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <list>
+#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <boost/preprocessor.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <tetengo/trie/default_serializer.hpp>
 #include <tetengo/trie/double_array.hpp>
 #include <tetengo/trie/double_array_iterator.hpp>
 #include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/trie_set.hpp>
+
+#include "test_tetengo.trie.allocation_counter.hpp"
 
 
 namespace
@@ -160,6 +168,117 @@ namespace
         return array_;
     }
 
+    std::size_t edit_distance(const std::string_view& one, const std::string_view& another)
+    {
+        std::vector<std::size_t> row(std::size(another) + 1);
+        for (auto j = static_cast<std::size_t>(0); j < std::size(row); ++j)
+        {
+            row[j] = j;
+        }
+        for (auto i = static_cast<std::size_t>(0); i < std::size(one); ++i)
+        {
+            auto diagonal = row[0];
+            row[0] = i + 1;
+            for (auto j = static_cast<std::size_t>(1); j < std::size(row); ++j)
+            {
+                const auto above = row[j];
+                row[j] = std::min({ row[j] + 1, row[j - 1] + 1, diagonal + (one[i] == another[j - 1] ? 0 : 1) });
+                diagonal = above;
+            }
+        }
+        return row.back();
+    }
+
+    std::unique_ptr<tetengo::trie::storage> minimized_storage_of(const std::vector<std::string>& keys)
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{
+            std::begin(keys),
+            std::end(keys),
+            tetengo::trie::default_serializer<std::string>{ true },
+            tetengo::trie::trie_set<std::string>::null_building_observer_set(),
+            tetengo::trie::trie_set<std::string>::default_double_array_density_factor(),
+            tetengo::trie::trie_set<std::string>::default_double_array_build_thread_count(),
+            true
+        };
+        return trie_set_.get_storage().clone();
+    }
+
+    class view_hiding_storage : public tetengo::trie::storage
+    {
+    public:
+        // constructors
+
+        explicit view_hiding_storage(std::unique_ptr<tetengo::trie::storage>&& p_entity) :
+        m_p_entity{ std::move(p_entity) }
+        {}
+
+
+    private:
+        // variables
+
+        const std::unique_ptr<tetengo::trie::storage> m_p_entity;
+
+
+        // virtual functions
+
+        virtual std::size_t base_check_size_impl() const override
+        {
+            return m_p_entity->base_check_size();
+        }
+
+        virtual std::int32_t base_at_impl(const std::size_t base_check_index) const override
+        {
+            return m_p_entity->base_at(base_check_index);
+        }
+
+        virtual void set_base_at_impl(const std::size_t base_check_index, const std::int32_t base) override
+        {
+            m_p_entity->set_base_at(base_check_index, base);
+        }
+
+        virtual std::uint8_t check_at_impl(const std::size_t base_check_index) const override
+        {
+            return m_p_entity->check_at(base_check_index);
+        }
+
+        virtual void set_check_at_impl(const std::size_t base_check_index, const std::uint8_t check) override
+        {
+            m_p_entity->set_check_at(base_check_index, check);
+        }
+
+        virtual std::size_t value_count_impl() const override
+        {
+            return m_p_entity->value_count();
+        }
+
+        virtual const std::any* value_at_impl(const std::size_t value_index) const override
+        {
+            return m_p_entity->value_at(value_index);
+        }
+
+        virtual void add_value_at_impl(const std::size_t value_index, std::any value) override
+        {
+            m_p_entity->add_value_at(value_index, std::move(value));
+        }
+
+        virtual double filling_rate_impl() const override
+        {
+            return m_p_entity->filling_rate();
+        }
+
+        virtual void serialize_impl(
+            std::ostream&                          output_stream,
+            const tetengo::trie::value_serializer& value_serializer_) const override
+        {
+            m_p_entity->serialize(output_stream, value_serializer_);
+        }
+
+        virtual std::unique_ptr<storage> clone_impl() const override
+        {
+            return std::make_unique<view_hiding_storage>(m_p_entity->clone());
+        }
+    };
+
 }
 
 
@@ -182,6 +301,13 @@ BOOST_AUTO_TEST_CASE(default_density_factor)
     BOOST_TEST(tetengo::trie::double_array::default_density_factor() > 0U);
 }
 
+BOOST_AUTO_TEST_CASE(default_build_thread_count)
+{
+    BOOST_TEST_PASSPOINT();
+
+    BOOST_TEST(tetengo::trie::double_array::default_build_thread_count() > 0U);
+}
+
 BOOST_AUTO_TEST_CASE(key_terminator)
 {
     BOOST_TEST_PASSPOINT();
@@ -255,6 +381,265 @@ BOOST_AUTO_TEST_CASE(construction)
                 expected_values0, tetengo::trie::double_array::null_building_observer_set(), 0),
             std::invalid_argument);
     }
+    {
+        BOOST_CHECK_THROW(
+            const tetengo::trie::double_array double_array_(
+                expected_values0,
+                tetengo::trie::double_array::null_building_observer_set(),
+                tetengo::trie::double_array::default_density_factor(),
+                0),
+            std::invalid_argument);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(construction_parallel)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array double_array_{ std::vector<std::pair<std::string, std::int32_t>>{},
+                                                         tetengo::trie::double_array::null_building_observer_set(),
+                                                         tetengo::trie::double_array::default_density_factor(),
+                                                         4 };
+
+        BOOST_TEST(base_check_array_of(double_array_.get_storage()) == expected_empty_base_check_array_empty);
+    }
+    {
+        const tetengo::trie::double_array double_array_{ expected_values3,
+                                                         tetengo::trie::double_array::null_building_observer_set(),
+                                                         tetengo::trie::double_array::default_density_factor(),
+                                                         2 };
+
+        for (const auto& element: expected_values3)
+        {
+            const auto o_found = double_array_.find(element.first);
+            BOOST_REQUIRE(o_found);
+            BOOST_TEST(*o_found == element.second);
+        }
+        BOOST_CHECK(!double_array_.find("SUIZENJI"));
+        BOOST_CHECK(!double_array_.find("UT"));
+    }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        for (auto i = static_cast<std::size_t>(0); i < 2000; ++i)
+        {
+            elements.emplace_back(std::to_string(i * 7919 % 2000), static_cast<std::int32_t>(i));
+        }
+        elements.emplace_back("42", 4242);
+        elements.emplace_back("", 24);
+
+        auto       added_count = static_cast<std::size_t>(0);
+        auto       done = false;
+        const auto observer = tetengo::trie::double_array::building_observer_set_type{
+            [&added_count](const std::pair<std::string_view, std::int32_t>&) { ++added_count; },
+            [&done]() { done = true; }
+        };
+        const tetengo::trie::double_array double_array_{
+            elements, observer, tetengo::trie::double_array::default_density_factor(), 4
+        };
+        const tetengo::trie::double_array sequential_double_array{ elements };
+
+        BOOST_TEST(added_count == std::size(elements) - 1);
+        BOOST_TEST(done);
+        for (const auto& element: elements)
+        {
+            BOOST_CHECK(double_array_.find(element.first) == sequential_double_array.find(element.first));
+        }
+        BOOST_CHECK(!double_array_.find("2000"));
+        BOOST_CHECK(!double_array_.find("42 "));
+
+        std::vector<std::int32_t> values{ std::begin(double_array_), std::end(double_array_) };
+        std::vector<std::int32_t> sequential_values{ std::begin(sequential_double_array),
+                                                     std::end(sequential_double_array) };
+        BOOST_CHECK(values == sequential_values);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(construction_shared_elements)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        std::vector<std::string> keys{};
+        for (const auto* const stem: { "stalk", "talk", "walk", "work" })
+        {
+            keys.emplace_back(stem);
+            keys.push_back(std::string{ stem } + "ed");
+            keys.push_back(std::string{ stem } + "ing");
+            keys.push_back(std::string{ stem } + "s");
+        }
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        for (const auto& key: keys)
+        {
+            elements.emplace_back(key, 0);
+        }
+
+        const tetengo::trie::double_array double_array_{ minimized_storage_of(keys), 0 };
+        const tetengo::trie::double_array sequential_double_array{ elements };
+
+        BOOST_TEST(
+            double_array_.get_storage().base_check_size() < sequential_double_array.get_storage().base_check_size());
+        for (const auto& key: keys)
+        {
+            const auto o_found = double_array_.find(key);
+            BOOST_TEST_REQUIRE(o_found.has_value());
+            BOOST_TEST(*o_found == 0);
+        }
+        BOOST_CHECK(!double_array_.find("wal"));
+        BOOST_CHECK(!double_array_.find("walkings"));
+        BOOST_CHECK(!double_array_.find("stalkin"));
+
+        std::vector<std::int32_t> values{ std::begin(double_array_), std::end(double_array_) };
+        BOOST_TEST(std::size(values) == std::size(keys));
+
+        const auto found = double_array_.common_prefix_search("talking");
+        const std::vector<std::pair<std::size_t, std::int32_t>> expected{ { 4, 0 }, { 7, 0 } };
+        BOOST_CHECK(found == expected);
+
+        const auto p_subtrie = double_array_.subtrie("wo");
+        BOOST_REQUIRE(p_subtrie);
+        const auto o_found = p_subtrie->find("rked");
+        BOOST_TEST_REQUIRE(o_found.has_value());
+        BOOST_TEST(*o_found == 0);
+        BOOST_CHECK(!p_subtrie->find("lked"));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(construction_minimized)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array double_array_{ std::vector<std::pair<std::string, std::int32_t>>{},
+                                                         tetengo::trie::double_array::null_building_observer_set(),
+                                                         tetengo::trie::double_array::default_density_factor(),
+                                                         tetengo::trie::double_array::default_build_thread_count(),
+                                                         true };
+
+        BOOST_TEST(double_array_.get_storage().has_preceding_key_counts());
+        BOOST_CHECK(!double_array_.find("walk"));
+        BOOST_CHECK(std::begin(double_array_) == std::end(double_array_));
+    }
+    {
+        std::vector<std::string> keys{};
+        for (const auto* const stem: { "work", "walk", "talk", "stalk" })
+        {
+            keys.push_back(std::string{ stem } + "s");
+            keys.emplace_back(stem);
+            keys.push_back(std::string{ stem } + "ing");
+            keys.push_back(std::string{ stem } + "ed");
+        }
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        for (const auto& key: keys)
+        {
+            elements.emplace_back(key, 42);
+        }
+        elements.emplace_back("walk", 24);
+
+        const tetengo::trie::double_array double_array_{ elements,
+                                                         tetengo::trie::double_array::null_building_observer_set(),
+                                                         tetengo::trie::double_array::default_density_factor(),
+                                                         tetengo::trie::double_array::default_build_thread_count(),
+                                                         true };
+        const tetengo::trie::double_array sequential_double_array{ elements };
+
+        BOOST_TEST(
+            double_array_.get_storage().base_check_size() < sequential_double_array.get_storage().base_check_size());
+
+        auto sorted_keys = keys;
+        std::sort(std::begin(sorted_keys), std::end(sorted_keys));
+        const auto index_of = [&sorted_keys](const std::string_view& key) {
+            return static_cast<std::int32_t>(std::distance(
+                std::begin(sorted_keys), std::lower_bound(std::begin(sorted_keys), std::end(sorted_keys), key)));
+        };
+
+        for (auto i = static_cast<std::size_t>(0); i < std::size(sorted_keys); ++i)
+        {
+            const auto o_found = double_array_.find(sorted_keys[i]);
+            BOOST_TEST_REQUIRE(o_found.has_value());
+            BOOST_TEST(*o_found == static_cast<std::int32_t>(i));
+        }
+        BOOST_CHECK(!double_array_.find("wal"));
+        BOOST_CHECK(!double_array_.find("walkings"));
+        BOOST_CHECK(!double_array_.find("stalkin"));
+
+        {
+            std::vector<std::string_view> batch_keys{ std::begin(sorted_keys), std::end(sorted_keys) };
+            batch_keys.emplace_back("wal");
+            const auto found = double_array_.find_batch(batch_keys);
+            BOOST_TEST_REQUIRE(std::size(found) == std::size(batch_keys));
+            for (auto i = static_cast<std::size_t>(0); i < std::size(sorted_keys); ++i)
+            {
+                BOOST_TEST_REQUIRE(found[i].has_value());
+                BOOST_TEST(*found[i] == static_cast<std::int32_t>(i));
+            }
+            BOOST_CHECK(!found.back());
+        }
+        {
+            const std::vector<std::int32_t> values{ std::begin(double_array_), std::end(double_array_) };
+            BOOST_TEST_REQUIRE(std::size(values) == std::size(sorted_keys));
+            for (auto i = static_cast<std::size_t>(0); i < std::size(values); ++i)
+            {
+                BOOST_TEST(values[i] == static_cast<std::int32_t>(i));
+            }
+        }
+        {
+            const auto found = double_array_.common_prefix_search("talking");
+            const std::vector<std::pair<std::size_t, std::int32_t>> expected{ { 4, index_of("talk") },
+                                                                              { 7, index_of("talking") } };
+            BOOST_CHECK(found == expected);
+        }
+        {
+            const auto found = double_array_.fuzzy_search("walks", 1);
+            BOOST_TEST_REQUIRE(std::size(found) == 3U);
+            BOOST_TEST(found[0].key == "talks");
+            BOOST_TEST(found[0].value == index_of("talks"));
+            BOOST_TEST(found[1].key == "walk");
+            BOOST_TEST(found[1].value == index_of("walk"));
+            BOOST_TEST(found[2].key == "walks");
+            BOOST_TEST(found[2].value == index_of("walks"));
+        }
+        {
+            const auto p_subtrie = double_array_.subtrie("wo");
+            BOOST_REQUIRE(p_subtrie);
+            const auto o_found = p_subtrie->find("rked");
+            BOOST_TEST_REQUIRE(o_found.has_value());
+            BOOST_TEST(*o_found == index_of("worked"));
+            BOOST_CHECK(!p_subtrie->find("lked"));
+
+            const std::vector<std::int32_t> values{ std::begin(*p_subtrie), std::end(*p_subtrie) };
+            const std::vector<std::int32_t> expected{
+                index_of("work"), index_of("worked"), index_of("working"), index_of("works")
+            };
+            BOOST_CHECK(values == expected);
+
+            const tetengo::trie::double_array relocated{ p_subtrie->relocated_storage(), 0 };
+            const auto                        o_relocated_found = relocated.find("rks");
+            BOOST_TEST_REQUIRE(o_relocated_found.has_value());
+            BOOST_TEST(*o_relocated_found == index_of("works"));
+        }
+        {
+            const std::vector<std::string_view> sample_keys{ "walking", "talks" };
+            const tetengo::trie::double_array   relocated{ double_array_.relocated_storage(sample_keys), 0 };
+
+            BOOST_TEST(relocated.get_storage().has_preceding_key_counts());
+            for (const auto& key: sorted_keys)
+            {
+                BOOST_CHECK(relocated.find(key) == double_array_.find(key));
+            }
+            BOOST_CHECK(!relocated.find("wal"));
+        }
+        {
+            tetengo::trie::double_array restored{ double_array_.get_storage().clone(), 0 };
+
+            for (const auto& key: sorted_keys)
+            {
+                BOOST_CHECK(restored.find(key) == double_array_.find(key));
+            }
+            BOOST_CHECK_THROW(restored.insert("wake", 0), std::logic_error);
+            BOOST_CHECK_THROW(restored.erase("walk"), std::logic_error);
+        }
+    }
 }
 
 BOOST_AUTO_TEST_CASE(find)
@@ -292,6 +677,28 @@ BOOST_AUTO_TEST_CASE(find)
             BOOST_CHECK(!o_found);
         }
     }
+    {
+        const tetengo::trie::double_array original{ expected_values3 };
+        const tetengo::trie::double_array double_array_{
+            std::make_unique<view_hiding_storage>(original.get_storage().clone()), 0
+        };
+        BOOST_CHECK(!double_array_.get_storage().base_check_array_view());
+
+        {
+            const auto o_found = double_array_.find("UTIGOSI");
+            BOOST_REQUIRE(o_found);
+            BOOST_TEST(*o_found == 24);
+        }
+        {
+            const auto o_found = double_array_.find("UTO");
+            BOOST_REQUIRE(o_found);
+            BOOST_TEST(*o_found == 2424);
+        }
+        {
+            const auto o_found = double_array_.find("UT");
+            BOOST_CHECK(!o_found);
+        }
+    }
     {
         const tetengo::trie::double_array double_array_{ expected_values4 };
 
@@ -314,6 +721,223 @@ BOOST_AUTO_TEST_CASE(find)
     }
 }
 
+BOOST_AUTO_TEST_CASE(find_batch)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array double_array_{};
+
+        {
+            const auto found = double_array_.find_batch({});
+            BOOST_TEST(std::empty(found));
+        }
+        {
+            const auto found = double_array_.find_batch({ "SETA", "" });
+            BOOST_TEST_REQUIRE(std::size(found) == 2U);
+            BOOST_CHECK(!found[0]);
+            BOOST_CHECK(!found[1]);
+        }
+    }
+    {
+        const tetengo::trie::double_array double_array_{ expected_values3 };
+
+        const auto found = double_array_.find_batch({ "SETA", "SUIZENJI", "UTIGOSI", "UTO", "UT", "UTOU", "" });
+        BOOST_TEST_REQUIRE(std::size(found) == 7U);
+        BOOST_REQUIRE(found[0]);
+        BOOST_TEST(*found[0] == 42);
+        BOOST_CHECK(!found[1]);
+        BOOST_REQUIRE(found[2]);
+        BOOST_TEST(*found[2] == 24);
+        BOOST_REQUIRE(found[3]);
+        BOOST_TEST(*found[3] == 2424);
+        BOOST_CHECK(!found[4]);
+        BOOST_CHECK(!found[5]);
+        BOOST_CHECK(!found[6]);
+    }
+    {
+        const tetengo::trie::double_array original{ expected_values3 };
+        const tetengo::trie::double_array double_array_{
+            std::make_unique<view_hiding_storage>(original.get_storage().clone()), 0
+        };
+
+        const auto found = double_array_.find_batch({ "SETA", "SUIZENJI", "UTO", "" });
+        BOOST_TEST_REQUIRE(std::size(found) == 4U);
+        BOOST_REQUIRE(found[0]);
+        BOOST_TEST(*found[0] == 42);
+        BOOST_CHECK(!found[1]);
+        BOOST_REQUIRE(found[2]);
+        BOOST_TEST(*found[2] == 2424);
+        BOOST_CHECK(!found[3]);
+    }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        std::vector<std::string>                           keys{};
+        for (auto i = static_cast<std::size_t>(0); i < 100; ++i)
+        {
+            elements.emplace_back(std::to_string(i * 7), static_cast<std::int32_t>(i));
+            keys.push_back(std::to_string(i));
+        }
+        const tetengo::trie::double_array double_array_{ elements };
+
+        const auto found = double_array_.find_batch(std::vector<std::string_view>{ std::begin(keys), std::end(keys) });
+        BOOST_TEST_REQUIRE(std::size(found) == std::size(keys));
+        for (auto i = static_cast<std::size_t>(0); i < std::size(keys); ++i)
+        {
+            BOOST_CHECK(found[i] == double_array_.find(keys[i]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(common_prefix_search)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array double_array_{};
+
+        const auto found = double_array_.common_prefix_search("SETA");
+        BOOST_TEST(std::empty(found));
+    }
+    {
+        const tetengo::trie::double_array double_array_{ expected_values0 };
+
+        {
+            const auto found = double_array_.common_prefix_search("  ");
+            const std::vector<std::pair<std::size_t, std::int32_t>> expected{ { 0, 42 }, { 1, 24 } };
+            BOOST_CHECK(found == expected);
+        }
+        {
+            const auto found = double_array_.common_prefix_search("");
+            const std::vector<std::pair<std::size_t, std::int32_t>> expected{ { 0, 42 } };
+            BOOST_CHECK(found == expected);
+        }
+    }
+    {
+        const std::vector<std::pair<std::string, std::int32_t>> elements{
+            { "UTO", 2424 }, { "UTOU", 42 }, { "UTOUTO", 24 }, { "UTA", 4242 }
+        };
+        const tetengo::trie::double_array double_array_{ elements };
+
+        {
+            const auto found = double_array_.common_prefix_search("UTOUTOU");
+            const std::vector<std::pair<std::size_t, std::int32_t>> expected{ { 3, 2424 }, { 4, 42 }, { 6, 24 } };
+            BOOST_CHECK(found == expected);
+        }
+        {
+            const auto found = double_array_.common_prefix_search("UTOUT");
+            const std::vector<std::pair<std::size_t, std::int32_t>> expected{ { 3, 2424 }, { 4, 42 } };
+            BOOST_CHECK(found == expected);
+        }
+        {
+            const auto found = double_array_.common_prefix_search("UT");
+            BOOST_TEST(std::empty(found));
+        }
+        {
+            const auto found = double_array_.common_prefix_search("SETA");
+            BOOST_TEST(std::empty(found));
+        }
+
+        const tetengo::trie::double_array view_hidden{
+            std::make_unique<view_hiding_storage>(double_array_.get_storage().clone()), 0
+        };
+        {
+            const auto found = view_hidden.common_prefix_search("UTOUTOU");
+            const std::vector<std::pair<std::size_t, std::int32_t>> expected{ { 3, 2424 }, { 4, 42 }, { 6, 24 } };
+            BOOST_CHECK(found == expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fuzzy_search)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array double_array_{};
+
+        const auto found = double_array_.fuzzy_search("SETA", 2);
+        BOOST_TEST(std::empty(found));
+    }
+    {
+        const std::vector<std::pair<std::string, std::int32_t>> elements{
+            { "UTO", 2424 }, { "UTOU", 42 }, { "UTOUTO", 24 }, { "UTA", 4242 }, { "SETA", 4 }
+        };
+        const tetengo::trie::double_array double_array_{ elements };
+
+        {
+            const auto found = double_array_.fuzzy_search("UTO", 0);
+            BOOST_TEST_REQUIRE(std::size(found) == 1U);
+            BOOST_TEST(found[0].key == "UTO");
+            BOOST_TEST(found[0].distance == 0U);
+            BOOST_TEST(found[0].value == 2424);
+        }
+        {
+            const auto found = double_array_.fuzzy_search("UTO", 1);
+            BOOST_TEST_REQUIRE(std::size(found) == 3U);
+            BOOST_TEST(found[0].key == "UTA");
+            BOOST_TEST(found[0].distance == 1U);
+            BOOST_TEST(found[0].value == 4242);
+            BOOST_TEST(found[1].key == "UTO");
+            BOOST_TEST(found[1].distance == 0U);
+            BOOST_TEST(found[2].key == "UTOU");
+            BOOST_TEST(found[2].distance == 1U);
+            BOOST_TEST(found[2].value == 42);
+        }
+        {
+            const auto found = double_array_.fuzzy_search("SUTA", 2);
+            BOOST_TEST_REQUIRE(std::size(found) == 3U);
+            BOOST_TEST(found[0].key == "SETA");
+            BOOST_TEST(found[0].distance == 1U);
+            BOOST_TEST(found[1].key == "UTA");
+            BOOST_TEST(found[1].distance == 1U);
+            BOOST_TEST(found[2].key == "UTO");
+            BOOST_TEST(found[2].distance == 2U);
+        }
+        {
+            const auto found = double_array_.fuzzy_search("", 3);
+            BOOST_TEST_REQUIRE(std::size(found) == 2U);
+            BOOST_TEST(found[0].key == "UTA");
+            BOOST_TEST(found[1].key == "UTO");
+        }
+        {
+            const auto found = double_array_.fuzzy_search("KUMAMOTO", 3);
+            BOOST_TEST(std::empty(found));
+        }
+    }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        for (auto i = static_cast<std::size_t>(0); i < 1000; ++i)
+        {
+            elements.emplace_back(std::to_string(i * 7919 % 3000), static_cast<std::int32_t>(i));
+        }
+        const tetengo::trie::double_array double_array_{ elements };
+
+        for (const auto* const key: { "123", "2000", "99", "" })
+        {
+            const auto found = double_array_.fuzzy_search(key, 1);
+
+            std::map<std::string, std::size_t> expected{};
+            for (const auto& element: elements)
+            {
+                if (const auto distance = edit_distance(key, element.first); distance <= 1)
+                {
+                    expected.insert(std::make_pair(element.first, distance));
+                }
+            }
+            BOOST_TEST_REQUIRE(std::size(found) == std::size(expected));
+            auto expected_position = std::begin(expected);
+            for (const auto& e: found)
+            {
+                BOOST_TEST(e.key == expected_position->first);
+                BOOST_TEST(e.distance == expected_position->second);
+                BOOST_CHECK(double_array_.find(e.key) == std::make_optional(e.value));
+                ++expected_position;
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(begin_end)
 {
     BOOST_TEST_PASSPOINT();
@@ -390,6 +1014,20 @@ BOOST_AUTO_TEST_CASE(subtrie)
             BOOST_CHECK(!o_subtrie);
         }
     }
+    {
+        std::unique_ptr<tetengo::trie::double_array> p_subtrie{};
+        {
+            const tetengo::trie::double_array double_array_{ expected_values3 };
+
+            p_subtrie = double_array_.subtrie("UT");
+            BOOST_REQUIRE(p_subtrie);
+            BOOST_TEST(&p_subtrie->get_storage() == &double_array_.get_storage());
+        }
+
+        const auto o_found = p_subtrie->find("O");
+        BOOST_REQUIRE(o_found);
+        BOOST_TEST(*o_found == 2424);
+    }
     {
         const tetengo::trie::double_array double_array_{ expected_values4 };
 
@@ -401,6 +1039,290 @@ BOOST_AUTO_TEST_CASE(subtrie)
             BOOST_TEST(*o_found == 42);
         }
     }
+    {
+        tetengo::trie::double_array double_array_{ expected_values3 };
+
+        std::vector<std::unique_ptr<tetengo::trie::double_array>> p_subtries{};
+        for (auto i = static_cast<std::size_t>(0); i < 1000; ++i)
+        {
+            p_subtries.push_back(double_array_.subtrie("UT"));
+        }
+
+        auto found_count = static_cast<std::size_t>(0);
+        test_tetengo::trie::begin_allocation_counting();
+        for (auto i = static_cast<std::size_t>(0); i < 1000; ++i)
+        {
+            const auto p_subtrie = double_array_.subtrie("UT");
+            if (p_subtrie->find("O") == 2424)
+            {
+                ++found_count;
+            }
+        }
+        const auto allocation_counts = test_tetengo::trie::end_allocation_counting();
+        BOOST_TEST(found_count == 1000U);
+        BOOST_TEST(allocation_counts.allocations == allocation_counts.deallocations);
+
+        for (auto i = 0; i < 300; ++i)
+        {
+            double_array_.insert(std::string{ "UT" } + std::to_string(i), i);
+        }
+        BOOST_TEST(std::all_of(std::begin(p_subtries), std::end(p_subtries), [](const auto& p_subtrie) {
+            return p_subtrie->find("O") == 2424 && p_subtrie->find("299") == 299;
+        }));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(relocated_storage)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array double_array_{};
+
+        auto p_storage = double_array_.relocated_storage();
+        BOOST_TEST_REQUIRE(p_storage);
+        const tetengo::trie::double_array relocated{ std::move(p_storage), 0 };
+
+        BOOST_CHECK(std::begin(relocated) == std::end(relocated));
+    }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        for (auto i = static_cast<std::size_t>(0); i < 2000; ++i)
+        {
+            elements.emplace_back(std::to_string(i * 7919 % 2000), static_cast<std::int32_t>(i));
+        }
+        const tetengo::trie::double_array double_array_{ elements };
+
+        const std::vector<std::string_view> sample_keys{ "1999", "1998", "1999", "42", "Uto" };
+        const tetengo::trie::double_array   relocated{ double_array_.relocated_storage(sample_keys), 0 };
+
+        for (const auto& element: elements)
+        {
+            const auto o_found = relocated.find(element.first);
+            BOOST_TEST_REQUIRE(o_found.has_value());
+            BOOST_TEST(*o_found == element.second);
+        }
+        BOOST_CHECK(!relocated.find("2000"));
+
+        std::vector<std::int32_t> values{ std::begin(double_array_), std::end(double_array_) };
+        std::vector<std::int32_t> relocated_values{ std::begin(relocated), std::end(relocated) };
+        BOOST_CHECK(values == relocated_values);
+
+        const auto& storage = relocated.get_storage();
+        const auto  root_base = storage.base_at(0);
+        BOOST_TEST(
+            storage.base_at(static_cast<std::size_t>(root_base + '1')) <
+            storage.base_at(static_cast<std::size_t>(root_base + '0')));
+    }
+    {
+        std::vector<std::string> keys{};
+        for (auto i = static_cast<std::size_t>(0); i < 2000; ++i)
+        {
+            keys.push_back(std::to_string(i * 7919 % 2000) + "-" + std::to_string(i % 10));
+        }
+        const tetengo::trie::double_array double_array_{ minimized_storage_of(keys), 0 };
+
+        const tetengo::trie::double_array relocated{ double_array_.relocated_storage(), 0 };
+
+        BOOST_TEST(relocated.get_storage().base_check_size() <= double_array_.get_storage().base_check_size() + 256);
+        for (const auto& key: keys)
+        {
+            BOOST_CHECK(relocated.find(key) == double_array_.find(key));
+        }
+        BOOST_CHECK(!relocated.find("2000-0"));
+    }
+    {
+        const tetengo::trie::double_array double_array_{ expected_values3 };
+        const auto                        p_subtrie = double_array_.subtrie("UT");
+        BOOST_REQUIRE(p_subtrie);
+
+        const tetengo::trie::double_array relocated{ p_subtrie->relocated_storage(), 0 };
+
+        const auto o_found = relocated.find("O");
+        BOOST_REQUIRE(o_found);
+        BOOST_TEST(*o_found == 2424);
+        BOOST_CHECK(!relocated.find("UTO"));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(insert)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        tetengo::trie::double_array double_array_{};
+
+        BOOST_TEST(double_array_.insert("Kumamoto", 42));
+        BOOST_TEST(double_array_.insert("Tamana", 24));
+        BOOST_TEST(double_array_.insert("Tama", 4242));
+        BOOST_TEST(!double_array_.insert("Tamana", 2424));
+
+        BOOST_CHECK(double_array_.find("Kumamoto") == std::make_optional<std::int32_t>(42));
+        BOOST_CHECK(double_array_.find("Tamana") == std::make_optional<std::int32_t>(24));
+        BOOST_CHECK(double_array_.find("Tama") == std::make_optional<std::int32_t>(4242));
+        BOOST_CHECK(!double_array_.find("Tam"));
+
+        std::vector<std::int32_t> values{ std::begin(double_array_), std::end(double_array_) };
+        const std::vector<std::int32_t> expected{ 42, 4242, 24 };
+        BOOST_CHECK(values == expected);
+    }
+    {
+        tetengo::trie::double_array double_array_{ expected_values3 };
+
+        BOOST_TEST(double_array_.insert("UTA", 4224));
+        BOOST_TEST(double_array_.insert("", 2442));
+
+        for (const auto& element: expected_values3)
+        {
+            BOOST_CHECK(double_array_.find(element.first) == std::make_optional(element.second));
+        }
+        BOOST_CHECK(double_array_.find("UTA") == std::make_optional<std::int32_t>(4224));
+        BOOST_CHECK(double_array_.find("") == std::make_optional<std::int32_t>(2442));
+    }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        std::map<std::string, std::int32_t>               expected{};
+        for (auto i = static_cast<std::size_t>(0); i < 1000; ++i)
+        {
+            elements.emplace_back(std::to_string(i * 7919 % 2000), static_cast<std::int32_t>(i));
+            expected.insert(elements.back());
+        }
+        tetengo::trie::double_array double_array_{ elements };
+
+        for (auto i = static_cast<std::size_t>(0); i < 3000; ++i)
+        {
+            const auto key = std::to_string(i * 104729 % 5000) + (i % 3 == 0 ? "x" : "");
+            const auto value = static_cast<std::int32_t>(10000 + i);
+            BOOST_TEST(double_array_.insert(key, value) == expected.insert(std::make_pair(key, value)).second);
+        }
+
+        for (const auto& element: expected)
+        {
+            BOOST_CHECK(double_array_.find(element.first) == std::make_optional(element.second));
+        }
+        std::vector<std::int32_t> values{ std::begin(double_array_), std::end(double_array_) };
+        std::vector<std::int32_t> expected_values{};
+        for (const auto& element: expected)
+        {
+            expected_values.push_back(element.second);
+        }
+        BOOST_CHECK(values == expected_values);
+    }
+    {
+        tetengo::trie::double_array double_array_{ minimized_storage_of({ "stalk", "talk" }), 0 };
+
+        BOOST_CHECK_THROW(double_array_.insert("walk", 0), std::logic_error);
+    }
+    {
+        const std::vector<std::pair<std::string, std::int32_t>> elements{ { "ab", 1 }, { "ac", 2 } };
+        tetengo::trie::double_array                             double_array_{ elements };
+        const auto                                              p_subtrie = double_array_.subtrie("a");
+        BOOST_REQUIRE(p_subtrie);
+
+        for (auto char_code = static_cast<std::int32_t>(1); char_code < 0xFF; ++char_code)
+        {
+            if (char_code != 'a')
+            {
+                BOOST_TEST(double_array_.insert(std::string{ static_cast<char>(char_code), 'x' }, char_code));
+            }
+        }
+        BOOST_CHECK(p_subtrie->find("b") == std::make_optional<std::int32_t>(1));
+        BOOST_CHECK(p_subtrie->find("c") == std::make_optional<std::int32_t>(2));
+
+        BOOST_TEST(p_subtrie->insert("d", 3));
+        BOOST_CHECK(double_array_.find("ad") == std::make_optional<std::int32_t>(3));
+        BOOST_TEST(double_array_.insert("ae", 4));
+        BOOST_CHECK(p_subtrie->find("e") == std::make_optional<std::int32_t>(4));
+        BOOST_CHECK(double_array_.find("zx") == std::make_optional<std::int32_t>('z'));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(erase)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        tetengo::trie::double_array double_array_{};
+
+        BOOST_TEST(!double_array_.erase("Kumamoto"));
+    }
+    {
+        tetengo::trie::double_array double_array_{ expected_values3 };
+
+        BOOST_TEST(double_array_.erase("UTO"));
+        BOOST_TEST(!double_array_.erase("UTO"));
+        BOOST_TEST(!double_array_.erase("UT"));
+
+        BOOST_CHECK(!double_array_.find("UTO"));
+        BOOST_CHECK(double_array_.find("SETA") == std::make_optional<std::int32_t>(42));
+        BOOST_CHECK(double_array_.find("UTIGOSI") == std::make_optional<std::int32_t>(24));
+
+        BOOST_TEST(double_array_.insert("UTO", 4242));
+        BOOST_CHECK(double_array_.find("UTO") == std::make_optional<std::int32_t>(4242));
+    }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        std::map<std::string, std::int32_t>               expected{};
+        for (auto i = static_cast<std::size_t>(0); i < 2000; ++i)
+        {
+            elements.emplace_back(std::to_string(i * 7919 % 2000), static_cast<std::int32_t>(i));
+            expected.insert(elements.back());
+        }
+        tetengo::trie::double_array double_array_{ elements };
+
+        for (auto i = static_cast<std::size_t>(0); i < 2000; i += 3)
+        {
+            const auto key = std::to_string(i);
+            BOOST_TEST(double_array_.erase(key));
+            expected.erase(key);
+        }
+        for (auto i = static_cast<std::size_t>(0); i < 2000; i += 7)
+        {
+            const auto key = std::to_string(i) + "y";
+            BOOST_TEST(double_array_.insert(key, static_cast<std::int32_t>(i)));
+            expected.emplace(key, static_cast<std::int32_t>(i));
+        }
+
+        for (auto i = static_cast<std::size_t>(0); i < 2000; ++i)
+        {
+            const auto key = std::to_string(i);
+            const auto found = expected.find(key);
+            BOOST_CHECK(
+                double_array_.find(key) ==
+                (found == std::end(expected) ? std::nullopt : std::make_optional(found->second)));
+        }
+        std::vector<std::int32_t> values{ std::begin(double_array_), std::end(double_array_) };
+        std::vector<std::int32_t> expected_values{};
+        for (const auto& element: expected)
+        {
+            expected_values.push_back(element.second);
+        }
+        BOOST_CHECK(values == expected_values);
+
+        for (const auto& element: expected)
+        {
+            BOOST_TEST(double_array_.erase(element.first));
+        }
+        BOOST_CHECK(std::begin(double_array_) == std::end(double_array_));
+        BOOST_TEST(double_array_.insert("Kumamoto", 42));
+        BOOST_CHECK(double_array_.find("Kumamoto") == std::make_optional<std::int32_t>(42));
+    }
+    {
+        const std::vector<std::pair<std::string, std::int32_t>> elements{ { "ab", 1 }, { "ac", 2 }, { "b", 3 } };
+        tetengo::trie::double_array                             double_array_{ elements };
+        const auto                                              p_subtrie = double_array_.subtrie("a");
+        BOOST_REQUIRE(p_subtrie);
+
+        BOOST_TEST(double_array_.erase("ab"));
+        BOOST_CHECK(p_subtrie->find("c") == std::make_optional<std::int32_t>(2));
+        BOOST_TEST(double_array_.erase("ac"));
+        BOOST_CHECK_THROW([[maybe_unused]] const auto o_found = p_subtrie->find("c"), std::logic_error);
+        BOOST_CHECK_THROW(p_subtrie->insert("d", 4), std::logic_error);
+
+        BOOST_TEST(double_array_.insert("ad", 4));
+        BOOST_CHECK(p_subtrie->find("d") == std::make_optional<std::int32_t>(4));
+        BOOST_CHECK(double_array_.find("b") == std::make_optional<std::int32_t>(3));
+    }
 }
 
 BOOST_AUTO_TEST_CASE(storage)
@@ -4,6 +4,8 @@
     Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
 */
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <stdexcept>
@@ -35,6 +37,16 @@ namespace
         { { 0xE8_c, 0xB5_c, 0xA4_c, 0xE6_c, 0xB0_c, 0xB4_c }, 42 }, // "Akamizu" in Kanji
     };
 
+    std::vector<std::pair<std::string, std::int32_t>> iterated(const tetengo::trie::double_array& double_array_)
+    {
+        std::vector<std::pair<std::string, std::int32_t>> elements{};
+        for (auto i = std::begin(double_array_); i != std::end(double_array_); ++i)
+        {
+            elements.emplace_back(i.key(), *i);
+        }
+        return elements;
+    }
+
 }
 
 
@@ -104,6 +116,49 @@ BOOST_AUTO_TEST_CASE(operator_dereference)
     }
 }
 
+BOOST_AUTO_TEST_CASE(key)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::double_array_iterator iterator{};
+
+        BOOST_CHECK_THROW([[maybe_unused]] const auto key = iterator.key(), std::logic_error);
+    }
+    {
+        const tetengo::trie::double_array double_array_{ expected_base_values };
+        auto                              iterator = std::begin(double_array_);
+
+        BOOST_TEST(iterator.key() == "SETA");
+        ++iterator;
+        BOOST_TEST(iterator.key() == "UTIGOSI");
+        ++iterator;
+        BOOST_TEST(iterator.key() == "UTO");
+        BOOST_TEST(std::data(iterator.key())[3] == '\0');
+        ++iterator;
+        BOOST_CHECK_THROW([[maybe_unused]] const auto key = iterator.key(), std::logic_error);
+    }
+    {
+        const tetengo::trie::double_array double_array_{ expected_base_values };
+        const auto                        o_subtrie = double_array_.subtrie("UT");
+        BOOST_REQUIRE(o_subtrie);
+        auto iterator = std::begin(*o_subtrie);
+
+        BOOST_TEST(iterator.key() == "IGOSI");
+        ++iterator;
+        BOOST_TEST(iterator.key() == "O");
+    }
+    {
+        const tetengo::trie::double_array double_array_{ expected_base_values };
+        const auto                        o_subtrie = double_array_.subtrie("UTO");
+        BOOST_REQUIRE(o_subtrie);
+        const auto iterator = std::begin(*o_subtrie);
+
+        BOOST_TEST(*iterator == 2424);
+        BOOST_TEST(std::empty(iterator.key()));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(operator_equal)
 {
     BOOST_TEST_PASSPOINT();
@@ -181,6 +236,7 @@ BOOST_AUTO_TEST_CASE(operator_increment)
             const std::string expected_key{ 0xE8_c, 0xB5_c, 0xA4_c, 0xE6_c, 0xB0_c, 0xB4_c }; // "Akamizu" in Kanji
             BOOST_REQUIRE(iterator != std::end(double_array_));
             BOOST_TEST(*iterator == 42);
+            BOOST_TEST(iterator.key() == expected_key);
         }
         {
             ++iterator;
@@ -188,6 +244,7 @@ BOOST_AUTO_TEST_CASE(operator_increment)
             const std::string expected_key{ 0xE8_c, 0xB5_c, 0xA4_c, 0xE7_c, 0x80_c, 0xAC_c }; // "Akase" in Kanji
             BOOST_REQUIRE(iterator != std::end(double_array_));
             BOOST_TEST(*iterator == 24);
+            BOOST_TEST(iterator.key() == expected_key);
         }
         {
             iterator++;
@@ -195,6 +252,49 @@ BOOST_AUTO_TEST_CASE(operator_increment)
             BOOST_CHECK(iterator == std::end(double_array_));
         }
     }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> sparse_elements{};
+        for (auto i = static_cast<std::size_t>(1); i <= 64; i *= 2)
+        {
+            sparse_elements.emplace_back(std::string(i, 'a') + "z", static_cast<std::int32_t>(i));
+        }
+        std::sort(std::begin(sparse_elements), std::end(sparse_elements));
+        const tetengo::trie::double_array double_array_{ sparse_elements };
+
+        BOOST_TEST((iterated(double_array_) == sparse_elements));
+    }
+    {
+        std::vector<std::pair<std::string, std::int32_t>> dense_elements{};
+        for (auto i = 1; i < 0xFF; ++i)
+        {
+            dense_elements.emplace_back(std::string(1, static_cast<char>(i)), i);
+            for (auto j = 1; j < 0xFF; j += 3)
+            {
+                dense_elements.emplace_back(std::string{ static_cast<char>(i), static_cast<char>(j) }, i * 0x100 + j);
+            }
+        }
+        std::sort(std::begin(dense_elements), std::end(dense_elements));
+        const tetengo::trie::double_array double_array_{ dense_elements };
+
+        const auto iterated_elements = iterated(double_array_);
+        BOOST_TEST_REQUIRE(std::size(iterated_elements) == std::size(dense_elements));
+        BOOST_CHECK(iterated_elements == dense_elements);
+
+        const auto p_subtrie = double_array_.subtrie(std::string(1, static_cast<char>(0xFE)));
+        BOOST_REQUIRE(p_subtrie);
+        BOOST_TEST(std::size(iterated(*p_subtrie)) == 1U + (0xFF - 1 + 2) / 3);
+    }
+    {
+        tetengo::trie::double_array double_array_{ expected_base_values };
+        BOOST_TEST(std::size(iterated(double_array_)) == 3U);
+
+        double_array_.insert("SAKURA", 4242);
+
+        const std::vector<std::pair<std::string, std::int32_t>> expected{
+            { "SAKURA", 4242 }, { "SETA", 42 }, { "UTIGOSI", 24 }, { "UTO", 2424 }
+        };
+        BOOST_TEST((iterated(double_array_) == expected));
+    }
 }
 
 
@@ -15,6 +15,7 @@
 #include <iterator>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -62,6 +63,31 @@ namespace
         return std::make_unique<std::stringstream>(std::string{ std::begin(serialized), std::end(serialized) });
     }
 
+    const std::vector<char> serialized_indexed{
+        // clang-format off
+        0x00_c, 0x00_c, 0x00_c, 0x02_c,
+        0x00_c, 0x00_c, 0x2A_c, 0xFF_c,
+        0x00_c, 0x00_c, 0xFE_c, 0x18_c,
+        0x00_c, 0x00_c, 0x00_c, 0x05_c,
+        0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+        0x00_c, 0x00_c, 0x00_c, 0x00_c,
+        0x00_c, 0x00_c, 0x00_c, 0x00_c,
+        0x00_c, 0x00_c, 0x00_c, 0x04_c,
+        0x00_c, 0x00_c, 0x00_c, 0x08_c,
+        0x00_c, 0x00_c, 0x00_c, 0x08_c,
+        0x00_c, 0x00_c, 0x00_c, 0x0C_c,
+        0x70_c, 0x69_c, 0x79_c, 0x6F_c,
+        0x66_c, 0x75_c, 0x67_c, 0x61_c,
+        0x68_c, 0x6F_c, 0x67_c, 0x65_c,
+        // clang-format on
+    };
+
+    std::unique_ptr<std::istream> create_input_stream_indexed()
+    {
+        return std::make_unique<std::stringstream>(
+            std::string{ std::begin(serialized_indexed), std::end(serialized_indexed) });
+    }
+
     const std::vector<char> serialized_fixed_value_size{
         // clang-format off
         0x00_c, 0x00_c, 0x00_c, 0x02_c,
@@ -192,6 +218,25 @@ BOOST_AUTO_TEST_CASE(construction)
         BOOST_REQUIRE(storage_.value_at(1));
         BOOST_TEST(std::any_cast<std::string>(*storage_.value_at(1)) == "piyo");
     }
+    {
+        const auto                              p_input_stream = create_input_stream_indexed();
+        const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::string> string_deserializer{ false };
+            return string_deserializer(std::string{ std::begin(serialized), std::end(serialized) });
+        } };
+        const tetengo::trie::memory_storage storage_{ *p_input_stream, deserializer };
+
+        BOOST_TEST(base_check_array_of(storage_) == base_check_array);
+        BOOST_TEST(storage_.value_count() == 5U);
+        BOOST_TEST(!storage_.value_at(0));
+        BOOST_REQUIRE(storage_.value_at(1));
+        BOOST_TEST(std::any_cast<std::string>(*storage_.value_at(1)) == "piyo");
+        BOOST_REQUIRE(storage_.value_at(2));
+        BOOST_TEST(std::any_cast<std::string>(*storage_.value_at(2)) == "fuga");
+        BOOST_TEST(!storage_.value_at(3));
+        BOOST_REQUIRE(storage_.value_at(4));
+        BOOST_TEST(std::any_cast<std::string>(*storage_.value_at(4)) == "hoge");
+    }
     {
         const auto                              p_input_stream = create_input_stream_fixed_value_size();
         const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
@@ -286,6 +331,50 @@ BOOST_AUTO_TEST_CASE(construction)
     {
         BOOST_TEST(!tetengo_trie_storage_createMemoryStorage(nullptr));
     }
+    {
+        static constexpr std::size_t size = 0x10000 * 2 + 3;
+
+        tetengo::trie::memory_storage storage_{};
+        for (auto i = static_cast<std::size_t>(0); i < size; ++i)
+        {
+            storage_.set_base_at(i, static_cast<std::int32_t>(i) - 0x10000);
+            storage_.set_check_at(i, static_cast<std::uint8_t>(i & 0xFF));
+            if (i % 3 != 0)
+            {
+                storage_.add_value_at(i, std::make_any<std::uint32_t>(static_cast<std::uint32_t>(i)));
+            }
+        }
+
+        const tetengo::trie::value_serializer serializer{
+            [](const std::any& object) {
+                static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer{ false };
+                return uint32_serializer(std::any_cast<std::uint32_t>(object));
+            },
+            sizeof(std::uint32_t)
+        };
+        const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        std::stringstream stream{};
+        storage_.serialize(stream, serializer);
+        const tetengo::trie::memory_storage deserialized{ stream, deserializer };
+
+        BOOST_TEST(base_check_array_of(deserialized) == base_check_array_of(storage_));
+        BOOST_TEST(deserialized.value_count() == size);
+        for (auto i = static_cast<std::size_t>(0); i < size; ++i)
+        {
+            if (i % 3 != 0)
+            {
+                BOOST_TEST_REQUIRE(deserialized.value_at(i));
+                BOOST_TEST(std::any_cast<std::uint32_t>(*deserialized.value_at(i)) == i);
+            }
+            else
+            {
+                BOOST_TEST(!deserialized.value_at(i));
+            }
+        }
+    }
 }
 
 BOOST_AUTO_TEST_CASE(base_check_size)
@@ -385,6 +474,27 @@ BOOST_AUTO_TEST_CASE(set_base_at)
 
         BOOST_TEST(storage_.base_at(42) == 4242);
     }
+    {
+        tetengo::trie::memory_storage storage_{};
+
+        storage_.set_base_at(0, 42);
+        storage_.set_check_at(0, 24);
+        storage_.set_base_at(1, 0x12345678);
+        storage_.set_base_at(2, -0x12345678);
+
+        BOOST_TEST(storage_.base_check_size() == 3U);
+        BOOST_TEST(storage_.base_at(0) == 42);
+        BOOST_TEST(storage_.check_at(0) == 24);
+        BOOST_TEST(storage_.base_at(1) == 0x12345678);
+        BOOST_TEST(storage_.check_at(1) == tetengo::trie::double_array::vacant_check_value());
+        BOOST_TEST(storage_.base_at(2) == -0x12345678);
+
+        storage_.set_base_at(3, 4242);
+        storage_.set_check_at(3, 42);
+
+        BOOST_TEST(storage_.base_at(3) == 4242);
+        BOOST_TEST(storage_.check_at(3) == 42);
+    }
 
     {
         const auto file_path = temporary_file_path(serialized_c_if);
@@ -494,6 +604,65 @@ BOOST_AUTO_TEST_CASE(set_check_at)
     }
 }
 
+BOOST_AUTO_TEST_CASE(base_check_array_view)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        tetengo::trie::memory_storage storage_{};
+        storage_.set_base_at(1, 42);
+        storage_.set_check_at(1, 24);
+
+        const auto o_view = storage_.base_check_array_view();
+        BOOST_REQUIRE(o_view);
+        BOOST_CHECK(o_view->layout == tetengo::trie::storage::base_check_array_view_type::layout_type::narrow);
+        BOOST_TEST_REQUIRE(o_view->size == 2U);
+        const auto* const p_head = static_cast<const std::uint32_t*>(o_view->p_head);
+        BOOST_TEST(p_head[0] == 0x000000FFU);
+        BOOST_TEST(p_head[1] == 0x00002A18U);
+    }
+    {
+        tetengo::trie::memory_storage storage_{};
+        storage_.set_base_at(1, 0x01000000);
+        storage_.set_check_at(1, 24);
+
+        const auto o_view = storage_.base_check_array_view();
+        BOOST_REQUIRE(o_view);
+        BOOST_CHECK(o_view->layout == tetengo::trie::storage::base_check_array_view_type::layout_type::wide);
+        BOOST_TEST_REQUIRE(o_view->size == 2U);
+        const auto* const p_head = static_cast<const std::uint64_t*>(o_view->p_head);
+        BOOST_TEST(p_head[0] == 0x00000000000000FFU);
+        BOOST_TEST(p_head[1] == 0x0000000100000018U);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(preceding_key_count_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::memory_storage storage_{};
+
+        BOOST_TEST(!storage_.has_preceding_key_counts());
+        BOOST_TEST(storage_.preceding_key_count_at(0) == 0U);
+        BOOST_TEST(storage_.preceding_key_count_at(42) == 0U);
+    }
+    {
+        tetengo::trie::memory_storage storage_{};
+
+        storage_.set_preceding_key_count_at(2, 42);
+
+        BOOST_TEST(storage_.has_preceding_key_counts());
+        BOOST_TEST(storage_.preceding_key_count_at(0) == 0U);
+        BOOST_TEST(storage_.preceding_key_count_at(2) == 42U);
+        BOOST_TEST(storage_.preceding_key_count_at(3) == 0U);
+
+        const auto p_clone = storage_.clone();
+        BOOST_TEST(p_clone->has_preceding_key_counts());
+        BOOST_TEST(p_clone->preceding_key_count_at(2) == 42U);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(value_count)
 {
     BOOST_TEST_PASSPOINT();
@@ -721,6 +890,55 @@ BOOST_AUTO_TEST_CASE(add_value_at)
     }
 }
 
+BOOST_AUTO_TEST_CASE(erase_value_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        tetengo::trie::memory_storage storage_{};
+
+        storage_.add_value_at(2, std::make_any<std::uint32_t>(2));
+        BOOST_TEST(storage_.vacant_value_count() == 2U);
+
+        storage_.add_value_at(0, std::make_any<std::uint32_t>(0));
+        storage_.add_value_at(1, std::make_any<std::uint32_t>(1));
+        BOOST_TEST(storage_.vacant_value_count() == 0U);
+        BOOST_CHECK(!storage_.vacant_value_index());
+
+        storage_.erase_value_at(1);
+        storage_.erase_value_at(1);
+        storage_.erase_value_at(42);
+
+        BOOST_TEST(storage_.value_count() == 3U);
+        BOOST_TEST(!storage_.value_at(1));
+        BOOST_TEST(storage_.vacant_value_count() == 1U);
+        BOOST_CHECK(storage_.vacant_value_index() == 1U);
+
+        const tetengo::trie::value_serializer serializer{
+            [](const std::any& object) {
+                static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer{ false };
+                return uint32_serializer(std::any_cast<std::uint32_t>(object));
+            },
+            sizeof(std::uint32_t)
+        };
+        const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        std::stringstream stream{};
+        storage_.serialize(stream, serializer);
+        tetengo::trie::memory_storage deserialized{ stream, deserializer };
+
+        BOOST_TEST(deserialized.vacant_value_count() == 1U);
+        BOOST_CHECK(deserialized.vacant_value_index() == 1U);
+
+        deserialized.add_value_at(1, std::make_any<std::uint32_t>(42));
+        BOOST_TEST(deserialized.vacant_value_count() == 0U);
+        BOOST_REQUIRE(deserialized.value_at(1));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*deserialized.value_at(1)) == 42U);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(filling_rate)
 {
     BOOST_TEST_PASSPOINT();
@@ -830,6 +1048,36 @@ BOOST_AUTO_TEST_CASE(serialize)
         storage_.set_base_at(1, 0xFE);
         storage_.set_check_at(1, 24);
 
+        storage_.add_value_at(4, std::make_any<std::string>("hoge"));
+        storage_.add_value_at(2, std::make_any<std::string>("fuga"));
+        storage_.add_value_at(1, std::make_any<std::string>("piyo"));
+
+        std::ostringstream                    output_stream{};
+        const tetengo::trie::value_serializer serializer{
+            [](const std::any& object) {
+                static const tetengo::trie::default_serializer<std::string> string_serializer{ false };
+                const auto serialized = string_serializer(std::any_cast<std::string>(object));
+                return std::vector<char>{ std::begin(serialized), std::end(serialized) };
+            },
+            0,
+            true
+        };
+        storage_.serialize(output_stream, serializer);
+
+        const std::string serialized = output_stream.str();
+        BOOST_CHECK_EQUAL_COLLECTIONS(
+            std::begin(serialized),
+            std::end(serialized),
+            std::begin(serialized_indexed),
+            std::end(serialized_indexed));
+    }
+    {
+        tetengo::trie::memory_storage storage_{};
+
+        storage_.set_base_at(0, 42);
+        storage_.set_base_at(1, 0xFE);
+        storage_.set_check_at(1, 24);
+
         storage_.add_value_at(4, std::make_any<std::uint32_t>(3));
         storage_.add_value_at(2, std::make_any<std::uint32_t>(14));
         storage_.add_value_at(1, std::make_any<std::uint32_t>(159));
@@ -863,6 +1111,57 @@ BOOST_AUTO_TEST_CASE(serialize)
         BOOST_CHECK_EQUAL_COLLECTIONS(
             std::begin(serialized), std::end(serialized), std::begin(expected), std::end(expected));
     }
+    {
+        tetengo::trie::memory_storage storage_{};
+
+        storage_.set_base_at(0, 42);
+        storage_.set_base_at(1, 0x01000000);
+        storage_.set_check_at(1, 24);
+
+        storage_.add_value_at(1, std::make_any<std::uint32_t>(159));
+
+        std::stringstream                     output_stream{};
+        const tetengo::trie::value_serializer serializer{
+            [](const std::any& object) {
+                static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer{ false };
+                const auto serialized = uint32_serializer(std::any_cast<std::uint32_t>(object));
+                return std::vector<char>{ std::begin(serialized), std::end(serialized) };
+            },
+            sizeof(std::uint32_t)
+        };
+        storage_.serialize(output_stream, serializer);
+
+        static const std::string expected{
+            // clang-format off
+            0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+            0x00_c, 0x00_c, 0x00_c, 0x02_c,
+            0x00_c, 0x00_c, 0x00_c, 0x00_c, 0x00_c, 0x00_c, 0x2A_c, 0xFF_c,
+            0x00_c, 0x00_c, 0x00_c, 0x01_c, 0x00_c, 0x00_c, 0x00_c, 0x18_c,
+            0x00_c, 0x00_c, 0x00_c, 0x02_c,
+            0x00_c, 0x00_c, 0x00_c, 0x04_c,
+            0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+            0x00_c, 0x00_c, 0x00_c, 0x9F_c,
+            // clang-format on
+        };
+        const std::string serialized = output_stream.str();
+        BOOST_CHECK_EQUAL_COLLECTIONS(
+            std::begin(serialized), std::end(serialized), std::begin(expected), std::end(expected));
+
+        const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::memory_storage deserialized{ output_stream, deserializer };
+
+        BOOST_TEST(deserialized.base_check_size() == 2U);
+        BOOST_TEST(deserialized.base_at(0) == 42);
+        BOOST_TEST(deserialized.check_at(0) == tetengo::trie::double_array::vacant_check_value());
+        BOOST_TEST(deserialized.base_at(1) == 0x01000000);
+        BOOST_TEST(deserialized.check_at(1) == 24);
+        BOOST_TEST(!deserialized.value_at(0));
+        BOOST_REQUIRE(deserialized.value_at(1));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*deserialized.value_at(1)) == 159U);
+    }
 
     {
         constexpr auto                          kumamoto_value = static_cast<int>(42);
@@ -971,6 +1270,151 @@ BOOST_AUTO_TEST_CASE(serialize)
     }
 }
 
+BOOST_AUTO_TEST_CASE(serialize_v2)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const tetengo::trie::value_serializer string_serializer{
+        [](const std::any& object) {
+            static const tetengo::trie::default_serializer<std::string> string_serializer_{ false };
+            const auto serialized = string_serializer_(std::any_cast<std::string>(object));
+            return std::vector<char>{ std::begin(serialized), std::end(serialized) };
+        },
+        0
+    };
+    const tetengo::trie::value_deserializer string_deserializer{ [](const std::vector<char>& serialized) {
+        static const tetengo::trie::default_deserializer<std::string> string_deserializer_{ false };
+        return string_deserializer_(std::string{ std::begin(serialized), std::end(serialized) });
+    } };
+
+    {
+        tetengo::trie::memory_storage storage_{};
+
+        storage_.set_base_at(0, 42);
+        storage_.set_base_at(1, 0xFE);
+        storage_.set_check_at(1, 24);
+
+        storage_.add_value_at(4, std::make_any<std::string>("hoge"));
+        storage_.add_value_at(2, std::make_any<std::string>("fuga"));
+        storage_.add_value_at(1, std::make_any<std::string>("piyo"));
+
+        std::stringstream stream{};
+        storage_.serialize_v2(stream, string_serializer);
+
+        const auto serialized = stream.str();
+        BOOST_TEST(std::size(serialized) == 0x2000U + 16U + 8U * 6U + 12U);
+        BOOST_TEST(serialized[8] == 0x02);
+        BOOST_TEST(serialized[12] == 0x00);
+
+        const tetengo::trie::memory_storage deserialized{ stream, string_deserializer };
+
+        BOOST_TEST(base_check_array_of(deserialized) == base_check_array_of(storage_));
+        BOOST_TEST(deserialized.value_count() == 5U);
+        BOOST_TEST(!deserialized.value_at(0));
+        BOOST_TEST_REQUIRE(deserialized.value_at(1));
+        BOOST_TEST(std::any_cast<std::string>(*deserialized.value_at(1)) == "piyo");
+        BOOST_TEST_REQUIRE(deserialized.value_at(2));
+        BOOST_TEST(std::any_cast<std::string>(*deserialized.value_at(2)) == "fuga");
+        BOOST_TEST(!deserialized.value_at(3));
+        BOOST_TEST_REQUIRE(deserialized.value_at(4));
+        BOOST_TEST(std::any_cast<std::string>(*deserialized.value_at(4)) == "hoge");
+    }
+    {
+        tetengo::trie::memory_storage storage_{};
+
+        storage_.set_base_at(0, 42);
+        storage_.set_base_at(1, 0x7FFFFFFF);
+        storage_.set_check_at(1, 24);
+        storage_.set_base_at(2, -0x7FFFFFFF);
+
+        storage_.add_value_at(2, std::make_any<std::uint32_t>(0x12345678));
+
+        std::stringstream                     stream{};
+        const tetengo::trie::value_serializer uint32_serializer{
+            [](const std::any& object) {
+                static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer_{ false };
+                return uint32_serializer_(std::any_cast<std::uint32_t>(object));
+            },
+            sizeof(std::uint32_t)
+        };
+        storage_.serialize_v2(stream, uint32_serializer);
+
+        const auto serialized = stream.str();
+        BOOST_TEST(std::size(serialized) == 0x2000U + 16U + 4U * 3U);
+        BOOST_TEST(serialized[12] == 0x01);
+
+        const tetengo::trie::value_deserializer uint32_deserializer{ [](const std::vector<char>& serialized_) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer_{ false };
+            return uint32_deserializer_(serialized_);
+        } };
+        const tetengo::trie::memory_storage deserialized{ stream, uint32_deserializer };
+
+        BOOST_TEST(deserialized.base_check_size() == 3U);
+        BOOST_TEST(deserialized.base_at(0) == 42);
+        BOOST_TEST(deserialized.base_at(1) == 0x7FFFFFFF);
+        BOOST_TEST(deserialized.check_at(1) == 24U);
+        BOOST_TEST(deserialized.base_at(2) == -0x7FFFFFFF);
+        BOOST_TEST(deserialized.value_count() == 3U);
+        BOOST_TEST(!deserialized.value_at(0));
+        BOOST_TEST(!deserialized.value_at(1));
+        BOOST_TEST_REQUIRE(deserialized.value_at(2));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*deserialized.value_at(2)) == 0x12345678U);
+    }
+    {
+        tetengo::trie::memory_storage storage_{};
+
+        storage_.set_base_at(0, 42);
+        storage_.set_base_at(1, 0xFE);
+        storage_.set_check_at(1, 24);
+        storage_.set_preceding_key_count_at(1, 0x12345678);
+
+        storage_.add_value_at(1, std::make_any<std::string>("piyo"));
+
+        std::stringstream stream{};
+        storage_.serialize_v2(stream, string_serializer);
+
+        const auto serialized = stream.str();
+        BOOST_TEST(serialized[12] == 0x02);
+
+        const tetengo::trie::memory_storage deserialized{ stream, string_deserializer };
+
+        BOOST_TEST(base_check_array_of(deserialized) == base_check_array_of(storage_));
+        BOOST_TEST(deserialized.has_preceding_key_counts());
+        BOOST_TEST(deserialized.preceding_key_count_at(0) == 0U);
+        BOOST_TEST(deserialized.preceding_key_count_at(1) == 0x12345678U);
+        BOOST_TEST_REQUIRE(deserialized.value_at(1));
+        BOOST_TEST(std::any_cast<std::string>(*deserialized.value_at(1)) == "piyo");
+
+        std::ostringstream v1_stream{};
+        BOOST_CHECK_THROW(storage_.serialize(v1_stream, string_serializer), std::logic_error);
+    }
+    {
+        const tetengo::trie::memory_storage storage_{};
+
+        std::stringstream stream{};
+        storage_.serialize_v2(stream, string_serializer);
+
+        auto serialized = stream.str();
+        serialized[8] = 0x03;
+        std::istringstream broken_stream{ serialized };
+        BOOST_CHECK_THROW(
+            const tetengo::trie::memory_storage deserialized(broken_stream, string_deserializer),
+            std::ios_base::failure);
+    }
+    {
+        const tetengo::trie::memory_storage storage_{};
+
+        std::stringstream stream{};
+        storage_.serialize_v2(stream, string_serializer);
+
+        const auto         serialized = stream.str();
+        std::istringstream truncated_stream{ serialized.substr(0, 0x1002) };
+        BOOST_CHECK_THROW(
+            const tetengo::trie::memory_storage deserialized(truncated_stream, string_deserializer),
+            std::ios_base::failure);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(clone)
 {
     BOOST_TEST_PASSPOINT();
@@ -4,17 +4,24 @@
     Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
 */
 
+#include <algorithm>
 #include <any>
+#include <bit>
 #include <cmath>
 #include <cstddef> // IWYU pragma: keep
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <ios>
 #include <iterator>
 #include <memory>
+#include <optional>
+#include <span>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -26,6 +33,8 @@
 
 #include <tetengo/trie/default_serializer.hpp>
 #include <tetengo/trie/double_array.hpp>
+#include <tetengo/trie/double_array_iterator.hpp>
+#include <tetengo/trie/memory_storage.hpp>
 #include <tetengo/trie/mmap_storage.hpp>
 #include <tetengo/trie/storage.h>
 #include <tetengo/trie/storage.hpp>
@@ -57,6 +66,25 @@ namespace
         // clang-format on
     };
 
+    const std::vector<char> serialized_indexed{
+        // clang-format off
+        0x00_c, 0x00_c, 0x00_c, 0x02_c,
+        0x00_c, 0x00_c, 0x2A_c, 0xFF_c,
+        0x00_c, 0x00_c, 0xFE_c, 0x18_c,
+        0x00_c, 0x00_c, 0x00_c, 0x05_c,
+        0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+        0x00_c, 0x00_c, 0x00_c, 0x00_c,
+        0x00_c, 0x00_c, 0x00_c, 0x00_c,
+        0x00_c, 0x00_c, 0x00_c, 0x04_c,
+        0x00_c, 0x00_c, 0x00_c, 0x0A_c,
+        0x00_c, 0x00_c, 0x00_c, 0x0A_c,
+        0x00_c, 0x00_c, 0x00_c, 0x0C_c,
+        0x70_c, 0x69_c, 0x79_c, 0x6F_c,
+        0x66_c, 0x75_c, 0x67_c, 0x61_c, 0x66_c, 0x75_c,
+        0x68_c, 0x6F_c,
+        // clang-format on
+    };
+
     const std::vector<char> serialized_fixed_value_size{
         // clang-format off
         0x00_c, 0x00_c, 0x00_c, 0x02_c,
@@ -92,6 +120,22 @@ namespace
         // clang-format on
     };
 
+    const std::vector<char> serialized_wide_fixed_value_size{
+        // clang-format off
+        0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+        0x00_c, 0x00_c, 0x00_c, 0x02_c,
+        0x00_c, 0x00_c, 0x00_c, 0x00_c, 0x00_c, 0x00_c, 0x2A_c, 0xFF_c,
+        0x00_c, 0x00_c, 0x00_c, 0xFF_c, 0x00_c, 0x00_c, 0x00_c, 0x18_c,
+        0x00_c, 0x00_c, 0x00_c, 0x05_c,
+        0x00_c, 0x00_c, 0x00_c, 0x04_c,
+        0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+        0x00_c, 0x00_c, 0x00_c, 0x9F_c,
+        0x00_c, 0x00_c, 0x00_c, 0x0E_c,
+        0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+        0x00_c, 0x00_c, 0x00_c, 0x03_c,
+        // clang-format on
+    };
+
     const std::vector<char> serialized_fixed_value_size_for_calculating_filling_rate{
         // clang-format off
         0x00_c, 0x00_c, 0x00_c, 0x02_c,
@@ -317,6 +361,39 @@ BOOST_AUTO_TEST_CASE(construction)
             const tetengo::trie::mmap_storage storage(file_mapping, file_size + 1, file_size, std::move(deserializer)),
             std::invalid_argument);
     }
+    {
+        const auto file_path = temporary_file_path(serialized_fixed_value_size);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        std::unique_ptr<tetengo::trie::mmap_storage> p_storage{};
+        {
+            const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+            const auto file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+            tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+                static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+                return uint32_deserializer(serialized);
+            } };
+            p_storage =
+                std::make_unique<tetengo::trie::mmap_storage>(file_mapping, 0, file_size, std::move(deserializer));
+        }
+        const auto p_clone = p_storage->clone();
+        p_storage.reset();
+
+        BOOST_TEST(p_clone->base_check_size() == 2U);
+        BOOST_TEST(p_clone->base_at(0) == 42);
+        BOOST_TEST(p_clone->check_at(0) == 0xFFU);
+        BOOST_TEST(p_clone->base_at(1) == 0xFE);
+        BOOST_TEST(p_clone->check_at(1) == 0x18U);
+        BOOST_TEST(!p_clone->value_at(0));
+        BOOST_TEST_REQUIRE(p_clone->value_at(1));
+        BOOST_TEST(*std::any_cast<std::uint32_t>(p_clone->value_at(1)) == 159U);
+        BOOST_TEST_REQUIRE(p_clone->value_at(4));
+        BOOST_TEST(*std::any_cast<std::uint32_t>(p_clone->value_at(4)) == 3U);
+    }
 
     {
         const auto file_path = temporary_file_path(serialized_c_if);
@@ -513,6 +590,26 @@ BOOST_AUTO_TEST_CASE(base_at)
         BOOST_TEST(storage.base_at(0) == 42);
         BOOST_TEST(storage.base_at(1) == 0xFE);
     }
+    {
+        const auto file_path = temporary_file_path(serialized_wide_fixed_value_size);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer) };
+
+        BOOST_TEST(storage.base_check_size() == 2U);
+        BOOST_TEST(storage.base_at(0) == 42);
+        BOOST_TEST(storage.base_at(1) == -0x01000000);
+    }
 
     {
         const auto file_path = temporary_file_path(serialized_c_if);
@@ -712,6 +809,25 @@ BOOST_AUTO_TEST_CASE(check_at)
         BOOST_TEST(storage.check_at(0) == tetengo::trie::double_array::vacant_check_value());
         BOOST_TEST(storage.check_at(1) == 24);
     }
+    {
+        const auto file_path = temporary_file_path(serialized_wide_fixed_value_size);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer) };
+
+        BOOST_TEST(storage.check_at(0) == tetengo::trie::double_array::vacant_check_value());
+        BOOST_TEST(storage.check_at(1) == 24);
+    }
 
     {
         const auto file_path = temporary_file_path(serialized_c_if);
@@ -832,6 +948,57 @@ BOOST_AUTO_TEST_CASE(set_check_at)
     }
 }
 
+BOOST_AUTO_TEST_CASE(base_check_array_view)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const auto file_path = temporary_file_path(serialized_fixed_value_size_with_header);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 5, file_size, std::move(deserializer) };
+
+        const auto o_view = storage.base_check_array_view();
+        BOOST_REQUIRE(o_view);
+        BOOST_CHECK(
+            o_view->layout == tetengo::trie::storage::base_check_array_view_type::layout_type::narrow_big_endian);
+        BOOST_TEST(o_view->size == 2U);
+        BOOST_TEST(static_cast<const char*>(o_view->p_head)[2] == 0x2A_c);
+    }
+    {
+        const auto file_path = temporary_file_path(serialized_wide_fixed_value_size);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer) };
+
+        const auto o_view = storage.base_check_array_view();
+        BOOST_REQUIRE(o_view);
+        BOOST_CHECK(o_view->layout == tetengo::trie::storage::base_check_array_view_type::layout_type::wide_big_endian);
+        BOOST_TEST(o_view->size == 2U);
+        BOOST_TEST(static_cast<const char*>(o_view->p_head)[6] == 0x2A_c);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(value_count)
 {
     BOOST_TEST_PASSPOINT();
@@ -968,6 +1135,161 @@ BOOST_AUTO_TEST_CASE(value_at)
         BOOST_TEST_REQUIRE(storage.value_at(4));
         BOOST_TEST(*std::any_cast<std::uint32_t>(storage.value_at(4)) == 3U);
     }
+    {
+        const auto file_path = temporary_file_path(serialized_wide_fixed_value_size);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer) };
+
+        BOOST_TEST(storage.value_count() == 5U);
+        BOOST_TEST(!storage.value_at(0));
+        BOOST_TEST_REQUIRE(storage.value_at(1));
+        BOOST_TEST(*std::any_cast<std::uint32_t>(storage.value_at(1)) == 159U);
+        BOOST_TEST_REQUIRE(storage.value_at(4));
+        BOOST_TEST(*std::any_cast<std::uint32_t>(storage.value_at(4)) == 3U);
+    }
+    {
+        const auto file_path = temporary_file_path(serialized_fixed_value_size);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer), 2, 2 };
+
+        for (auto i = static_cast<std::size_t>(0); i < 3; ++i)
+        {
+            BOOST_TEST(!storage.shared_value_at(0));
+            BOOST_TEST_REQUIRE(storage.shared_value_at(1));
+            BOOST_TEST(*std::any_cast<std::uint32_t>(storage.shared_value_at(1).get()) == 159U);
+            BOOST_TEST_REQUIRE(storage.shared_value_at(2));
+            BOOST_TEST(*std::any_cast<std::uint32_t>(storage.shared_value_at(2).get()) == 14U);
+            BOOST_TEST(!storage.shared_value_at(3));
+            BOOST_TEST_REQUIRE(storage.shared_value_at(4));
+            BOOST_TEST(*std::any_cast<std::uint32_t>(storage.shared_value_at(4).get()) == 3U);
+        }
+
+        BOOST_CHECK_THROW([[maybe_unused]] const auto* const p_value = storage.value_at(1), std::logic_error);
+    }
+    {
+        const auto file_path = temporary_file_path(serialized_fixed_value_size);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping,
+                                                   0,
+                                                   file_size,
+                                                   std::move(deserializer),
+                                                   tetengo::trie::mmap_storage::default_value_cache_capacity(),
+                                                   4 };
+        const auto p_clone = storage.clone();
+
+        std::vector<std::size_t> mismatch_counts(8, 0);
+        {
+            std::vector<std::thread> threads{};
+            for (auto i = static_cast<std::size_t>(0); i < std::size(mismatch_counts); ++i)
+            {
+                threads.emplace_back([i, &storage, &p_clone, &mismatch_counts]() {
+                    const auto& storage_ =
+                        i % 2 == 0 ? static_cast<const tetengo::trie::storage&>(storage) : *p_clone;
+                    for (auto j = static_cast<std::size_t>(0); j < 1000; ++j)
+                    {
+                        const auto p_value = storage_.shared_value_at(1 + j % 4);
+                        const auto expected = j % 4 == 0 ? 159U : j % 4 == 1 ? 14U : j % 4 == 3 ? 3U : 0U;
+                        const auto actual = p_value ? *std::any_cast<std::uint32_t>(p_value.get()) : 0U;
+                        if (actual != expected)
+                        {
+                            ++mismatch_counts[i];
+                        }
+                    }
+                });
+            }
+            for (auto& thread: threads)
+            {
+                thread.join();
+            }
+        }
+        BOOST_TEST(std::all_of(
+            std::begin(mismatch_counts), std::end(mismatch_counts), [](const auto e) { return e == 0; }));
+    }
+    {
+        const auto serialized = []() {
+            tetengo::trie::memory_storage storage_{};
+            for (auto i = static_cast<std::size_t>(0); i < 200; ++i)
+            {
+                storage_.add_value_at(i, std::make_any<std::uint32_t>(static_cast<std::uint32_t>(i * 3)));
+            }
+
+            const tetengo::trie::value_serializer serializer{
+                [](const std::any& object) {
+                    static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer{ false };
+                    return uint32_serializer(std::any_cast<std::uint32_t>(object));
+                },
+                sizeof(std::uint32_t)
+            };
+            std::ostringstream stream{};
+            storage_.serialize(stream, serializer);
+            const auto serialized_ = stream.str();
+            return std::vector<char>{ std::begin(serialized_), std::end(serialized_) };
+        }();
+        const auto file_path = temporary_file_path(serialized);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized_) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized_);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer), 16, 1 };
+
+        std::vector<std::shared_ptr<const std::any>> p_values{};
+        for (auto i = static_cast<std::size_t>(0); i < 200; ++i)
+        {
+            p_values.push_back(storage.shared_value_at(i));
+        }
+        auto evicted_count = static_cast<std::size_t>(0);
+        for (auto i = static_cast<std::size_t>(0); i < 200; ++i)
+        {
+            BOOST_TEST_REQUIRE(p_values[i]);
+            BOOST_TEST(*std::any_cast<std::uint32_t>(p_values[i].get()) == i * 3);
+            if (p_values[i].use_count() == 1)
+            {
+                ++evicted_count;
+            }
+        }
+        BOOST_TEST(evicted_count >= 200U - 16U);
+    }
 
     {
         const auto file_path = temporary_file_path(serialized_c_if);
@@ -1036,6 +1358,254 @@ BOOST_AUTO_TEST_CASE(value_at)
     }
 }
 
+BOOST_AUTO_TEST_CASE(indexed_value_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const auto file_path = temporary_file_path(serialized_indexed);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            return std::string{ std::begin(serialized), std::end(serialized) };
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer) };
+
+        BOOST_TEST(storage.value_count() == 5U);
+        BOOST_TEST(!storage.value_at(0));
+        BOOST_TEST_REQUIRE(storage.value_at(1));
+        BOOST_TEST(*std::any_cast<std::string>(storage.value_at(1)) == "piyo");
+        BOOST_TEST_REQUIRE(storage.value_at(2));
+        BOOST_TEST(*std::any_cast<std::string>(storage.value_at(2)) == "fugafu");
+        BOOST_TEST(!storage.value_at(3));
+        BOOST_TEST_REQUIRE(storage.value_at(4));
+        BOOST_TEST(*std::any_cast<std::string>(storage.value_at(4)) == "ho");
+        BOOST_TEST(!storage.value_at(5));
+
+        const auto o_serialized = storage.serialized_value_at(2);
+        BOOST_TEST_REQUIRE(o_serialized.has_value());
+        BOOST_TEST((std::string{ std::begin(*o_serialized), std::end(*o_serialized) } == "fugafu"));
+    }
+    {
+        auto broken = serialized_indexed;
+        broken[35] = 0x02_c;
+        const auto file_path = temporary_file_path(broken);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            return std::string{ std::begin(serialized), std::end(serialized) };
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer) };
+
+        BOOST_CHECK_THROW([[maybe_unused]] const auto* const p_value = storage.value_at(2), std::ios_base::failure);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(serialized_value_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const auto file_path = temporary_file_path(serialized_fixed_value_size);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized);
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer) };
+
+        BOOST_TEST(!storage.serialized_value_at(0));
+        {
+            const auto o_serialized = storage.serialized_value_at(1);
+            BOOST_TEST_REQUIRE(o_serialized.has_value());
+            const std::vector<char> expected{ 0x00_c, 0x00_c, 0x00_c, 0x9F_c };
+            BOOST_TEST(std::vector<char>(std::begin(*o_serialized), std::end(*o_serialized)) == expected);
+        }
+        {
+            const auto o_serialized = storage.serialized_value_at(4);
+            BOOST_TEST_REQUIRE(o_serialized.has_value());
+            const std::vector<char> expected{ 0x00_c, 0x00_c, 0x00_c, 0x03_c };
+            BOOST_TEST(std::vector<char>(std::begin(*o_serialized), std::end(*o_serialized)) == expected);
+        }
+        BOOST_TEST(!storage.serialized_value_at(3));
+        BOOST_CHECK_THROW(
+            [[maybe_unused]] const auto o_serialized = storage.serialized_value_at(5), std::ios_base::failure);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(format_v2)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const tetengo::trie::value_serializer string_serializer{
+        [](const std::any& object) {
+            static const tetengo::trie::default_serializer<std::string> string_serializer_{ false };
+            const auto serialized = string_serializer_(std::any_cast<std::string>(object));
+            return std::vector<char>{ std::begin(serialized), std::end(serialized) };
+        },
+        0
+    };
+    const auto serialized = [&string_serializer]() {
+        tetengo::trie::memory_storage storage_{};
+        storage_.set_base_at(0, 42);
+        storage_.set_base_at(1, 0xFE);
+        storage_.set_check_at(1, 24);
+        storage_.add_value_at(4, std::make_any<std::string>("hoge"));
+        storage_.add_value_at(1, std::make_any<std::string>("piyo"));
+
+        std::ostringstream stream{};
+        storage_.serialize_v2(stream, string_serializer);
+        const auto serialized_ = stream.str();
+        return std::vector<char>{ std::begin(serialized_), std::end(serialized_) };
+    }();
+
+    {
+        const auto file_path = temporary_file_path(serialized);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized_) {
+            static const tetengo::trie::default_deserializer<std::string> string_deserializer{ false };
+            return string_deserializer(std::string{ std::begin(serialized_), std::end(serialized_) });
+        } };
+        const tetengo::trie::mmap_storage storage{ file_mapping, 0, file_size, std::move(deserializer) };
+
+        BOOST_TEST(storage.base_check_size() == 2U);
+        BOOST_TEST(storage.base_at(0) == 42);
+        BOOST_TEST(storage.check_at(0) == tetengo::trie::double_array::vacant_check_value());
+        BOOST_TEST(storage.base_at(1) == 0xFE);
+        BOOST_TEST(storage.check_at(1) == 24U);
+
+        const auto o_view = storage.base_check_array_view();
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            BOOST_REQUIRE(o_view);
+            BOOST_CHECK(o_view->layout == tetengo::trie::storage::base_check_array_view_type::layout_type::narrow);
+            BOOST_TEST(o_view->size == 2U);
+            BOOST_TEST(static_cast<const std::uint32_t*>(o_view->p_head)[1] == 0x0000FE18U);
+        }
+        else
+        {
+            BOOST_TEST(!o_view);
+        }
+
+        BOOST_TEST(storage.value_count() == 5U);
+        BOOST_TEST(!storage.value_at(0));
+        BOOST_TEST_REQUIRE(storage.value_at(1));
+        BOOST_TEST(std::any_cast<std::string>(*storage.value_at(1)) == "piyo");
+        BOOST_TEST(!storage.value_at(2));
+        BOOST_TEST(!storage.value_at(3));
+        BOOST_TEST_REQUIRE(storage.value_at(4));
+        BOOST_TEST(std::any_cast<std::string>(*storage.value_at(4)) == "hoge");
+        const auto o_serialized_value = storage.serialized_value_at(4);
+        BOOST_TEST_REQUIRE(o_serialized_value.has_value());
+        BOOST_TEST((std::string{ std::begin(*o_serialized_value), std::end(*o_serialized_value) } == "hoge"));
+    }
+    {
+        const std::vector<std::pair<std::string, std::int32_t>> elements{
+            { "UTO", 0 }, { "UTOUTO", 0 }, { "UTA", 0 }, { "SETA", 0 }, { "SETO", 0 }
+        };
+        const tetengo::trie::double_array double_array_{ elements,
+                                                         tetengo::trie::double_array::null_building_observer_set(),
+                                                         tetengo::trie::double_array::default_density_factor(),
+                                                         tetengo::trie::double_array::default_build_thread_count(),
+                                                         true };
+        std::ostringstream stream{};
+        double_array_.get_storage().serialize_v2(stream, string_serializer);
+        const auto serialized_ = stream.str();
+
+        const auto file_path = temporary_file_path(std::vector<char>{ std::begin(serialized_), std::end(serialized_) });
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized__) {
+            static const tetengo::trie::default_deserializer<std::string> string_deserializer{ false };
+            return string_deserializer(std::string{ std::begin(serialized__), std::end(serialized__) });
+        } };
+        auto p_storage =
+            std::make_unique<tetengo::trie::mmap_storage>(file_mapping, 0, file_size, std::move(deserializer));
+        BOOST_TEST(p_storage->has_preceding_key_counts());
+        const tetengo::trie::double_array restored{ std::move(p_storage), 0 };
+
+        for (const auto& element: elements)
+        {
+            BOOST_CHECK(restored.find(element.first) == double_array_.find(element.first));
+        }
+        BOOST_CHECK(!restored.find("UT"));
+        const std::vector<std::int32_t> values{ std::begin(restored), std::end(restored) };
+        const std::vector<std::int32_t> expected{ 0, 1, 2, 3, 4 };
+        BOOST_CHECK(values == expected);
+    }
+    {
+        auto broken = serialized;
+        broken[8] = 0x03;
+        const auto file_path = temporary_file_path(broken);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized_) {
+            static const tetengo::trie::default_deserializer<std::string> string_deserializer{ false };
+            return string_deserializer(std::string{ std::begin(serialized_), std::end(serialized_) });
+        } };
+        BOOST_CHECK_THROW(
+            const tetengo::trie::mmap_storage storage(file_mapping, 0, file_size, std::move(deserializer)),
+            std::ios_base::failure);
+    }
+    {
+        const std::vector<char> truncated{ std::begin(serialized), std::next(std::begin(serialized), 0x1004) };
+        const auto              file_path = temporary_file_path(truncated);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized_) {
+            static const tetengo::trie::default_deserializer<std::string> string_deserializer{ false };
+            return string_deserializer(std::string{ std::begin(serialized_), std::end(serialized_) });
+        } };
+        BOOST_CHECK_THROW(
+            const tetengo::trie::mmap_storage storage(file_mapping, 0, file_size, std::move(deserializer)),
+            std::ios_base::failure);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(add_value_at)
 {
     BOOST_TEST_PASSPOINT();
@@ -0,0 +1,466 @@
+/*! \file
+    \brief An overlay trie.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/preprocessor.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <tetengo/trie/default_serializer.hpp>
+#include <tetengo/trie/memory_storage.hpp>
+#include <tetengo/trie/mmap_storage.hpp>
+#include <tetengo/trie/overlay_trie.hpp>
+#include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/trie.hpp>
+#include <tetengo/trie/value_serializer.hpp>
+
+
+namespace
+{
+    using trie_type = tetengo::trie::trie<std::string, int>;
+
+    using overlay_trie_type = tetengo::trie::overlay_trie<std::string, int>;
+
+    const tetengo::trie::value_serializer& int_serializer()
+    {
+        static const tetengo::trie::value_serializer singleton{
+            [](const std::any& value) {
+                static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer{ false };
+                return uint32_serializer(static_cast<std::uint32_t>(std::any_cast<int>(value)));
+            },
+            sizeof(std::uint32_t)
+        };
+        return singleton;
+    }
+
+    const tetengo::trie::value_deserializer& int_deserializer()
+    {
+        static const tetengo::trie::value_deserializer singleton{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return static_cast<int>(uint32_deserializer(serialized));
+        } };
+        return singleton;
+    }
+
+    std::unique_ptr<trie_type> create_base()
+    {
+        return std::make_unique<trie_type>(std::initializer_list<std::pair<std::string, int>>{
+            { "Kumamoto", 42 }, { "Tamana", 24 }, { "Tamarai", 4242 }, { "Uto", 2424 } });
+    }
+
+    std::vector<std::pair<std::string, int>> elements_of(const overlay_trie_type& overlay_trie_)
+    {
+        std::vector<std::pair<std::string, int>> elements{};
+        for (auto i = std::begin(overlay_trie_); i != std::end(overlay_trie_); ++i)
+        {
+            elements.emplace_back(i.key(), *i);
+        }
+        return elements;
+    }
+
+    std::filesystem::path temporary_file_path(const std::string& initial_content)
+    {
+        const auto path = std::filesystem::temp_directory_path() / "test_tetengo.trie.overlay_trie";
+
+        {
+            std::ofstream stream{ path, std::ios_base::binary };
+            stream.write(std::data(initial_content), std::size(initial_content));
+        }
+
+        return path;
+    }
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_tetengo)
+BOOST_AUTO_TEST_SUITE(trie)
+BOOST_AUTO_TEST_SUITE(overlay_trie)
+
+
+BOOST_AUTO_TEST_CASE(construction)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const overlay_trie_type overlay_trie_{ create_base() };
+    }
+    {
+        const overlay_trie_type overlay_trie_{ std::make_unique<trie_type>() };
+    }
+    {
+        BOOST_CHECK_THROW(const overlay_trie_type overlay_trie_{ nullptr }, std::invalid_argument);
+    }
+    {
+        std::ostringstream stream{};
+        create_base()->get_storage().serialize(stream, int_serializer());
+
+        const auto file_path = temporary_file_path(stream.str());
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        auto       p_storage =
+            std::make_unique<tetengo::trie::mmap_storage>(file_mapping, 0, file_size, int_deserializer());
+        overlay_trie_type overlay_trie_{ std::make_unique<trie_type>(std::move(p_storage)) };
+
+        BOOST_TEST(overlay_trie_.insert("Arao", 4));
+        BOOST_TEST(overlay_trie_.erase("Tamana"));
+
+        const std::vector<std::pair<std::string, int>> expected{
+            { "Arao", 4 }, { "Kumamoto", 42 }, { "Tamarai", 4242 }, { "Uto", 2424 }
+        };
+        BOOST_TEST((elements_of(overlay_trie_) == expected));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        overlay_trie_type overlay_trie_{ std::make_unique<trie_type>() };
+
+        BOOST_TEST(std::empty(overlay_trie_));
+
+        overlay_trie_.insert("Kumamoto", 42);
+
+        BOOST_TEST(!std::empty(overlay_trie_));
+    }
+    {
+        overlay_trie_type overlay_trie_{ create_base() };
+
+        BOOST_TEST(!std::empty(overlay_trie_));
+
+        overlay_trie_.erase("Kumamoto");
+        overlay_trie_.erase("Tamana");
+        overlay_trie_.erase("Tamarai");
+        overlay_trie_.erase("Uto");
+
+        BOOST_TEST(std::empty(overlay_trie_));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(size)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ create_base() };
+
+    BOOST_TEST(std::size(overlay_trie_) == 4U);
+    BOOST_TEST(overlay_trie_.delta_size() == 0U);
+
+    overlay_trie_.insert("Arao", 4);
+
+    BOOST_TEST(std::size(overlay_trie_) == 5U);
+    BOOST_TEST(overlay_trie_.delta_size() == 1U);
+
+    overlay_trie_.erase("Tamana");
+
+    BOOST_TEST(std::size(overlay_trie_) == 4U);
+    BOOST_TEST(overlay_trie_.delta_size() == 2U);
+
+    overlay_trie_.erase("Arao");
+
+    BOOST_TEST(std::size(overlay_trie_) == 3U);
+    BOOST_TEST(overlay_trie_.delta_size() == 1U);
+}
+
+BOOST_AUTO_TEST_CASE(contains)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ create_base() };
+    overlay_trie_.insert("Arao", 4);
+    overlay_trie_.erase("Tamana");
+
+    BOOST_TEST(overlay_trie_.contains("Kumamoto"));
+    BOOST_TEST(overlay_trie_.contains("Arao"));
+    BOOST_TEST(!overlay_trie_.contains("Tamana"));
+    BOOST_TEST(!overlay_trie_.contains("Tama"));
+    BOOST_TEST(!overlay_trie_.contains("Kikuchi"));
+}
+
+BOOST_AUTO_TEST_CASE(find)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ create_base() };
+    overlay_trie_.insert("Arao", 4);
+    overlay_trie_.erase("Tamana");
+
+    {
+        const auto* const p_found = overlay_trie_.find("Kumamoto");
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 42);
+    }
+    {
+        const auto* const p_found = overlay_trie_.find("Arao");
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 4);
+    }
+    {
+        const auto* const p_found = overlay_trie_.find("Tamana");
+        BOOST_TEST(!p_found);
+    }
+    {
+        const auto* const p_found = overlay_trie_.find("Kikuchi");
+        BOOST_TEST(!p_found);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(find_shared)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ create_base() };
+    overlay_trie_.insert("Arao", 4);
+    overlay_trie_.erase("Tamana");
+
+    {
+        const auto p_found = overlay_trie_.find_shared("Kumamoto");
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 42);
+    }
+    {
+        const auto p_found = overlay_trie_.find_shared("Arao");
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 4);
+    }
+    {
+        const auto p_found = overlay_trie_.find_shared("Tamana");
+        BOOST_TEST(!p_found);
+    }
+    {
+        const auto p_found = overlay_trie_.find_shared("Kikuchi");
+        BOOST_TEST(!p_found);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(common_prefix_search)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ std::make_unique<trie_type>(std::initializer_list<std::pair<std::string, int>>{
+        { "T", 1 }, { "Tama", 4 }, { "Tamana", 6 }, { "Tamarai", 7 } }) };
+
+    {
+        const auto found = overlay_trie_.common_prefix_search("Tamana");
+
+        BOOST_TEST_REQUIRE(std::size(found) == 3U);
+        BOOST_TEST(found[0].first == 1U);
+        BOOST_TEST(*found[0].second == 1);
+        BOOST_TEST(found[1].first == 4U);
+        BOOST_TEST(*found[1].second == 4);
+        BOOST_TEST(found[2].first == 6U);
+        BOOST_TEST(*found[2].second == 6);
+    }
+
+    overlay_trie_.erase("Tama");
+    overlay_trie_.insert("Tam", 3);
+    overlay_trie_.insert("Tamanas", 8);
+
+    {
+        const auto found = overlay_trie_.common_prefix_search("Tamana");
+
+        BOOST_TEST_REQUIRE(std::size(found) == 3U);
+        BOOST_TEST(found[0].first == 1U);
+        BOOST_TEST(*found[0].second == 1);
+        BOOST_TEST(found[1].first == 3U);
+        BOOST_TEST(*found[1].second == 3);
+        BOOST_TEST(found[2].first == 6U);
+        BOOST_TEST(*found[2].second == 6);
+    }
+    {
+        const auto found = overlay_trie_.common_prefix_search("Uto");
+
+        BOOST_TEST(std::empty(found));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(begin_end)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const overlay_trie_type overlay_trie_{ std::make_unique<trie_type>() };
+
+        BOOST_CHECK(std::begin(overlay_trie_) == std::end(overlay_trie_));
+    }
+    {
+        overlay_trie_type overlay_trie_{ create_base() };
+
+        const std::vector<std::pair<std::string, int>> expected{
+            { "Kumamoto", 42 }, { "Tamana", 24 }, { "Tamarai", 4242 }, { "Uto", 2424 }
+        };
+        BOOST_TEST((elements_of(overlay_trie_) == expected));
+    }
+    {
+        overlay_trie_type overlay_trie_{ create_base() };
+        overlay_trie_.insert("Arao", 4);
+        overlay_trie_.insert("Tama", 44);
+        overlay_trie_.insert("Yatsushiro", 8);
+        overlay_trie_.erase("Kumamoto");
+        overlay_trie_.erase("Tamarai");
+        overlay_trie_.erase("Tamana");
+        overlay_trie_.insert("Tamana", 2);
+
+        const std::vector<std::pair<std::string, int>> expected{
+            { "Arao", 4 }, { "Tama", 44 }, { "Tamana", 2 }, { "Uto", 2424 }, { "Yatsushiro", 8 }
+        };
+        BOOST_TEST((elements_of(overlay_trie_) == expected));
+
+        auto iterator = std::begin(overlay_trie_);
+        BOOST_TEST(*iterator == 4);
+        const auto original = iterator++;
+        BOOST_TEST(*original == 4);
+        BOOST_TEST(*iterator == 44);
+    }
+    {
+        overlay_trie_type overlay_trie_{ create_base() };
+        overlay_trie_.erase("Kumamoto");
+        overlay_trie_.erase("Tamana");
+        overlay_trie_.erase("Tamarai");
+        overlay_trie_.erase("Uto");
+
+        BOOST_CHECK(std::begin(overlay_trie_) == std::end(overlay_trie_));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(subtrie)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ create_base() };
+    overlay_trie_.insert("Tamamizu", 3);
+    overlay_trie_.insert("Yatsushiro", 8);
+    overlay_trie_.erase("Tamana");
+
+    {
+        const auto p_subtrie = overlay_trie_.subtrie("Tama");
+        BOOST_TEST_REQUIRE(p_subtrie);
+
+        const std::vector<std::pair<std::string, int>> expected{ { "mizu", 3 }, { "rai", 4242 } };
+        BOOST_TEST((elements_of(*p_subtrie) == expected));
+        BOOST_TEST(!p_subtrie->contains("na"));
+        BOOST_TEST(p_subtrie->contains("rai"));
+
+        BOOST_TEST(p_subtrie->insert("na", 2));
+        BOOST_TEST(p_subtrie->contains("na"));
+        BOOST_TEST(!overlay_trie_.contains("Tamana"));
+    }
+    {
+        const auto p_subtrie = overlay_trie_.subtrie("Yatsu");
+        BOOST_TEST_REQUIRE(p_subtrie);
+
+        const std::vector<std::pair<std::string, int>> expected{ { "shiro", 8 } };
+        BOOST_TEST((elements_of(*p_subtrie) == expected));
+        BOOST_TEST(std::size(*p_subtrie) == 1U);
+    }
+    {
+        const auto p_subtrie = overlay_trie_.subtrie("Kikuchi");
+
+        BOOST_TEST(!p_subtrie);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(insert)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ create_base() };
+
+    BOOST_TEST(overlay_trie_.insert("Arao", 4));
+    BOOST_TEST(!overlay_trie_.insert("Arao", 5));
+    BOOST_TEST(!overlay_trie_.insert("Kumamoto", 43));
+    BOOST_TEST(*overlay_trie_.find("Arao") == 4);
+    BOOST_TEST(*overlay_trie_.find("Kumamoto") == 42);
+
+    BOOST_TEST(overlay_trie_.erase("Kumamoto"));
+    BOOST_TEST(overlay_trie_.insert("Kumamoto", 43));
+    BOOST_TEST(*overlay_trie_.find("Kumamoto") == 43);
+    BOOST_TEST(std::size(overlay_trie_) == 5U);
+
+    BOOST_TEST(*overlay_trie_.get_base().find("Kumamoto") == 42);
+    BOOST_TEST(!overlay_trie_.get_base().contains("Arao"));
+}
+
+BOOST_AUTO_TEST_CASE(erase)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ create_base() };
+    overlay_trie_.insert("Arao", 4);
+
+    BOOST_TEST(overlay_trie_.erase("Arao"));
+    BOOST_TEST(!overlay_trie_.erase("Arao"));
+    BOOST_TEST(overlay_trie_.erase("Tamana"));
+    BOOST_TEST(!overlay_trie_.erase("Tamana"));
+    BOOST_TEST(!overlay_trie_.erase("Kikuchi"));
+    BOOST_TEST(!overlay_trie_.contains("Arao"));
+    BOOST_TEST(!overlay_trie_.contains("Tamana"));
+    BOOST_TEST(std::size(overlay_trie_) == 3U);
+
+    BOOST_TEST(overlay_trie_.insert("Tamana", 2));
+    BOOST_TEST(overlay_trie_.erase("Tamana"));
+    BOOST_TEST(!overlay_trie_.contains("Tamana"));
+    BOOST_TEST(std::size(overlay_trie_) == 3U);
+
+    BOOST_TEST(overlay_trie_.get_base().contains("Tamana"));
+}
+
+BOOST_AUTO_TEST_CASE(compact)
+{
+    BOOST_TEST_PASSPOINT();
+
+    overlay_trie_type overlay_trie_{ create_base() };
+    overlay_trie_.insert("Arao", 4);
+    overlay_trie_.insert("Tama", 44);
+    overlay_trie_.erase("Kumamoto");
+
+    std::stringstream stream{};
+    auto              compaction = overlay_trie_.compact(stream, int_serializer());
+
+    overlay_trie_.insert("Yatsushiro", 8);
+    overlay_trie_.erase("Uto");
+
+    compaction.get();
+
+    auto p_storage = std::make_unique<tetengo::trie::memory_storage>(stream, int_deserializer());
+    const overlay_trie_type compacted{ std::make_unique<trie_type>(std::move(p_storage)) };
+
+    const std::vector<std::pair<std::string, int>> expected{
+        { "Arao", 4 }, { "Tama", 44 }, { "Tamana", 24 }, { "Tamarai", 4242 }, { "Uto", 2424 }
+    };
+    BOOST_TEST((elements_of(compacted) == expected));
+    BOOST_TEST(*compacted.find("Tama") == 44);
+    BOOST_TEST(!compacted.contains("Kumamoto"));
+    BOOST_TEST(compacted.delta_size() == 0U);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -437,6 +437,21 @@ BOOST_AUTO_TEST_CASE(set_check_at)
     }
 }
 
+BOOST_AUTO_TEST_CASE(base_check_array_view)
+{
+    BOOST_TEST_PASSPOINT();
+
+    tetengo::trie::shared_storage storage_{};
+    storage_.set_base_at(1, 42);
+    storage_.set_check_at(1, 24);
+
+    const auto o_view = storage_.base_check_array_view();
+    BOOST_REQUIRE(o_view);
+    BOOST_CHECK(o_view->layout == tetengo::trie::storage::base_check_array_view_type::layout_type::narrow);
+    BOOST_TEST_REQUIRE(o_view->size == 2U);
+    BOOST_TEST(static_cast<const std::uint32_t*>(o_view->p_head)[1] == 0x00002A18U);
+}
+
 BOOST_AUTO_TEST_CASE(value_count)
 {
     BOOST_TEST_PASSPOINT();
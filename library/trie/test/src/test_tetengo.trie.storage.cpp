@@ -135,6 +135,15 @@ BOOST_AUTO_TEST_CASE(set_check_at)
     storage_.set_check_at(24, 124);
 }
 
+BOOST_AUTO_TEST_CASE(base_check_array_view)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const concrete_storage storage_{};
+
+    BOOST_CHECK(!storage_.base_check_array_view());
+}
+
 BOOST_AUTO_TEST_CASE(value_count)
 {
     BOOST_TEST_PASSPOINT();
@@ -153,6 +162,15 @@ BOOST_AUTO_TEST_CASE(value_at)
     BOOST_TEST(!storage_.value_at(42));
 }
 
+BOOST_AUTO_TEST_CASE(shared_value_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const concrete_storage storage_{};
+
+    BOOST_TEST(!storage_.shared_value_at(42));
+}
+
 BOOST_AUTO_TEST_CASE(add_value_at)
 {
     BOOST_TEST_PASSPOINT();
@@ -162,6 +180,16 @@ BOOST_AUTO_TEST_CASE(add_value_at)
     storage_.add_value_at(42, std::make_any<std::string>("hoge"));
 }
 
+BOOST_AUTO_TEST_CASE(serialize_value_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const concrete_storage storage_{};
+
+    const tetengo::trie::value_serializer serializer{ [](const std::any&) { return std::vector<char>{ 'X' }; }, 1 };
+    BOOST_TEST(!storage_.serialize_value_at(42, serializer));
+}
+
 BOOST_AUTO_TEST_CASE(filling_rate)
 {
     BOOST_TEST_PASSPOINT();
@@ -182,6 +210,53 @@ BOOST_AUTO_TEST_CASE(serialize)
     storage_.serialize(output_stream, serializer);
 }
 
+BOOST_AUTO_TEST_CASE(serialize_v2)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const concrete_storage storage_{};
+
+    std::ostringstream                    output_stream{};
+    const tetengo::trie::value_serializer serializer{ [](const std::any&) { return std::vector<char>{}; }, 0 };
+    storage_.serialize_v2(output_stream, serializer);
+
+    static const std::string expected_header{
+        // clang-format off
+        static_cast<char>(0x89), 'T', 'R', 'I', 'E', '\r', '\n', 0x1A,
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x30, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        // clang-format on
+    };
+    static const std::string expected_base_check_array{
+        // clang-format off
+        0x18, 0x2A, 0x00, 0x00,
+        0x18, 0x2A, 0x00, 0x00,
+        0x18, 0x2A, 0x00, 0x00,
+        0x18, 0x2A, 0x00, 0x00,
+        // clang-format on
+    };
+    static const std::string expected_value_array{
+        // clang-format off
+        0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        // clang-format on
+    };
+    const std::string serialized = output_stream.str();
+    BOOST_TEST_REQUIRE(std::size(serialized) == 0x2030U);
+    BOOST_TEST((serialized.substr(0, 0x40) == expected_header));
+    BOOST_TEST((serialized.substr(0x1000, 0x10) == expected_base_check_array));
+    BOOST_TEST((serialized.substr(0x2000) == expected_value_array));
+}
+
 BOOST_AUTO_TEST_CASE(clone)
 {
     BOOST_TEST_PASSPOINT();
@@ -0,0 +1,312 @@
+/*! \file
+    \brief A stream builder.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#include <algorithm>
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/preprocessor.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <tetengo/trie/default_serializer.hpp>
+#include <tetengo/trie/memory_storage.hpp>
+#include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/stream_builder.hpp>
+#include <tetengo/trie/trie.hpp>
+#include <tetengo/trie/value_serializer.hpp>
+
+
+namespace
+{
+    const tetengo::trie::value_serializer& string_serializer()
+    {
+        static const tetengo::trie::value_serializer singleton{
+            [](const std::any& value) {
+                const auto& string_ = std::any_cast<const std::string&>(value);
+                return std::vector<char>{ std::begin(string_), std::end(string_) };
+            },
+            0
+        };
+        return singleton;
+    }
+
+    const tetengo::trie::value_serializer& indexed_string_serializer()
+    {
+        static const tetengo::trie::value_serializer singleton{
+            [](const std::any& value) {
+                const auto& string_ = std::any_cast<const std::string&>(value);
+                return std::vector<char>{ std::begin(string_), std::end(string_) };
+            },
+            0,
+            true
+        };
+        return singleton;
+    }
+
+    const tetengo::trie::value_deserializer& string_deserializer()
+    {
+        static const tetengo::trie::value_deserializer singleton{ [](const std::vector<char>& serialized) {
+            return std::string{ std::begin(serialized), std::end(serialized) };
+        } };
+        return singleton;
+    }
+
+    const tetengo::trie::value_serializer& int_serializer()
+    {
+        static const tetengo::trie::value_serializer singleton{
+            [](const std::any& value) {
+                static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer{ false };
+                return uint32_serializer(static_cast<std::uint32_t>(std::any_cast<int>(value)));
+            },
+            sizeof(std::uint32_t)
+        };
+        return singleton;
+    }
+
+    const tetengo::trie::value_deserializer& int_deserializer()
+    {
+        static const tetengo::trie::value_deserializer singleton{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return static_cast<int>(uint32_deserializer(serialized));
+        } };
+        return singleton;
+    }
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_tetengo)
+BOOST_AUTO_TEST_SUITE(trie)
+BOOST_AUTO_TEST_SUITE(stream_builder)
+
+
+BOOST_AUTO_TEST_CASE(default_window_size)
+{
+    BOOST_TEST_PASSPOINT();
+
+    BOOST_TEST(tetengo::trie::stream_builder::default_window_size() > 0U);
+}
+
+BOOST_AUTO_TEST_CASE(construction)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        std::stringstream                   output_stream{};
+        const tetengo::trie::stream_builder builder{ output_stream, string_serializer() };
+    }
+    {
+        std::stringstream                   output_stream{};
+        const tetengo::trie::stream_builder builder{ output_stream, string_serializer(), 42 };
+    }
+    {
+        std::stringstream                   output_stream{};
+        const tetengo::trie::stream_builder builder{ output_stream, string_serializer(), 42, true };
+    }
+    {
+        std::stringstream output_stream{};
+        BOOST_CHECK_THROW(
+            const tetengo::trie::stream_builder builder(output_stream, string_serializer(), 0), std::invalid_argument);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(add)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        std::stringstream             output_stream{};
+        tetengo::trie::stream_builder builder{ output_stream, string_serializer() };
+
+        builder.add("Kumamoto", std::string{ "Hinokuni" });
+        builder.add("Tamana", std::string{ "Tamana-shi" });
+        BOOST_CHECK_THROW(builder.add("Tamana", std::string{ "Tamana-shi" }), std::invalid_argument);
+        BOOST_CHECK_THROW(builder.add("Aso", std::string{ "Aso-shi" }), std::invalid_argument);
+    }
+    {
+        const std::vector<std::pair<std::string_view, std::string>> elements{ { "Kumamoto", "Hinokuni" },
+                                                                              { "Tamana", "Tamana-shi" } };
+
+        std::stringstream             output_stream{};
+        tetengo::trie::stream_builder builder{ output_stream, string_serializer() };
+
+        builder.add(std::begin(elements), std::end(elements));
+        builder.finish();
+
+        BOOST_CHECK_THROW(builder.add("Uto", std::string{ "Uto-shi" }), std::logic_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(finish)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        std::stringstream             output_stream{};
+        tetengo::trie::stream_builder builder{ output_stream, string_serializer() };
+        builder.finish();
+
+        std::ostringstream                  expected_stream{};
+        const tetengo::trie::memory_storage empty_storage{};
+        empty_storage.serialize(expected_stream, string_serializer());
+
+        BOOST_TEST(output_stream.str() == expected_stream.str());
+    }
+    {
+        std::stringstream             output_stream{};
+        tetengo::trie::stream_builder builder{ output_stream, string_serializer() };
+
+        builder.add("", std::string{ "empty" });
+        builder.add("Kumamoto", std::string{ "Hinokuni" });
+        builder.add("Kumamoto-shi", std::string{ "Chuo-ku" });
+        builder.add("Tamana", std::string{ "Tamana-shi" });
+        builder.add("Uto", std::string{ "Uto-shi" });
+        builder.finish();
+
+        BOOST_CHECK_THROW(builder.finish(), std::logic_error);
+
+        auto p_storage = std::make_unique<tetengo::trie::memory_storage>(output_stream, string_deserializer());
+        const tetengo::trie::trie<std::string_view, std::string> trie_{ std::move(p_storage) };
+
+        BOOST_TEST(std::size(trie_) == 5U);
+        {
+            const auto* const p_found = trie_.find("");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "empty");
+        }
+        {
+            const auto* const p_found = trie_.find("Kumamoto");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "Hinokuni");
+        }
+        {
+            const auto* const p_found = trie_.find("Kumamoto-shi");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "Chuo-ku");
+        }
+        {
+            const auto* const p_found = trie_.find("Tamana");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "Tamana-shi");
+        }
+        {
+            const auto* const p_found = trie_.find("Uto");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "Uto-shi");
+        }
+        BOOST_TEST(!trie_.find("Kuma"));
+        BOOST_TEST(!trie_.find("Kumamoto-"));
+        BOOST_TEST(!trie_.find("Aso"));
+
+        const std::vector<std::string> values{ std::begin(trie_), std::end(trie_) };
+        const std::vector<std::string> expected{ "empty", "Hinokuni", "Chuo-ku", "Tamana-shi", "Uto-shi" };
+        BOOST_CHECK(values == expected);
+    }
+    {
+        std::vector<std::string> keys{};
+        for (auto i = 0; i < 3000; ++i)
+        {
+            keys.push_back(std::to_string(i));
+        }
+        std::sort(std::begin(keys), std::end(keys));
+
+        std::stringstream output_stream{};
+        {
+            tetengo::trie::stream_builder builder{ output_stream, int_serializer(), 16 };
+            for (auto i = static_cast<std::size_t>(0); i < std::size(keys); ++i)
+            {
+                builder.add(keys[i], static_cast<int>(i));
+            }
+            builder.finish();
+        }
+
+        auto p_storage = std::make_unique<tetengo::trie::memory_storage>(output_stream, int_deserializer());
+        const tetengo::trie::trie<std::string_view, int> trie_{ std::move(p_storage) };
+
+        BOOST_TEST(std::size(trie_) == std::size(keys));
+        for (auto i = static_cast<std::size_t>(0); i < std::size(keys); ++i)
+        {
+            const auto* const p_found = trie_.find(keys[i]);
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == static_cast<int>(i));
+        }
+        BOOST_TEST(!trie_.find("3000"));
+        BOOST_TEST(!trie_.find("-1"));
+    }
+    {
+        std::stringstream output_stream{};
+        {
+            tetengo::trie::stream_builder builder{ output_stream, string_serializer(), 16, true };
+            builder.add("Kumamoto", std::string{ "Hinokuni" });
+            builder.add("Tamana", std::string{ "Tamana-shi" });
+            builder.finish();
+        }
+
+        const auto serialized = output_stream.str();
+        BOOST_TEST_REQUIRE(std::size(serialized) >= 4U);
+        BOOST_TEST(serialized.substr(0, 4) == std::string(4, static_cast<char>(0xFF)));
+
+        auto p_storage = std::make_unique<tetengo::trie::memory_storage>(output_stream, string_deserializer());
+        const tetengo::trie::trie<std::string_view, std::string> trie_{ std::move(p_storage) };
+
+        BOOST_TEST(std::size(trie_) == 2U);
+        {
+            const auto* const p_found = trie_.find("Kumamoto");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "Hinokuni");
+        }
+        {
+            const auto* const p_found = trie_.find("Tamana");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "Tamana-shi");
+        }
+        BOOST_TEST(!trie_.find("Uto"));
+    }
+    {
+        std::stringstream output_stream{};
+        {
+            tetengo::trie::stream_builder builder{ output_stream, indexed_string_serializer() };
+            builder.add("Kumamoto", std::string{ "Hinokuni" });
+            builder.add("Tamana", std::string{ "Tamana-shi" });
+            builder.add("Uto", std::string{ "Uto-shi" });
+            builder.finish();
+        }
+
+        auto p_storage = std::make_unique<tetengo::trie::memory_storage>(output_stream, string_deserializer());
+        std::ostringstream reserialized_stream{};
+        p_storage->serialize(reserialized_stream, indexed_string_serializer());
+        BOOST_TEST(reserialized_stream.str() == output_stream.str());
+
+        const tetengo::trie::trie<std::string_view, std::string> trie_{ std::move(p_storage) };
+
+        BOOST_TEST(std::size(trie_) == 3U);
+        {
+            const auto* const p_found = trie_.find("Tamana");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "Tamana-shi");
+        }
+        {
+            const auto* const p_found = trie_.find("Uto");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == "Uto-shi");
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,18 +7,22 @@
 #include <algorithm> // IWYU pragma: keep
 #include <any>
 #include <cstddef> // IWYU pragma: keep
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream> // IWYU pragma: keep
 #include <functional>
 #include <iterator>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <boost/interprocess/file_mapping.hpp>
 #include <boost/preprocessor.hpp>
 #include <boost/scope_exit.hpp>
 #include <boost/stl_interfaces/iterator_interface.hpp> // IWYU pragma: keep
@@ -27,14 +31,18 @@
 #include <tetengo/trie/default_serializer.hpp>
 #include <tetengo/trie/double_array.hpp>
 #include <tetengo/trie/memory_storage.hpp>
+#include <tetengo/trie/mmap_storage.hpp>
 #include <tetengo/trie/storage.h>
 #include <tetengo/trie/storage.hpp>
 #include <tetengo/trie/trie.h>
 #include <tetengo/trie/trie.hpp>
 #include <tetengo/trie/trieIterator.h>
 #include <tetengo/trie/trie_iterator.hpp>
+#include <tetengo/trie/trie_set.hpp>
 #include <tetengo/trie/value_serializer.hpp>
 
+#include "test_tetengo.trie.allocation_counter.hpp"
+
 
 namespace
 {
@@ -224,6 +232,16 @@ BOOST_AUTO_TEST_CASE(default_double_array_density_factor)
     }
 }
 
+BOOST_AUTO_TEST_CASE(default_double_array_build_thread_count)
+{
+    BOOST_TEST_PASSPOINT();
+
+    using trie_type = tetengo::trie::trie<std::string, int>;
+    BOOST_TEST(
+        trie_type::default_double_array_build_thread_count() ==
+        tetengo::trie::double_array::default_build_thread_count());
+}
+
 BOOST_AUTO_TEST_CASE(construction)
 {
     BOOST_TEST_PASSPOINT();
@@ -268,6 +286,20 @@ BOOST_AUTO_TEST_CASE(construction)
         BOOST_TEST(key_deserializer(added_serialized_keys[1]) == "Tamana");
         BOOST_TEST(done);
     }
+    {
+        const tetengo::trie::trie<std::string, int> trie_{
+            { { "Kumamoto", 42 }, { "Tamana", 24 }, { "Uto", 4242 } },
+            tetengo::trie::default_serializer<std::string>{ true },
+            tetengo::trie::trie<std::string, int>::null_building_observer_set(),
+            tetengo::trie::trie<std::string, int>::default_double_array_density_factor(),
+            2
+        };
+
+        BOOST_TEST(std::size(trie_) == 3U);
+        const auto* const p_found = trie_.find("Tamana");
+        BOOST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 24);
+    }
     {
         std::vector<std::pair<std::string_view, std::string>>    content{ { "Kumamoto", kumamoto1 },
                                                                           { "Tamana", tamana1 } };
@@ -463,6 +495,72 @@ BOOST_AUTO_TEST_CASE(construction)
     }
 }
 
+BOOST_AUTO_TEST_CASE(construction_minimized)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        std::vector<std::pair<std::string, int>> elements{};
+        auto                                     value = 0;
+        for (const auto* const stem: { "stalk", "talk", "walk", "work" })
+        {
+            for (const auto* const suffix: { "", "ed", "ing", "s" })
+            {
+                elements.emplace_back(std::string{ stem } + suffix, value++);
+            }
+        }
+        elements.emplace_back("walk", 42);
+
+        const tetengo::trie::trie<std::string, int> trie_{
+            std::begin(elements),
+            std::end(elements),
+            tetengo::trie::default_serializer<std::string>{ true },
+            tetengo::trie::trie<std::string, int>::null_building_observer_set(),
+            tetengo::trie::trie<std::string, int>::default_double_array_density_factor(),
+            tetengo::trie::trie<std::string, int>::default_double_array_build_thread_count(),
+            true
+        };
+        const tetengo::trie::trie<std::string, int> sequential_trie{ std::begin(elements), std::end(elements) };
+
+        BOOST_TEST(trie_.get_storage().has_preceding_key_counts());
+        BOOST_TEST(trie_.get_storage().base_check_size() < sequential_trie.get_storage().base_check_size());
+        BOOST_TEST(std::size(trie_) == std::size(elements) - 1);
+        for (auto i = static_cast<std::size_t>(0); i + 1 < std::size(elements); ++i)
+        {
+            const auto* const p_found = trie_.find(elements[i].first);
+            BOOST_TEST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == elements[i].second);
+        }
+        BOOST_TEST(!trie_.find("wal"));
+
+        const std::vector<int> values{ std::begin(trie_), std::end(trie_) };
+        std::vector<int>       expected{};
+        for (auto i = static_cast<std::size_t>(0); i + 1 < std::size(elements); ++i)
+        {
+            expected.push_back(elements[i].second);
+        }
+        BOOST_CHECK(values == expected);
+
+        const auto p_subtrie = trie_.subtrie("wo");
+        BOOST_TEST_REQUIRE(p_subtrie);
+        const auto* const p_found = p_subtrie->find("rking");
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 14);
+    }
+    {
+        tetengo::trie::trie<std::string, int> trie_{
+            { { "Kumamoto", 42 }, { "Tamana", 24 } },
+            tetengo::trie::default_serializer<std::string>{ true },
+            tetengo::trie::trie<std::string, int>::null_building_observer_set(),
+            tetengo::trie::trie<std::string, int>::default_double_array_density_factor(),
+            tetengo::trie::trie<std::string, int>::default_double_array_build_thread_count(),
+            true
+        };
+
+        BOOST_CHECK_THROW(trie_.insert("Uto", 4242), std::logic_error);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(empty)
 {
     BOOST_TEST_PASSPOINT();
@@ -837,6 +935,26 @@ BOOST_AUTO_TEST_CASE(find)
         BOOST_REQUIRE(p_found);
         BOOST_TEST(*p_found == 42);
     }
+    {
+        const std::vector<std::pair<std::string_view, std::int32_t>> elements{ { "Kumamoto", 42 }, { "Tamana", 24 } };
+        const tetengo::trie::double_array                             double_array_{ elements };
+        const tetengo::trie::trie<std::string_view, int>              trie_{ { "Kumamoto", 42 }, { "Tamana", 24 } };
+
+        test_tetengo::trie::begin_allocation_counting();
+        const auto        o_found_in_double_array = double_array_.find("Kumamoto");
+        const auto        o_not_found_in_double_array = double_array_.find("Kumamo");
+        const auto* const p_found = trie_.find("Tamana");
+        const auto* const p_not_found = trie_.find("Tamanaa");
+        const auto        allocation_counts = test_tetengo::trie::end_allocation_counting();
+
+        BOOST_TEST(allocation_counts.allocations == 0U);
+        BOOST_REQUIRE(o_found_in_double_array);
+        BOOST_TEST(*o_found_in_double_array == 42);
+        BOOST_TEST(!o_not_found_in_double_array);
+        BOOST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 24);
+        BOOST_TEST(!p_not_found);
+    }
 
     {
         std::vector<std::pair<std::string_view, std::string>>    content{};
@@ -931,6 +1049,358 @@ BOOST_AUTO_TEST_CASE(find)
     }
 }
 
+BOOST_AUTO_TEST_CASE(find_shared)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie<std::string_view, int> trie_{ { "Kumamoto", 42 }, { "Tamana", 24 } };
+
+        const auto p_found = trie_.find_shared("Kumamoto");
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 42);
+        BOOST_TEST(p_found.get() == trie_.find("Kumamoto"));
+        BOOST_TEST(!trie_.find_shared("Uto"));
+    }
+    {
+        const tetengo::trie::trie<std::string_view, std::uint32_t> trie_{ { "Kumamoto", 42 },
+                                                                          { "Tamana", 24 },
+                                                                          { "Uto", 3 } };
+        const tetengo::trie::value_serializer serializer{
+            [](const std::any& value) {
+                static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer{ false };
+                return uint32_serializer(std::any_cast<std::uint32_t>(value));
+            },
+            sizeof(std::uint32_t)
+        };
+        std::ostringstream stream{};
+        trie_.get_storage().serialize(stream, serializer);
+        const auto serialized = stream.str();
+
+        const auto file_path = temporary_file_path(std::vector<char>{ std::begin(serialized), std::end(serialized) });
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto                        file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized_) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer{ false };
+            return uint32_deserializer(serialized_);
+        } };
+        auto p_storage =
+            std::make_unique<tetengo::trie::mmap_storage>(file_mapping, 0, file_size, std::move(deserializer), 1, 1);
+        const tetengo::trie::trie<std::string_view, std::uint32_t> deserialized{ std::move(p_storage) };
+
+        const auto p_kumamoto = deserialized.find_shared("Kumamoto");
+        const auto p_tamana = deserialized.find_shared("Tamana");
+        BOOST_TEST_REQUIRE(p_kumamoto);
+        BOOST_TEST(*p_kumamoto == 42U);
+        BOOST_TEST_REQUIRE(p_tamana);
+        BOOST_TEST(*p_tamana == 24U);
+        BOOST_TEST(!deserialized.find_shared("Aso"));
+        BOOST_CHECK_THROW([[maybe_unused]] const auto* const p_found = deserialized.find("Uto"), std::logic_error);
+
+        std::vector<std::uint32_t> values{};
+        std::copy(std::begin(deserialized), std::end(deserialized), std::back_inserter(values));
+        const std::vector<std::uint32_t> expected{ 42, 24, 3 };
+        BOOST_TEST(values == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(find_serialized)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie<std::string_view, int> trie_{ { "Kumamoto", 42 } };
+
+        BOOST_TEST(!trie_.find_serialized("Kumamoto"));
+        BOOST_TEST(!trie_.find_serialized("Tamana"));
+    }
+
+    {
+        const auto file_path = temporary_file_path(serialized_c_if);
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        auto* const p_storage = tetengo_trie_storage_createMmapStorage(file_path.c_str(), 0);
+        BOOST_TEST_REQUIRE(p_storage);
+
+        const auto* const p_trie = tetengo_trie_trie_createWithStorage(p_storage);
+        BOOST_SCOPE_EXIT(p_trie)
+        {
+            tetengo_trie_trie_destroy(p_trie);
+        }
+        BOOST_SCOPE_EXIT_END;
+        BOOST_TEST_REQUIRE(p_trie);
+
+        {
+            auto              size = static_cast<std::size_t>(0);
+            const auto* const p_found = tetengo_trie_trie_findSerialized(p_trie, "Kumamoto", &size);
+            BOOST_TEST_REQUIRE(p_found);
+            BOOST_TEST(size == sizeof(int));
+            auto value = static_cast<int>(0);
+            std::memcpy(&value, p_found, sizeof(int));
+            BOOST_TEST(value == 42);
+        }
+        {
+            const auto* const p_found = tetengo_trie_trie_findSerialized(p_trie, "Tamana", nullptr);
+            BOOST_TEST_REQUIRE(p_found);
+            auto value = static_cast<int>(0);
+            std::memcpy(&value, p_found, sizeof(int));
+            BOOST_TEST(value == 24);
+        }
+        {
+            const auto* const p_found = tetengo_trie_trie_findSerialized(p_trie, "Uto", nullptr);
+            BOOST_TEST(!p_found);
+        }
+        {
+            const auto* const p_found = tetengo_trie_trie_findSerialized(p_trie, nullptr, nullptr);
+            BOOST_TEST(!p_found);
+        }
+    }
+    {
+        const auto* const p_found = tetengo_trie_trie_findSerialized(nullptr, "Kumamoto", nullptr);
+        BOOST_TEST(!p_found);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(find_batch)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie<std::wstring, std::string> trie_{ { kumamoto2, kumamoto1 }, { tamana2, tamana1 } };
+
+        const auto found = trie_.find_batch({ tamana2, uto2, kumamoto2 });
+        BOOST_TEST_REQUIRE(std::size(found) == 3U);
+        BOOST_REQUIRE(found[0]);
+        BOOST_TEST(*found[0] == tamana1);
+        BOOST_TEST(!found[1]);
+        BOOST_REQUIRE(found[2]);
+        BOOST_TEST(*found[2] == kumamoto1);
+    }
+    {
+        const tetengo::trie::trie<std::string_view, int> trie_{};
+
+        const auto found = trie_.find_batch({ "Kumamoto" });
+        BOOST_TEST_REQUIRE(std::size(found) == 1U);
+        BOOST_TEST(!found[0]);
+    }
+    {
+        const tetengo::trie::trie<std::string_view, int> trie_{ { "Kumamoto", 42 }, { "Tamana", 24 } };
+
+        {
+            const auto found = trie_.find_batch({});
+            BOOST_TEST(std::empty(found));
+        }
+        {
+            const auto found = trie_.find_batch({ "Kumamoto", "Uto", "Tamana", "Kuma" });
+            BOOST_TEST_REQUIRE(std::size(found) == 4U);
+            BOOST_REQUIRE(found[0]);
+            BOOST_TEST(*found[0] == 42);
+            BOOST_TEST(!found[1]);
+            BOOST_REQUIRE(found[2]);
+            BOOST_TEST(*found[2] == 24);
+            BOOST_TEST(!found[3]);
+        }
+    }
+
+    {
+        constexpr auto                          kumamoto_value = static_cast<int>(42);
+        constexpr auto                          tamana_value = static_cast<int>(24);
+        std::vector<tetengo_trie_trieElement_t> elements{ { "Kumamoto", &kumamoto_value },
+                                                          { "Tamana", &tamana_value } };
+
+        const auto* const p_trie = tetengo_trie_trie_create(
+            std::data(elements),
+            std::size(elements),
+            sizeof(int),
+            tetengo_trie_trie_nullAddingObserver,
+            nullptr,
+            tetengo_trie_trie_nullDoneObserver,
+            nullptr,
+            tetengo_trie_trie_defaultDoubleArrayDensityFactor());
+        BOOST_SCOPE_EXIT(p_trie)
+        {
+            tetengo_trie_trie_destroy(p_trie);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        {
+            const std::vector<const char*> keys{ "Tamana", "Uto", "Kumamoto" };
+            std::vector<const void*>       values(std::size(keys), nullptr);
+            const auto                     result =
+                tetengo_trie_trie_findBatch(p_trie, std::data(keys), std::size(keys), std::data(values));
+            BOOST_TEST_REQUIRE(result);
+            BOOST_REQUIRE(values[0]);
+            BOOST_TEST(*static_cast<const int*>(values[0]) == tamana_value);
+            BOOST_TEST(!values[1]);
+            BOOST_REQUIRE(values[2]);
+            BOOST_TEST(*static_cast<const int*>(values[2]) == kumamoto_value);
+        }
+        {
+            const auto result = tetengo_trie_trie_findBatch(p_trie, nullptr, 0, nullptr);
+            BOOST_TEST(result);
+        }
+        {
+            const std::vector<const char*> keys{ "Tamana", nullptr };
+            std::vector<const void*>       values(std::size(keys), nullptr);
+            const auto                     result =
+                tetengo_trie_trie_findBatch(p_trie, std::data(keys), std::size(keys), std::data(values));
+            BOOST_TEST(!result);
+        }
+        {
+            const std::vector<const char*> keys{ "Tamana" };
+            const auto result = tetengo_trie_trie_findBatch(p_trie, std::data(keys), std::size(keys), nullptr);
+            BOOST_TEST(!result);
+        }
+    }
+    {
+        const std::vector<const char*> keys{ "Tamana" };
+        std::vector<const void*>       values(std::size(keys), nullptr);
+        const auto result = tetengo_trie_trie_findBatch(nullptr, std::data(keys), std::size(keys), std::data(values));
+        BOOST_TEST(!result);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(common_prefix_search)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie<std::string_view, int> trie_{};
+
+        const auto found = trie_.common_prefix_search("Kumamoto");
+        BOOST_TEST(std::empty(found));
+    }
+    {
+        const tetengo::trie::trie<std::string, copy_detector<std::string>> trie_{
+            { "Tama", detect_copy(std::string{ "tama" }) },
+            { "Tamana", detect_copy(tamana1) },
+            { "Tamarai", detect_copy(tamarai1) },
+        };
+        begin_copy_detection();
+
+        {
+            const auto found = trie_.common_prefix_search("Tamanashi");
+            BOOST_TEST_REQUIRE(std::size(found) == 2U);
+            BOOST_TEST(found[0].first == 4U);
+            BOOST_TEST(found[0].second->value == "tama");
+            BOOST_TEST(found[1].first == 6U);
+            BOOST_TEST(found[1].second->value == tamana1);
+        }
+        {
+            const auto found = trie_.common_prefix_search("Tam");
+            BOOST_TEST(std::empty(found));
+        }
+
+        end_copy_detection();
+    }
+
+    {
+        constexpr auto                          tama_value = static_cast<int>(42);
+        constexpr auto                          tamana_value = static_cast<int>(24);
+        std::vector<tetengo_trie_trieElement_t> elements{ { "Tama", &tama_value }, { "Tamana", &tamana_value } };
+
+        const auto* const p_trie = tetengo_trie_trie_create(
+            std::data(elements),
+            std::size(elements),
+            sizeof(int),
+            tetengo_trie_trie_nullAddingObserver,
+            nullptr,
+            tetengo_trie_trie_nullDoneObserver,
+            nullptr,
+            tetengo_trie_trie_defaultDoubleArrayDensityFactor());
+        BOOST_SCOPE_EXIT(p_trie)
+        {
+            tetengo_trie_trie_destroy(p_trie);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        {
+            const auto match_count = tetengo_trie_trie_commonPrefixSearch(p_trie, "Tamanashi", nullptr, 0);
+            BOOST_TEST(match_count == 2U);
+
+            std::vector<tetengo_trie_trie_prefixMatch_t> matches(match_count);
+            BOOST_TEST(
+                tetengo_trie_trie_commonPrefixSearch(p_trie, "Tamanashi", std::data(matches), std::size(matches)) ==
+                2U);
+            BOOST_TEST(matches[0].length == 4U);
+            BOOST_TEST(*static_cast<const int*>(matches[0].p_value) == tama_value);
+            BOOST_TEST(matches[1].length == 6U);
+            BOOST_TEST(*static_cast<const int*>(matches[1].p_value) == tamana_value);
+        }
+        {
+            tetengo_trie_trie_prefixMatch_t match{};
+            BOOST_TEST(tetengo_trie_trie_commonPrefixSearch(p_trie, "Tamanashi", &match, 1) == 2U);
+            BOOST_TEST(match.length == 4U);
+            BOOST_TEST(*static_cast<const int*>(match.p_value) == tama_value);
+        }
+        {
+            BOOST_TEST(tetengo_trie_trie_commonPrefixSearch(p_trie, "Kumamoto", nullptr, 0) == 0U);
+        }
+        {
+            BOOST_TEST(tetengo_trie_trie_commonPrefixSearch(p_trie, nullptr, nullptr, 0) == static_cast<size_t>(-1));
+        }
+    }
+    {
+        BOOST_TEST(tetengo_trie_trie_commonPrefixSearch(nullptr, "Tama", nullptr, 0) == static_cast<size_t>(-1));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fuzzy_search)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie<std::string_view, int> trie_{};
+
+        const auto found = trie_.fuzzy_search("Kumamoto", 2);
+        BOOST_TEST(std::empty(found));
+    }
+    {
+        const tetengo::trie::trie<std::string, std::string> trie_{
+            { "Kumamoto", kumamoto1 }, { "Tamana", tamana1 }, { "Tamarai", tamarai1 }, { "Tama", "tama" }
+        };
+
+        {
+            const auto found = trie_.fuzzy_search("Tamara", 1);
+            BOOST_TEST_REQUIRE(std::size(found) == 2U);
+            BOOST_TEST(found[0].key == "Tamana");
+            BOOST_TEST(found[0].distance == 1U);
+            BOOST_TEST(*found[0].p_value == tamana1);
+            BOOST_TEST(found[1].key == "Tamarai");
+            BOOST_TEST(found[1].distance == 1U);
+            BOOST_TEST(*found[1].p_value == tamarai1);
+        }
+        {
+            const auto found = trie_.fuzzy_search("Kumamato", 1);
+            BOOST_TEST_REQUIRE(std::size(found) == 1U);
+            BOOST_TEST(found[0].key == "Kumamoto");
+            BOOST_TEST(*found[0].p_value == kumamoto1);
+        }
+        {
+            const auto found = trie_.fuzzy_search("Uto", 2);
+            BOOST_TEST(std::empty(found));
+        }
+    }
+    {
+        const tetengo::trie::trie<std::wstring, int> trie_{ { kumamoto2, 42 }, { tamana2, 24 }, { tamarai2, 4242 } };
+
+        const auto found = trie_.fuzzy_search(tama2, 4);
+        BOOST_TEST_REQUIRE(std::size(found) == 2U);
+        BOOST_TEST(*found[0].p_value == 24);
+        BOOST_TEST(*found[1].p_value == 4242);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(begin_end)
 {
     BOOST_TEST_PASSPOINT();
@@ -1064,6 +1534,7 @@ BOOST_AUTO_TEST_CASE(subtrie)
 
         const auto p_subtrie = trie_.subtrie(tama2);
         BOOST_REQUIRE(p_subtrie);
+        BOOST_TEST(&p_subtrie->get_storage() == &trie_.get_storage());
 
         auto iterator_ = std::begin(*p_subtrie);
         BOOST_REQUIRE(iterator_ != std::end(*p_subtrie));
@@ -1081,6 +1552,7 @@ BOOST_AUTO_TEST_CASE(subtrie)
 
         const auto p_subtrie = trie_.subtrie(tama2);
         BOOST_REQUIRE(p_subtrie);
+        BOOST_TEST(&p_subtrie->get_storage() == &trie_.get_storage());
 
         auto iterator_ = std::begin(*p_subtrie);
         BOOST_REQUIRE(iterator_ != std::end(*p_subtrie));
@@ -1232,6 +1704,151 @@ BOOST_AUTO_TEST_CASE(subtrie)
     }
 }
 
+BOOST_AUTO_TEST_CASE(relocated_storage)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie<std::string, int> trie_{ { "Kumamoto", 42 }, { "Tamana", 24 }, { "Tamarai", 35 } };
+
+        const tetengo::trie::trie<std::string, int> relocated{ trie_.relocated_storage({ "Tamarai", "Tamana" }) };
+
+        const auto* const p_found = relocated.find("Tamarai");
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 35);
+        BOOST_TEST(*relocated.find("Kumamoto") == 42);
+        BOOST_TEST(!relocated.find("Tama"));
+        BOOST_TEST(relocated.size() == 3U);
+    }
+    {
+        const tetengo::trie::trie<std::wstring, std::string> trie_{ { kumamoto2, kumamoto1 }, { tamana2, tamana1 } };
+
+        const tetengo::trie::trie<std::wstring, std::string> relocated{ trie_.relocated_storage() };
+
+        const auto* const p_found = relocated.find(tamana2);
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == tamana1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(insert)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        tetengo::trie::trie<std::string, int> trie_{};
+
+        BOOST_TEST(trie_.insert("Kumamoto", 42));
+        BOOST_TEST(trie_.insert("Tamana", 24));
+        BOOST_TEST(!trie_.insert("Kumamoto", 4242));
+
+        BOOST_TEST(std::size(trie_) == 2U);
+        const auto* const p_found = trie_.find("Kumamoto");
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == 42);
+        BOOST_TEST(*trie_.find("Tamana") == 24);
+    }
+    {
+        tetengo::trie::trie<std::wstring, std::string> trie_{ { kumamoto2, kumamoto1 } };
+
+        BOOST_TEST(trie_.insert(tamana2, tamana1));
+
+        BOOST_TEST(std::size(trie_) == 2U);
+        const auto* const p_found = trie_.find(tamana2);
+        BOOST_TEST_REQUIRE(p_found);
+        BOOST_TEST(*p_found == tamana1);
+    }
+    {
+        const std::vector<std::string>             keys{ "stalk", "talk" };
+        const tetengo::trie::trie_set<std::string> trie_set_{
+            std::begin(keys),
+            std::end(keys),
+            tetengo::trie::default_serializer<std::string>{ true },
+            tetengo::trie::trie_set<std::string>::null_building_observer_set(),
+            tetengo::trie::trie_set<std::string>::default_double_array_density_factor(),
+            tetengo::trie::trie_set<std::string>::default_double_array_build_thread_count(),
+            true
+        };
+        auto p_storage = trie_set_.get_storage().clone();
+        p_storage->add_value_at(0, std::make_any<int>(42));
+        tetengo::trie::trie<std::string, int> trie_{ std::move(p_storage) };
+        BOOST_TEST_REQUIRE(std::size(trie_) == 1U);
+
+        BOOST_CHECK_THROW(trie_.insert("zz", 7), std::logic_error);
+
+        BOOST_TEST(std::size(trie_) == 1U);
+        BOOST_TEST(trie_.get_storage().value_count() == 1U);
+        BOOST_TEST(!trie_.find("zz"));
+        BOOST_TEST_REQUIRE(trie_.find("talk"));
+        BOOST_TEST(*trie_.find("talk") == 42);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(erase)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        tetengo::trie::trie<std::string, int> trie_{ { "Kumamoto", 42 }, { "Tamana", 24 }, { "Tamarai", 35 } };
+
+        BOOST_TEST(trie_.erase("Tamana"));
+        BOOST_TEST(!trie_.erase("Tamana"));
+        BOOST_TEST(!trie_.erase("Tama"));
+
+        BOOST_TEST(std::size(trie_) == 2U);
+        BOOST_TEST(!trie_.find("Tamana"));
+        BOOST_TEST(*trie_.find("Tamarai") == 35);
+
+        BOOST_TEST(trie_.erase("Kumamoto"));
+        BOOST_TEST(trie_.erase("Tamarai"));
+        BOOST_TEST(std::empty(trie_));
+        BOOST_CHECK(std::begin(trie_) == std::end(trie_));
+    }
+    {
+        tetengo::trie::trie<std::string, std::string> trie_{ { "Kumamoto", "KUMAMOTO" },
+                                                             { "Tamana", "TAMANA" },
+                                                             { "Tamarai", "TAMARAI" } };
+
+        for (auto i = 0; i < 3; ++i)
+        {
+            BOOST_TEST(trie_.erase("Tamana"));
+            BOOST_TEST(trie_.insert("Tamana", "TAMANA" + std::to_string(i)));
+        }
+        BOOST_TEST(trie_.get_storage().value_count() == 3U);
+        BOOST_TEST(*trie_.find("Tamana") == "TAMANA2");
+
+        BOOST_TEST(trie_.erase("Kumamoto"));
+        BOOST_TEST(std::size(trie_) == 2U);
+
+        std::stringstream                     stream{};
+        const tetengo::trie::value_serializer serializer{
+            [](const std::any& value) {
+                static const tetengo::trie::default_serializer<std::string> serializer{ false };
+                const auto serialized = serializer(std::any_cast<std::string>(value));
+                return std::vector<char>{ std::begin(serialized), std::end(serialized) };
+            },
+            0
+        };
+        trie_.get_storage().serialize(stream, serializer);
+
+        const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::string> deserializer{ false };
+            return deserializer(std::string{ std::begin(serialized), std::end(serialized) });
+        } };
+        tetengo::trie::trie<std::string, std::string> reloaded{ std::make_unique<tetengo::trie::memory_storage>(
+            stream, deserializer) };
+        BOOST_TEST(std::size(reloaded) == 2U);
+        BOOST_TEST(
+            std::size(reloaded) == static_cast<std::size_t>(std::distance(std::begin(reloaded), std::end(reloaded))));
+
+        BOOST_TEST(reloaded.insert("Uto", "UTO"));
+        BOOST_TEST(std::size(reloaded) == 3U);
+        BOOST_TEST(reloaded.get_storage().value_count() == 3U);
+        BOOST_TEST(*reloaded.find("Uto") == "UTO");
+        BOOST_TEST(*reloaded.find("Tamarai") == "TAMARAI");
+    }
+}
+
 BOOST_AUTO_TEST_CASE(get_storage)
 {
     BOOST_TEST_PASSPOINT();
@@ -232,6 +232,83 @@ BOOST_AUTO_TEST_CASE(operator_dereference)
     }
 }
 
+BOOST_AUTO_TEST_CASE(key)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie<std::wstring, copy_detector<std::string>> trie_{};
+        const auto                                                          iterator = std::begin(trie_);
+
+        BOOST_CHECK_THROW([[maybe_unused]] const auto key = iterator.key(), std::logic_error);
+    }
+    {
+        const tetengo::trie::trie<std::string, int> trie_{ { "Kumamoto", 42 }, { "Tamana", 24 }, { "Uto", 4242 } };
+
+        std::vector<std::pair<std::string, int>> key_values{};
+        for (auto i = std::begin(trie_); i != std::end(trie_); ++i)
+        {
+            key_values.emplace_back(i.key(), *i);
+        }
+
+        const std::vector<std::pair<std::string, int>> expected{ { "Kumamoto", 42 },
+                                                                 { "Tamana", 24 },
+                                                                 { "Uto", 4242 } };
+        BOOST_CHECK(key_values == expected);
+    }
+
+    {
+        constexpr auto                          kumamoto_value = static_cast<int>(42);
+        constexpr auto                          tamana_value = static_cast<int>(24);
+        std::vector<tetengo_trie_trieElement_t> elements{ { "Kumamoto", &kumamoto_value },
+                                                          { "Tamana", &tamana_value } };
+
+        const auto* const p_trie = tetengo_trie_trie_create(
+            std::data(elements),
+            std::size(elements),
+            sizeof(int),
+            tetengo_trie_trie_nullAddingObserver,
+            nullptr,
+            tetengo_trie_trie_nullDoneObserver,
+            nullptr,
+            tetengo_trie_trie_defaultDoubleArrayDensityFactor());
+        BOOST_SCOPE_EXIT(p_trie)
+        {
+            tetengo_trie_trie_destroy(p_trie);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        auto* const p_iterator = tetengo_trie_trie_createIterator(p_trie);
+        BOOST_SCOPE_EXIT(p_iterator)
+        {
+            tetengo_trie_trie_destroyIterator(p_iterator);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        {
+            BOOST_TEST_REQUIRE(tetengo_trie_trieIterator_hasNext(p_iterator));
+            const auto* const key = tetengo_trie_trieIterator_key(p_iterator);
+            BOOST_TEST_REQUIRE(key);
+            BOOST_TEST(std::string{ key } == "Kumamoto");
+            BOOST_TEST(*static_cast<const int*>(tetengo_trie_trieIterator_get(p_iterator)) == kumamoto_value);
+            tetengo_trie_trieIterator_next(p_iterator);
+        }
+        {
+            BOOST_TEST_REQUIRE(tetengo_trie_trieIterator_hasNext(p_iterator));
+            const auto* const key = tetengo_trie_trieIterator_key(p_iterator);
+            BOOST_TEST_REQUIRE(key);
+            BOOST_TEST(std::string{ key } == "Tamana");
+            BOOST_TEST(*static_cast<const int*>(tetengo_trie_trieIterator_get(p_iterator)) == tamana_value);
+            tetengo_trie_trieIterator_next(p_iterator);
+        }
+        BOOST_TEST(!tetengo_trie_trieIterator_hasNext(p_iterator));
+        BOOST_TEST(!tetengo_trie_trieIterator_key(p_iterator));
+    }
+    {
+        BOOST_TEST(!tetengo_trie_trieIterator_key(nullptr));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(operator_equal)
 {
     BOOST_TEST_PASSPOINT();
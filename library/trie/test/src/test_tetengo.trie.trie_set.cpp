@@ -0,0 +1,345 @@
+/*! \file
+    \brief A trie set.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#include <any>
+#include <cstddef> // IWYU pragma: keep
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/preprocessor.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <tetengo/trie/default_serializer.hpp>
+#include <tetengo/trie/memory_storage.hpp>
+#include <tetengo/trie/mmap_storage.hpp>
+#include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/trie_set.hpp>
+#include <tetengo/trie/value_serializer.hpp>
+
+
+namespace
+{
+    const tetengo::trie::value_serializer& null_value_serializer()
+    {
+        static const tetengo::trie::value_serializer singleton{ [](const std::any&) { return std::vector<char>{}; },
+                                                                0 };
+        return singleton;
+    }
+
+    const tetengo::trie::value_deserializer& null_value_deserializer()
+    {
+        static const tetengo::trie::value_deserializer singleton{ [](const std::vector<char>&) { return std::any{}; } };
+        return singleton;
+    }
+
+    std::vector<std::string> keys_of(const tetengo::trie::trie_set<std::string>& trie_set_)
+    {
+        std::vector<std::string> keys{};
+        for (const auto key: trie_set_)
+        {
+            keys.emplace_back(key);
+        }
+        return keys;
+    }
+
+    std::filesystem::path temporary_file_path(const std::string& initial_content)
+    {
+        const auto path = std::filesystem::temp_directory_path() / "test_tetengo.trie.trie_set";
+
+        {
+            std::ofstream stream{ path, std::ios_base::binary };
+            stream.write(std::data(initial_content), std::size(initial_content));
+        }
+
+        return path;
+    }
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_tetengo)
+BOOST_AUTO_TEST_SUITE(trie)
+BOOST_AUTO_TEST_SUITE(trie_set)
+
+
+BOOST_AUTO_TEST_CASE(construction)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{};
+    }
+    {
+        const tetengo::trie::trie_set<std::string_view> trie_set_{ "Kumamoto", "Tamana" };
+    }
+    {
+        const tetengo::trie::trie_set<int> trie_set_{ 42, 24 };
+    }
+    {
+        const std::vector<std::string>             keys{ "Kumamoto", "Tamana" };
+        const tetengo::trie::trie_set<std::string> trie_set_{ std::begin(keys), std::end(keys) };
+    }
+    {
+        std::vector<std::string> added_keys{};
+        auto                     done = false;
+
+        const tetengo::trie::trie_set<std::string> trie_set_{
+            { "Kumamoto", "Tamana" },
+            tetengo::trie::default_serializer<std::string>{ true },
+            tetengo::trie::trie_set<std::string>::building_observer_set_type{
+                [&added_keys](const std::string_view& serialized_key) {
+                    added_keys.emplace_back(serialized_key);
+                },
+                [&done]() { done = true; } }
+        };
+
+        BOOST_TEST_REQUIRE(std::size(added_keys) == 2U);
+        BOOST_TEST(added_keys[0] == "Kumamoto");
+        BOOST_TEST(added_keys[1] == "Tamana");
+        BOOST_TEST(done);
+    }
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{ "Kumamoto", "Tamana" };
+
+        std::stringstream stream{};
+        trie_set_.get_storage().serialize(stream, null_value_serializer());
+
+        auto p_storage = std::make_unique<tetengo::trie::memory_storage>(stream, null_value_deserializer());
+        const tetengo::trie::trie_set<std::string> deserialized{ std::move(p_storage) };
+
+        BOOST_TEST(deserialized.contains("Kumamoto"));
+        BOOST_TEST(deserialized.contains("Tamana"));
+        BOOST_TEST(!deserialized.contains("Uto"));
+    }
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{ "Kumamoto", "Tamana" };
+
+        std::ostringstream stream{};
+        trie_set_.get_storage().serialize(stream, null_value_serializer());
+
+        const auto file_path = temporary_file_path(stream.str());
+        BOOST_SCOPE_EXIT(&file_path)
+        {
+            std::filesystem::remove(file_path);
+        }
+        BOOST_SCOPE_EXIT_END;
+
+        const boost::interprocess::file_mapping file_mapping{ file_path.c_str(), boost::interprocess::read_only };
+        const auto file_size = static_cast<std::size_t>(std::filesystem::file_size(file_path));
+        auto       p_storage =
+            std::make_unique<tetengo::trie::mmap_storage>(file_mapping, 0, file_size, null_value_deserializer());
+        const tetengo::trie::trie_set<std::string> deserialized{ std::move(p_storage) };
+
+        BOOST_TEST(deserialized.contains("Kumamoto"));
+        BOOST_TEST(deserialized.contains("Tamana"));
+        BOOST_TEST(!deserialized.contains("Uto"));
+        BOOST_TEST(deserialized.size() == 2U);
+    }
+    {
+        const std::vector<std::string> keys{ "Kumamoto", "Kumamotoshi", "Tamana", "Tamanashi", "Uto", "Utoshi" };
+        const tetengo::trie::trie_set<std::string> trie_set_{
+            std::begin(keys),
+            std::end(keys),
+            tetengo::trie::default_serializer<std::string>{ true },
+            tetengo::trie::trie_set<std::string>::null_building_observer_set(),
+            tetengo::trie::trie_set<std::string>::default_double_array_density_factor(),
+            tetengo::trie::trie_set<std::string>::default_double_array_build_thread_count(),
+            true
+        };
+        const tetengo::trie::trie_set<std::string> sequential_trie_set{ std::begin(keys), std::end(keys) };
+
+        BOOST_TEST(trie_set_.get_storage().base_check_size() < sequential_trie_set.get_storage().base_check_size());
+        BOOST_TEST(keys_of(trie_set_) == keys);
+        BOOST_TEST(trie_set_.contains("Tamanashi"));
+        BOOST_TEST(!trie_set_.contains("Tamanash"));
+        BOOST_TEST(!trie_set_.contains("Utoshishi"));
+
+        std::stringstream stream{};
+        trie_set_.get_storage().serialize(stream, null_value_serializer());
+
+        auto p_storage = std::make_unique<tetengo::trie::memory_storage>(stream, null_value_deserializer());
+        const tetengo::trie::trie_set<std::string> deserialized{ std::move(p_storage) };
+
+        BOOST_TEST(keys_of(deserialized) == keys);
+    }
+    {
+        std::vector<std::string> keys{};
+        for (auto i = static_cast<std::size_t>(0); i < 2000; ++i)
+        {
+            keys.push_back(std::to_string(i * 7919 % 2000));
+        }
+
+        std::vector<std::string> added_keys{};
+        auto                     done = false;
+        const auto               observer = tetengo::trie::trie_set<std::string>::building_observer_set_type{
+            [&added_keys](const std::string_view& key) { added_keys.emplace_back(key); }, [&done]() { done = true; }
+        };
+        const tetengo::trie::trie_set<std::string> trie_set_{
+            std::begin(keys),
+            std::end(keys),
+            tetengo::trie::default_serializer<std::string>{ true },
+            observer,
+            tetengo::trie::trie_set<std::string>::default_double_array_density_factor(),
+            4,
+            true
+        };
+        const tetengo::trie::trie_set<std::string> sequential_trie_set{ std::begin(keys), std::end(keys) };
+
+        BOOST_TEST(std::size(added_keys) == std::size(keys));
+        BOOST_TEST(done);
+        BOOST_TEST(trie_set_.get_storage().base_check_size() < sequential_trie_set.get_storage().base_check_size());
+        BOOST_TEST(keys_of(trie_set_) == keys_of(sequential_trie_set));
+        BOOST_TEST(!trie_set_.contains("2000"));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{};
+
+        BOOST_TEST(std::empty(trie_set_));
+    }
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{ "Kumamoto", "Tamana" };
+
+        BOOST_TEST(!std::empty(trie_set_));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(size)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{};
+
+        BOOST_TEST(std::size(trie_set_) == 0U);
+    }
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{ "Kumamoto", "Tamana", "Tamarai" };
+
+        BOOST_TEST(std::size(trie_set_) == 3U);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(contains)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{};
+
+        BOOST_TEST(!trie_set_.contains("Kumamoto"));
+    }
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{ "Kumamoto", "Tamana" };
+
+        BOOST_TEST(trie_set_.contains("Kumamoto"));
+        BOOST_TEST(trie_set_.contains("Tamana"));
+        BOOST_TEST(!trie_set_.contains("Tama"));
+        BOOST_TEST(!trie_set_.contains("Uto"));
+    }
+    {
+        const tetengo::trie::trie_set<int> trie_set_{ 42, 24 };
+
+        BOOST_TEST(trie_set_.contains(42));
+        BOOST_TEST(trie_set_.contains(24));
+        BOOST_TEST(!trie_set_.contains(4242));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(common_prefix_search)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const tetengo::trie::trie_set<std::string> trie_set_{ "Tama", "Tamana", "Tamarai", "T" };
+
+    {
+        const auto found = trie_set_.common_prefix_search("Tamana");
+
+        const std::vector<std::size_t> expected{ 1, 4, 6 };
+        BOOST_TEST(found == expected);
+    }
+    {
+        const auto found = trie_set_.common_prefix_search("Uto");
+
+        BOOST_TEST(std::empty(found));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(begin_end)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{};
+
+        BOOST_CHECK(std::begin(trie_set_) == std::end(trie_set_));
+    }
+    {
+        const tetengo::trie::trie_set<std::string> trie_set_{ "Kumamoto", "Tamana", "Tamarai" };
+
+        const std::vector<std::string> expected{ "Kumamoto", "Tamana", "Tamarai" };
+        BOOST_TEST(keys_of(trie_set_) == expected);
+
+        auto iterator = std::begin(trie_set_);
+        BOOST_TEST(*iterator == "Kumamoto");
+        const auto original = iterator++;
+        BOOST_TEST(*original == "Kumamoto");
+        BOOST_TEST(*iterator == "Tamana");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(subtrie)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const tetengo::trie::trie_set<std::string> trie_set_{ "Kumamoto", "Tamana", "Tamarai" };
+
+    {
+        const auto p_subtrie = trie_set_.subtrie("Tama");
+        BOOST_TEST_REQUIRE(p_subtrie);
+
+        const std::vector<std::string> expected{ "na", "rai" };
+        BOOST_TEST(keys_of(*p_subtrie) == expected);
+        BOOST_TEST(p_subtrie->contains("na"));
+        BOOST_TEST(!p_subtrie->contains("Tamana"));
+    }
+    {
+        const auto p_subtrie = trie_set_.subtrie("Uto");
+
+        BOOST_TEST(!p_subtrie);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(get_storage)
+{
+    BOOST_TEST_PASSPOINT();
+
+    const tetengo::trie::trie_set<std::string> trie_set_{ "Kumamoto", "Tamana" };
+
+    const auto& storage = trie_set_.get_storage();
+    BOOST_TEST(storage.base_check_size() > 0U);
+    BOOST_TEST(storage.value_count() == 0U);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,545 @@
+/*! \file
+    \brief A typed memory storage.
+
+    Copyright (C) 2019-2026 kaoru  https://www.tetengo.org/
+*/
+
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <boost/preprocessor.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <tetengo/trie/default_serializer.hpp>
+#include <tetengo/trie/memory_storage.hpp>
+#include <tetengo/trie/storage.hpp>
+#include <tetengo/trie/trie.hpp>
+#include <tetengo/trie/typed_memory_storage.hpp>
+#include <tetengo/trie/value_serializer.hpp>
+
+
+namespace
+{
+    constexpr char operator""_c(const unsigned long long int uc)
+    {
+        return static_cast<char>(uc);
+    }
+
+    const std::vector<char> serialized_fixed_value_size{
+        // clang-format off
+        0x00_c, 0x00_c, 0x00_c, 0x02_c,
+        0x00_c, 0x00_c, 0x2A_c, 0xFF_c,
+        0x00_c, 0x00_c, 0xFE_c, 0x18_c,
+        0x00_c, 0x00_c, 0x00_c, 0x05_c,
+        0x00_c, 0x00_c, 0x00_c, 0x04_c,
+        0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+        0x00_c, 0x00_c, 0x00_c, 0x9F_c,
+        0x00_c, 0x00_c, 0x00_c, 0x0E_c,
+        0xFF_c, 0xFF_c, 0xFF_c, 0xFF_c,
+        0x00_c, 0x00_c, 0x00_c, 0x03_c,
+        // clang-format on
+    };
+
+    std::unique_ptr<std::istream> create_input_stream_fixed_value_size()
+    {
+        return std::make_unique<std::stringstream>(
+            std::string{ std::begin(serialized_fixed_value_size), std::end(serialized_fixed_value_size) });
+    }
+
+    const tetengo::trie::value_serializer& uint32_serializer()
+    {
+        static const tetengo::trie::value_serializer singleton{
+            [](const std::any& value) {
+                static const tetengo::trie::default_serializer<std::uint32_t> uint32_serializer_{ false };
+                return uint32_serializer_(std::any_cast<std::uint32_t>(value));
+            },
+            sizeof(std::uint32_t)
+        };
+        return singleton;
+    }
+
+    const tetengo::trie::value_deserializer& uint32_deserializer()
+    {
+        static const tetengo::trie::value_deserializer singleton{ [](const std::vector<char>& serialized) {
+            static const tetengo::trie::default_deserializer<std::uint32_t> uint32_deserializer_{ false };
+            return uint32_deserializer_(serialized);
+        } };
+        return singleton;
+    }
+
+
+}
+
+
+BOOST_AUTO_TEST_SUITE(test_tetengo)
+BOOST_AUTO_TEST_SUITE(trie)
+BOOST_AUTO_TEST_SUITE(typed_memory_storage)
+
+
+BOOST_AUTO_TEST_CASE(construction)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{};
+    }
+    {
+        const auto p_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ *p_input_stream, uint32_deserializer() };
+
+        BOOST_TEST(storage_.base_check_size() == 2U);
+        BOOST_TEST(storage_.base_at(0) == 42);
+        BOOST_TEST(storage_.check_at(1) == 0x18U);
+        BOOST_TEST(storage_.value_count() == 5U);
+    }
+    {
+        const auto                          p_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::memory_storage memory_storage_{ *p_input_stream, uint32_deserializer() };
+
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ memory_storage_ };
+
+        BOOST_TEST(storage_.base_check_size() == 2U);
+        BOOST_TEST(storage_.base_at(1) == 254);
+        BOOST_TEST(storage_.check_at(0) == 0xFFU);
+        BOOST_TEST(storage_.value_count() == 5U);
+        BOOST_TEST(!storage_.value_at(0));
+        BOOST_REQUIRE(storage_.value_at(1));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*storage_.value_at(1)) == 159U);
+    }
+    {
+        tetengo::trie::memory_storage memory_storage_{};
+        memory_storage_.add_value_at(0, std::string{ "hoge" });
+
+        BOOST_CHECK_THROW(
+            const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ memory_storage_ }, std::bad_any_cast);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(value_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const auto p_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ *p_input_stream, uint32_deserializer() };
+
+        BOOST_TEST(!storage_.value_at(0));
+        BOOST_REQUIRE(storage_.value_at(1));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*storage_.value_at(1)) == 159U);
+        BOOST_REQUIRE(storage_.value_at(2));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*storage_.value_at(2)) == 14U);
+        BOOST_TEST(!storage_.value_at(3));
+        BOOST_REQUIRE(storage_.value_at(4));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*storage_.value_at(4)) == 3U);
+        BOOST_TEST(!storage_.value_at(5));
+
+        BOOST_TEST(storage_.value_at(1) == storage_.value_at(1));
+    }
+    {
+        tetengo::trie::typed_memory_storage<std::string> storage_{};
+        storage_.add_value_at(1, std::string{ "hoge" });
+
+        const auto* const p_value = storage_.value_at(1);
+        BOOST_REQUIRE(p_value);
+
+        storage_.add_value_at(42, std::string{ "fuga" });
+        storage_.add_value_at(0, std::string{ "piyo" });
+
+        BOOST_TEST(storage_.value_at(1) == p_value);
+        BOOST_TEST(std::any_cast<std::string>(*p_value) == "hoge");
+
+        storage_.add_value_at(1, std::string{ "foo" });
+
+        BOOST_TEST(storage_.value_at(1) == p_value);
+        BOOST_TEST(std::any_cast<std::string>(*p_value) == "foo");
+    }
+    {
+        tetengo::trie::typed_memory_storage<std::uint32_t> storage_{};
+        for (auto i = static_cast<std::size_t>(0); i < 1000; ++i)
+        {
+            storage_.add_value_at(i, static_cast<std::uint32_t>(i * 3));
+        }
+
+        std::vector<std::thread> threads{};
+        std::atomic<bool>        all_found{ true };
+        for (auto i = static_cast<std::size_t>(0); i < 4; ++i)
+        {
+            threads.emplace_back([&storage_, &all_found]() {
+                for (auto j = static_cast<std::size_t>(0); j < 1000; ++j)
+                {
+                    const auto* const p_value = storage_.value_at(j);
+                    if (!p_value || std::any_cast<std::uint32_t>(*p_value) != j * 3)
+                    {
+                        all_found = false;
+                    }
+                }
+            });
+        }
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+        BOOST_TEST(all_found.load());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(value_array_view)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{};
+
+        const auto o_view = storage_.value_array_view();
+        BOOST_REQUIRE(o_view);
+        BOOST_CHECK(*o_view->p_value_type == typeid(std::uint32_t));
+        BOOST_TEST(o_view->size == 0U);
+    }
+    {
+        const auto p_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ *p_input_stream, uint32_deserializer() };
+
+        const auto o_view = storage_.value_array_view();
+        BOOST_REQUIRE(o_view);
+        BOOST_CHECK(*o_view->p_value_type == typeid(std::uint32_t));
+        BOOST_TEST_REQUIRE(o_view->size == 5U);
+        const auto* const p_values = static_cast<const std::uint32_t*>(o_view->p_head);
+        BOOST_TEST(p_values[1] == 159U);
+        BOOST_TEST(p_values[2] == 14U);
+        BOOST_TEST(p_values[4] == 3U);
+        BOOST_REQUIRE(o_view->p_presences);
+        const std::vector<std::uint8_t> presences{ o_view->p_presences, o_view->p_presences + o_view->size };
+        const std::vector<std::uint8_t> expected_presences{ 0, 1, 1, 0, 1 };
+        BOOST_TEST(presences == expected_presences);
+    }
+    {
+        const tetengo::trie::memory_storage storage_{};
+
+        BOOST_TEST(!storage_.value_array_view());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(add_value_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        tetengo::trie::typed_memory_storage<std::string> storage_{};
+
+        storage_.add_value_at(24, std::string{ "hoge" });
+
+        BOOST_TEST(storage_.value_count() == 25U);
+        BOOST_TEST(!storage_.value_at(0));
+        BOOST_REQUIRE(storage_.value_at(24));
+        BOOST_TEST(std::any_cast<std::string>(*storage_.value_at(24)) == "hoge");
+
+        storage_.add_value_at(42, std::string{ "fuga" });
+
+        BOOST_TEST(storage_.value_count() == 43U);
+        BOOST_REQUIRE(storage_.value_at(42));
+        BOOST_TEST(std::any_cast<std::string>(*storage_.value_at(42)) == "fuga");
+
+        storage_.add_value_at(24, std::string{ "piyo" });
+
+        BOOST_REQUIRE(storage_.value_at(24));
+        BOOST_TEST(std::any_cast<std::string>(*storage_.value_at(24)) == "piyo");
+
+        const auto o_view = storage_.value_array_view();
+        BOOST_REQUIRE(o_view);
+        BOOST_TEST(static_cast<const std::string*>(o_view->p_head)[24] == "piyo");
+
+        BOOST_CHECK_THROW(storage_.add_value_at(0, 42), std::bad_any_cast);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(serialize)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const auto p_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ *p_input_stream, uint32_deserializer() };
+
+        std::ostringstream output_stream{};
+        storage_.serialize(output_stream, uint32_serializer());
+
+        const std::string expected{ std::begin(serialized_fixed_value_size), std::end(serialized_fixed_value_size) };
+        BOOST_CHECK(output_stream.str() == expected);
+    }
+    {
+        const tetengo::trie::value_serializer serializer{ [](const std::any& value) {
+                                                             const auto& string_ = std::any_cast<std::string>(value);
+                                                             return std::vector<char>{ std::begin(string_),
+                                                                                       std::end(string_) };
+                                                         },
+                                                          0 };
+        const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            return std::string{ std::begin(serialized), std::end(serialized) };
+        } };
+
+        tetengo::trie::typed_memory_storage<std::string> storage_{};
+        storage_.set_base_at(0, 42);
+        storage_.set_check_at(1, 24);
+        storage_.add_value_at(1, std::string{ "hoge" });
+
+        std::stringstream typed_stream{};
+        storage_.serialize(typed_stream, serializer);
+
+        tetengo::trie::memory_storage memory_storage_{};
+        memory_storage_.set_base_at(0, 42);
+        memory_storage_.set_check_at(1, 24);
+        memory_storage_.add_value_at(1, std::string{ "hoge" });
+
+        std::ostringstream memory_stream{};
+        memory_storage_.serialize(memory_stream, serializer);
+
+        BOOST_CHECK(typed_stream.str() == memory_stream.str());
+
+        const tetengo::trie::typed_memory_storage<std::string> deserialized{ typed_stream, deserializer };
+        BOOST_TEST(deserialized.base_at(0) == 42);
+        BOOST_TEST(deserialized.check_at(1) == 24U);
+        BOOST_TEST(deserialized.value_count() == 2U);
+        BOOST_TEST(!deserialized.value_at(0));
+        BOOST_REQUIRE(deserialized.value_at(1));
+        BOOST_TEST(std::any_cast<std::string>(*deserialized.value_at(1)) == "hoge");
+    }
+    {
+        const tetengo::trie::value_serializer serializer{ [](const std::any& value) {
+                                                             const auto& string_ = std::any_cast<std::string>(value);
+                                                             return std::vector<char>{ std::begin(string_),
+                                                                                       std::end(string_) };
+                                                         },
+                                                          0,
+                                                          true };
+        const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            return std::string{ std::begin(serialized), std::end(serialized) };
+        } };
+
+        tetengo::trie::typed_memory_storage<std::string> storage_{};
+        storage_.set_base_at(0, 42);
+        storage_.set_check_at(1, 24);
+        storage_.add_value_at(1, std::string{ "hoge" });
+
+        std::stringstream typed_stream{};
+        storage_.serialize(typed_stream, serializer);
+
+        tetengo::trie::memory_storage memory_storage_{};
+        memory_storage_.set_base_at(0, 42);
+        memory_storage_.set_check_at(1, 24);
+        memory_storage_.add_value_at(1, std::string{ "hoge" });
+
+        std::ostringstream memory_stream{};
+        memory_storage_.serialize(memory_stream, serializer);
+
+        BOOST_CHECK(typed_stream.str() == memory_stream.str());
+
+        const tetengo::trie::typed_memory_storage<std::string> deserialized{ typed_stream, deserializer };
+        BOOST_TEST(deserialized.base_at(0) == 42);
+        BOOST_TEST(deserialized.check_at(1) == 24U);
+        BOOST_TEST(deserialized.value_count() == 2U);
+        BOOST_TEST(!deserialized.value_at(0));
+        BOOST_REQUIRE(deserialized.value_at(1));
+        BOOST_TEST(std::any_cast<std::string>(*deserialized.value_at(1)) == "hoge");
+    }
+    {
+        const auto p_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ *p_input_stream, uint32_deserializer() };
+
+        std::stringstream typed_stream{};
+        storage_.serialize_v2(typed_stream, uint32_serializer());
+
+        const auto p_memory_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::memory_storage memory_storage_{ *p_memory_input_stream, uint32_deserializer() };
+
+        std::ostringstream memory_stream{};
+        memory_storage_.serialize_v2(memory_stream, uint32_serializer());
+
+        BOOST_CHECK(typed_stream.str() == memory_stream.str());
+
+        const tetengo::trie::typed_memory_storage<std::uint32_t> deserialized{ typed_stream, uint32_deserializer() };
+        BOOST_TEST(deserialized.base_at(0) == 42);
+        BOOST_TEST(deserialized.base_at(1) == 0xFE);
+        BOOST_TEST(deserialized.check_at(1) == 24U);
+        BOOST_TEST(deserialized.value_count() == 5U);
+        BOOST_TEST(!deserialized.value_at(0));
+        BOOST_REQUIRE(deserialized.value_at(1));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*deserialized.value_at(1)) == 159U);
+        BOOST_TEST(!deserialized.value_at(3));
+        BOOST_REQUIRE(deserialized.value_at(4));
+        BOOST_TEST(std::any_cast<std::uint32_t>(*deserialized.value_at(4)) == 3U);
+    }
+    {
+        const tetengo::trie::value_serializer serializer{ [](const std::any& value) {
+                                                             const auto& string_ = std::any_cast<std::string>(value);
+                                                             return std::vector<char>{ std::begin(string_),
+                                                                                       std::end(string_) };
+                                                         },
+                                                          0 };
+        const tetengo::trie::value_deserializer deserializer{ [](const std::vector<char>& serialized) {
+            return std::string{ std::begin(serialized), std::end(serialized) };
+        } };
+
+        tetengo::trie::typed_memory_storage<std::string> storage_{};
+        tetengo::trie::memory_storage                    memory_storage_{};
+        for (auto i = static_cast<std::size_t>(0); i < 10000; ++i)
+        {
+            if (i % 3 != 0)
+            {
+                storage_.add_value_at(i, std::to_string(i));
+                memory_storage_.add_value_at(i, std::to_string(i));
+            }
+        }
+
+        std::stringstream typed_stream{};
+        storage_.serialize_v2(typed_stream, serializer);
+
+        std::ostringstream memory_stream{};
+        memory_storage_.serialize_v2(memory_stream, serializer);
+
+        BOOST_CHECK(typed_stream.str() == memory_stream.str());
+
+        const tetengo::trie::typed_memory_storage<std::string> deserialized{ typed_stream, deserializer };
+        BOOST_TEST(deserialized.value_count() == 9999U);
+        BOOST_TEST(!deserialized.value_at(0));
+        BOOST_REQUIRE(deserialized.value_at(1));
+        BOOST_TEST(std::any_cast<std::string>(*deserialized.value_at(1)) == "1");
+        BOOST_REQUIRE(deserialized.value_at(9998));
+        BOOST_TEST(std::any_cast<std::string>(*deserialized.value_at(9998)) == "9998");
+        BOOST_TEST(!deserialized.value_at(9996));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(serialize_value_at)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const auto p_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ *p_input_stream, uint32_deserializer() };
+
+        BOOST_TEST(!storage_.serialize_value_at(0, uint32_serializer()));
+        const auto o_serialized = storage_.serialize_value_at(1, uint32_serializer());
+        BOOST_REQUIRE(o_serialized);
+        const std::vector<char> expected{ 0x00_c, 0x00_c, 0x00_c, 0x9F_c };
+        BOOST_TEST(*o_serialized == expected);
+        BOOST_TEST(!storage_.serialize_value_at(3, uint32_serializer()));
+        BOOST_TEST(!storage_.serialize_value_at(5, uint32_serializer()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(clone)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const auto p_input_stream = create_input_stream_fixed_value_size();
+        const tetengo::trie::typed_memory_storage<std::uint32_t> storage_{ *p_input_stream, uint32_deserializer() };
+
+        const auto p_clone = storage_.clone();
+        BOOST_REQUIRE(p_clone);
+        BOOST_TEST(p_clone->base_check_size() == 2U);
+        BOOST_TEST(p_clone->base_at(0) == 42);
+        BOOST_TEST(p_clone->check_at(1) == 0x18U);
+        BOOST_TEST(p_clone->value_count() == 5U);
+        BOOST_TEST(!p_clone->value_at(0));
+        const auto o_view = p_clone->value_array_view();
+        BOOST_REQUIRE(o_view);
+        BOOST_TEST(static_cast<const std::uint32_t*>(o_view->p_head)[1] == 159U);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(trie)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::trie<std::string_view, std::uint32_t> built{
+            { "Kumamoto", 42 }, { "Kumamoto-shi", 4242 }, { "Tamana", 24 }
+        };
+        auto p_storage = std::make_unique<tetengo::trie::typed_memory_storage<std::uint32_t>>(built.get_storage());
+        const tetengo::trie::trie<std::string_view, std::uint32_t> trie_{ std::move(p_storage) };
+
+        const auto o_view = trie_.get_storage().value_array_view();
+        BOOST_REQUIRE(o_view);
+        const auto* const p_values = static_cast<const std::uint32_t*>(o_view->p_head);
+        const auto        in_view = [p_values, &o_view](const std::uint32_t* const p_value) {
+            return p_values <= p_value && p_value < p_values + o_view->size;
+        };
+
+        {
+            const auto* const p_found = trie_.find("Kumamoto");
+            BOOST_REQUIRE(p_found);
+            BOOST_TEST(*p_found == 42U);
+            BOOST_TEST(in_view(p_found));
+        }
+        BOOST_TEST(!trie_.find("Kuma"));
+        {
+            const auto found = trie_.find_batch({ "Tamana", "Uto", "Kumamoto-shi" });
+            BOOST_TEST_REQUIRE(std::size(found) == 3U);
+            BOOST_REQUIRE(found[0]);
+            BOOST_TEST(*found[0] == 24U);
+            BOOST_TEST(in_view(found[0]));
+            BOOST_TEST(!found[1]);
+            BOOST_REQUIRE(found[2]);
+            BOOST_TEST(*found[2] == 4242U);
+        }
+        {
+            const auto found = trie_.common_prefix_search("Kumamoto-shi");
+            BOOST_TEST_REQUIRE(std::size(found) == 2U);
+            BOOST_TEST(found[0].first == 8U);
+            BOOST_TEST(*found[0].second == 42U);
+            BOOST_TEST(in_view(found[0].second));
+            BOOST_TEST(found[1].first == 12U);
+            BOOST_TEST(*found[1].second == 4242U);
+        }
+        {
+            const std::vector<std::uint32_t> values{ std::begin(trie_), std::end(trie_) };
+            const std::vector<std::uint32_t> expected{ 42, 4242, 24 };
+            BOOST_CHECK(values == expected);
+
+            const auto iterator = std::begin(trie_);
+            BOOST_TEST(in_view(&*iterator));
+        }
+    }
+    {
+        const tetengo::trie::trie<std::string_view, std::uint32_t> built{ { "Kumamoto", 42 }, { "Tamana", 24 } };
+        const auto&                                                built_storage = built.get_storage();
+
+        tetengo::trie::memory_storage partial_storage{};
+        for (auto i = static_cast<std::size_t>(0); i < built_storage.base_check_size(); ++i)
+        {
+            partial_storage.set_base_at(i, built_storage.base_at(i));
+            partial_storage.set_check_at(i, built_storage.check_at(i));
+        }
+        partial_storage.add_value_at(1, *built_storage.value_at(1));
+
+        auto p_storage = std::make_unique<tetengo::trie::typed_memory_storage<std::uint32_t>>(partial_storage);
+        const tetengo::trie::trie<std::string_view, std::uint32_t> trie_{ std::move(p_storage) };
+
+        BOOST_TEST(!trie_.find("Kumamoto"));
+        BOOST_REQUIRE(trie_.find("Tamana"));
+        BOOST_TEST(*trie_.find("Tamana") == 24U);
+
+        const auto found = trie_.find_batch({ "Kumamoto", "Tamana" });
+        BOOST_TEST_REQUIRE(std::size(found) == 2U);
+        BOOST_TEST(!found[0]);
+        BOOST_REQUIRE(found[1]);
+        BOOST_TEST(*found[1] == 24U);
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
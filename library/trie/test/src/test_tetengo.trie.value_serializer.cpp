@@ -84,6 +84,32 @@ BOOST_AUTO_TEST_CASE(fixed_value_size)
     }
 }
 
+BOOST_AUTO_TEST_CASE(indexed)
+{
+    BOOST_TEST_PASSPOINT();
+
+    {
+        const tetengo::trie::value_serializer serializer{ [](const std::any&) { return std::vector<char>{ 3, 1, 4 }; },
+                                                          0 };
+
+        BOOST_TEST(!serializer.indexed());
+    }
+    {
+        const tetengo::trie::value_serializer serializer{ [](const std::any&) { return std::vector<char>{ 3, 1, 4 }; },
+                                                          0,
+                                                          true };
+
+        BOOST_TEST(serializer.indexed());
+    }
+    {
+        const tetengo::trie::value_serializer serializer{ [](const std::any&) { return std::vector<char>{ 3, 1, 4 }; },
+                                                          3,
+                                                          true };
+
+        BOOST_TEST(!serializer.indexed());
+    }
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE(value_deserializer)
@@ -22,6 +22,7 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits> // IWYU pragma: keep
 #include <unordered_map>
 #include <utility>
@@ -40,10 +41,6 @@
 
 namespace
 {
-    constexpr auto value_capacity = static_cast<std::size_t>(4);
-
-    constexpr auto serialized_value_size = sizeof(std::uint32_t) * (1 + 4 * 2);
-
     std::string encode_for_print(const std::string_view& string_)
     {
         const char* const locale_name = std::setlocale(LC_CTYPE, nullptr);
@@ -110,14 +107,7 @@ namespace
         {
             return;
         }
-        if (std::size(i_value->second) < value_capacity)
-        {
-            i_value->second.emplace_back(offset, length);
-        }
-        else
-        {
-            i_value->second.emplace_back(0, 0);
-        }
+        i_value->second.emplace_back(offset, length);
     }
 
     constexpr char operator""_c(const unsigned long long int uc)
@@ -212,7 +202,10 @@ namespace
                 std::make_move_iterator(std::end(word_offset_vector)),
                 tetengo::trie::default_serializer<std::string_view>{ true },
                 tetengo::trie::trie<std::string_view, std::vector<std::pair<std::size_t, std::size_t>>>::
-                    building_observer_set_type{ trie_building_observer{}, []() {} });
+                    building_observer_set_type{ trie_building_observer{}, []() {} },
+                tetengo::trie::trie<std::string_view, std::vector<std::pair<std::size_t, std::size_t>>>::
+                    default_double_array_density_factor(),
+                std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
         std::cerr << "Done.        " << std::endl;
         return p_trie;
     }
@@ -247,24 +240,14 @@ namespace
     std::vector<char> serialize_vector_of_pair_of_size_t(const std::vector<std::pair<std::size_t, std::size_t>>& vps)
     {
         std::vector<char> serialized{};
-        serialized.reserve(serialized_value_size);
+        serialized.reserve(sizeof(std::uint32_t) * (1 + std::size(vps) * 2));
 
         const auto serialized_size = serialize_size_t(std::size(vps));
         serialized.insert(std::end(serialized), std::begin(serialized_size), std::end(serialized_size));
-        for (auto i = static_cast<std::size_t>(0); i < value_capacity; ++i)
+        for (const auto& ps: vps)
         {
-            if (i < std::size(vps))
-            {
-                const auto& ps = vps[i];
-                const auto  serialized_element = serialize_pair_of_size_t(ps);
-                serialized.insert(std::end(serialized), std::begin(serialized_element), std::end(serialized_element));
-            }
-            else
-            {
-                const auto serialized_element =
-                    serialize_pair_of_size_t(std::make_pair<std::size_t, std::size_t>(0, 0));
-                serialized.insert(std::end(serialized), std::begin(serialized_element), std::end(serialized_element));
-            }
+            const auto serialized_element = serialize_pair_of_size_t(ps);
+            serialized.insert(std::end(serialized), std::begin(serialized_element), std::end(serialized_element));
         }
 
         return serialized;
@@ -287,8 +270,8 @@ namespace
         {
             throw std::ios_base::failure{ "Can't open the output file." };
         }
-        const tetengo::trie::value_serializer serializer{ serialize_value, serialized_value_size };
-        trie_.get_storage().serialize(output_stream, serializer);
+        const tetengo::trie::value_serializer serializer{ serialize_value, 0 };
+        trie_.get_storage().serialize_v2(output_stream, serializer);
         std::cerr << "Done.        " << std::endl;
     }
 
@@ -32,8 +32,6 @@
 
 namespace
 {
-    constexpr auto value_capacity = static_cast<std::size_t>(4);
-
     std::string decode_from_input(const std::string_view& encoded)
     {
         const char* const locale_name = std::setlocale(LC_CTYPE, nullptr);
@@ -110,12 +108,13 @@ namespace
         std::vector<std::pair<std::size_t, std::size_t>> vps{};
 
         const auto size = deserialize_size_t(bytes, byte_offset);
+        const auto stored_size = (std::size(bytes) - byte_offset) / (sizeof(std::uint32_t) * 2);
         vps.reserve(size);
-        for (auto i = static_cast<std::size_t>(0); i < std::min(size, value_capacity); ++i)
+        for (auto i = static_cast<std::size_t>(0); i < std::min(size, stored_size); ++i)
         {
             vps.push_back(deserialize_pair_of_size_t(bytes, byte_offset));
         }
-        for (auto i = value_capacity; i < size; ++i)
+        for (auto i = stored_size; i < size; ++i)
         {
             vps.emplace_back(0, 0);
         }
@@ -16,8 +16,6 @@
 #include <tetengo/trie/trie.h>
 
 
-static size_t value_capacity = 4;
-
 static const char* load_lex_csv(const char* const lex_csv_path)
 {
     char* lex_csv = NULL;
@@ -150,7 +148,8 @@ static void to_array_of_lex_span(
     const char* const p_bytes,
     size_t* const     p_byte_offset,
     lex_span_t* const p_lex_spans,
-    const size_t      lex_span_count)
+    const size_t      lex_span_count,
+    const size_t      stored_lex_span_count)
 {
     assert(p_bytes);
     assert(p_byte_offset);
@@ -162,7 +161,7 @@ static void to_array_of_lex_span(
 
     for (size_t i = 0; i < lex_span_count; ++i)
     {
-        if (i < value_capacity)
+        if (i < stored_lex_span_count)
         {
             to_lex_span(p_bytes, p_byte_offset, &p_lex_spans[i]);
         }
@@ -262,16 +261,17 @@ int main(const int argc, char** const argv)
             }
 
             const char* const decoded = create_decoded_from_input(key);
-            const void* const p_found = tetengo_trie_trie_find(p_trie, decoded);
+            size_t            found_size = 0;
+            const char* const p_found = tetengo_trie_trie_findSerialized(p_trie, decoded, &found_size);
             free((void*)decoded);
-            if (!p_found)
+            if (!p_found || found_size < 4)
             {
                 printf("ERROR: Not found.\n");
                 continue;
             }
 
             size_t       byte_offset = 0;
-            const size_t lex_span_count_ = lex_span_count((const char*)p_found, &byte_offset);
+            const size_t lex_span_count_ = lex_span_count(p_found, &byte_offset);
             if (lex_span_count_ == 0)
             {
                 continue;
@@ -282,7 +282,7 @@ int main(const int argc, char** const argv)
             {
                 continue;
             }
-            to_array_of_lex_span((const char*)p_found, &byte_offset, p_lex_spans, lex_span_count_);
+            to_array_of_lex_span(p_found, &byte_offset, p_lex_spans, lex_span_count_, (found_size - 4) / 8);
             for (size_t i = 0; i < lex_span_count_; ++i)
             {
                 if (p_lex_spans[i].offset == 0 && p_lex_spans[i].length == 0)